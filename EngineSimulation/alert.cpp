@@ -0,0 +1,107 @@
+﻿#include "alert.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+namespace {
+	// 目录只增不改：登记在互斥锁内完成，已发布的条目之后不再修改，读取无需加锁
+	struct AlertCatalog {
+		string messages[MAX_ALERT_IDS];
+		wstring wideMessages[MAX_ALERT_IDS];
+		atomic<size_t> count{ 1 }; // 0 号为空消息
+		mutex lock;
+	};
+
+	AlertCatalog& catalog() {
+		static AlertCatalog instance;
+		return instance;
+	}
+}
+
+AlertId internAlert(const string& message) {
+	if (message.empty()) return NO_ALERT;
+	AlertCatalog& c = catalog();
+	lock_guard<mutex> guard(c.lock);
+	size_t n = c.count.load(memory_order_relaxed);
+	for (size_t i = 1; i < n; ++i) {
+		if (c.messages[i] == message) return static_cast<AlertId>(i);
+	}
+	if (n >= MAX_ALERT_IDS) return NO_ALERT;
+	c.messages[n] = message;
+	c.wideMessages[n] = wstring(message.begin(), message.end());
+	c.count.store(n + 1, memory_order_release);
+	return static_cast<AlertId>(n);
+}
+
+const string& alertMessage(AlertId id) {
+	AlertCatalog& c = catalog();
+	return c.messages[id < c.count.load(memory_order_acquire) ? id : NO_ALERT];
+}
+
+const wstring& alertWideMessage(AlertId id) {
+	AlertCatalog& c = catalog();
+	return c.wideMessages[id < c.count.load(memory_order_acquire) ? id : NO_ALERT];
+}
+
+double AlertInfo::getCurrentTime() const {
+	if (clock) return clock->now();
+	static auto startTime = chrono::high_resolution_clock::now();
+	auto currentTime = chrono::high_resolution_clock::now();
+	return chrono::duration<double>(currentTime - startTime).count();
+}
+
+void AlertInfo::triggerAlert(AlertId id, COLORREF color) {
+	// 警报历史中已存在相同的警报，避免重复添加
+	if (id == NO_ALERT || id >= MAX_ALERT_IDS || inHistory.test(id)) return;
+
+	Alert newAlert = { id, color, getCurrentTime() };
+	alertHistory.push_front(newAlert);
+	inHistory.set(id);
+	if (alertHistory.size() > ALERT_HISTORY_MAX) {
+		inHistory.reset(alertHistory.back().id);
+		alertHistory.pop_back();
+	}
+	// 将新警报添加到待记录队列中
+	newAlertsForLogging.push_back(newAlert);
+}
+
+void AlertInfo::update() {
+	double now = getCurrentTime();
+	// 移除超过显示时间的旧警报
+	alertHistory.erase(
+		std::remove_if(alertHistory.begin(), alertHistory.end(),
+			[&](const Alert& a) {
+				if (now - a.timestamp <= 5.0) return false;
+				inHistory.reset(a.id);
+				return true;
+			}),
+		alertHistory.end()
+	);
+
+	if (!alertHistory.empty()) {
+		// 总是显示最新的警报
+		currentAlert = alertHistory.front();
+	}
+	else {
+		// 如果没有警报，则清空当前警报
+		currentAlert = { NO_ALERT, COLOR_BLACK, 0.0 };
+	}
+}
+
+deque<Alert> AlertInfo::getAndClearNewAlerts() {
+	deque<Alert> alerts_to_log;
+	// 使用move高效地移动队列内容，然后清空原队列
+	alerts_to_log = std::move(newAlertsForLogging);
+	newAlertsForLogging.clear();
+	return alerts_to_log;
+}
+
+size_t AlertInfo::copyHistory(Alert* out, size_t max) const {
+	size_t n = 0;
+	for (auto it = alertHistory.begin(); it != alertHistory.end() && n < max; ++it) {
+		out[n++] = *it;
+	}
+	return n;
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+#include <string>
+#include <deque>
+#include <bitset>
+#include <cstdint>
+#include "colors.h"
+#include "sim_clock.h"
+
+// 警报编号：消息文字在警报目录中登记一次，之后只传递编号；文字只在显示和写日志时取出
+typedef uint16_t AlertId;
+const size_t MAX_ALERT_IDS = 256;
+const AlertId NO_ALERT = 0; // 空消息，目录中固定占用 0 号
+
+// 登记一条消息并返回编号，相同文字返回同一编号；目录已满时返回 NO_ALERT。线程安全
+AlertId internAlert(const std::string& message);
+const std::string& alertMessage(AlertId id);
+const std::wstring& alertWideMessage(AlertId id); // 供界面绘制，登记时一并转换好
+
+struct Alert {
+    AlertId id;
+    COLORREF color;
+    double timestamp; // 触发时的时钟时间
+
+    const std::string& message() const { return alertMessage(id); }
+};
+
+const size_t ALERT_HISTORY_MAX = 10; // 警报历史最多保留的条数
+
+// 警报管理，不依赖图形库
+// 警报 5 秒后过期，按 setClock 注入的时钟计时；未注入时使用墙钟
+class AlertInfo {
+public:
+	AlertInfo() : currentAlert({ NO_ALERT, COLOR_BLACK, 0.0}) {}
+
+	void setClock(const SimClock* simClock) { clock = simClock; }
+
+    void triggerAlert(AlertId id, COLORREF color); // 已在历史中的警报直接返回，不做字符串比较
+    void update();
+	const Alert& getCurrentAlert() const { return currentAlert; } // const版本
+	Alert& getCurrentAlert() { return currentAlert; } // 非const版本
+	// 把警报历史（最新的在前）复制到 out，最多 max 条，返回条数；供仿真线程发布给界面
+	size_t copyHistory(Alert* out, size_t max) const;
+    std::deque<Alert> getAndClearNewAlerts();
+
+private:
+    Alert currentAlert;
+    std::deque<Alert> alertHistory;
+    std::bitset<MAX_ALERT_IDS> inHistory; // 与 alertHistory 同步，按编号去重
+    const SimClock* clock = nullptr;
+    double getCurrentTime() const;
+    std::deque<Alert> newAlertsForLogging;
+}; 
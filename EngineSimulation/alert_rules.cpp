@@ -0,0 +1,169 @@
+﻿#include "alert_rules.h"
+#include "monitor.h"
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+enum AlertGroup { GROUP_FUEL_RES, GROUP_FUEL_FLOW, GROUP_EGT_START, GROUP_EGT_STABLE, GROUP_SPEED }; // 超速每台引擎一组：GROUP_SPEED + e
+
+// 顺序即判定顺序：同一指示灯先琥珀后红色时，后点亮的颜色生效
+vector<AlertRule> defaultAlertRules(const EngineLayout& layout) {
+	const int engines = layout.engines;
+	// 前一半引擎用左侧的指示灯，后一半用右侧的，双发即左右
+	auto rightHalf = [engines](int e) { return 2 * e >= engines; };
+	vector<AlertRule> rules;
+
+	for (int e = 0; e < engines; ++e) {
+		string name = layout.engineName(e);
+		int side = rightHalf(e) ? 2 : 0;
+		for (int s = 0; s < layout.sensors; ++s) {
+			IndicatorId lamp = (s < 2) ? IndicatorId(IND_N1_L_S1_FAIL + side + s) : IND_N1_SYS_FAIL;
+			rules.push_back({ lamp, "N1 SENSOR " + to_string(s + 1) + " " + name + " ANOMALY", COLOR_WHITE, AlertSignal::N1_ANOMAL, uint8_t(e), uint8_t(s), AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, false });
+		}
+		for (int s = 0; s < layout.sensors; ++s) {
+			IndicatorId lamp = (s < 2) ? IndicatorId(IND_EGT_L_S1_FAIL + side + s) : IND_EGT_SYS_FAIL;
+			rules.push_back({ lamp, "EGT SENSOR " + to_string(s + 1) + " " + name + " ANOMALY", COLOR_WHITE, AlertSignal::EGT_ANOMAL, uint8_t(e), uint8_t(s), AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, false });
+		}
+	}
+
+	string all = (engines == 2) ? "DUAL" : "ALL";
+	rules.push_back({ IND_N1_SYS_FAIL, "N1 SYSTEM FAULT", COLOR_AMBER, AlertSignal::N1_FAULT_ANY, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, false });
+	rules.push_back({ IND_EGT_SYS_FAIL, "EGT SYSTEM FAULT", COLOR_AMBER, AlertSignal::EGT_FAULT_ANY, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, false });
+	rules.push_back({ IND_N1_SYS_FAIL, all + " N1 SYSTEM FAILURE - SHUTDOWN", COLOR_RED, AlertSignal::N1_FAULT_ALL, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, true });
+	rules.push_back({ IND_EGT_SYS_FAIL, all + " EGT SYSTEM FAILURE - SHUTDOWN", COLOR_RED, AlertSignal::EGT_FAULT_ALL, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, NO_GROUP, true });
+
+	rules.push_back({ IND_FUEL_RES_FAIL, "FUEL RESERVE SENSOR INVALID", COLOR_RED, AlertSignal::FUEL_RES_INVALID, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, GROUP_FUEL_RES, false });
+	rules.push_back({ IND_LOW_FUEL, "FUEL DEPLETED - ENGINE SHUTDOWN", COLOR_RED, AlertSignal::FUEL_RES, 0, 0, AlertCompare::AT_MOST, 0.0, IN_RUNNING, GROUP_FUEL_RES, false });
+	rules.push_back({ IND_LOW_FUEL, "LOW FUEL RESERVE", COLOR_AMBER, AlertSignal::FUEL_RES, 0, 0, AlertCompare::BELOW, 1000.0, IN_RUNNING, GROUP_FUEL_RES, false });
+	rules.push_back({ IND_FUEL_FLOW_FAIL, "FUEL FLOW SENSOR INVALID", COLOR_AMBER, AlertSignal::FUEL_FLOW_INVALID, 0, 0, AlertCompare::IS_SET, 0.0, IN_ANY_STATE, GROUP_FUEL_FLOW, false });
+	rules.push_back({ IND_OVER_FF, "FUEL FLOW EXCEEDED LIMIT", COLOR_AMBER, AlertSignal::FUEL_FLOW, 0, 0, AlertCompare::ABOVE, FUEL_FLOW_MAX, IN_ANY_STATE, GROUP_FUEL_FLOW, false });
+
+	for (int e = 0; e < engines; ++e) {
+		string name = layout.engineName(e);
+		IndicatorId lamp = rightHalf(e) ? IND_OVERSPEED_R : IND_OVERSPEED_L;
+		rules.push_back({ lamp, "N1 " + name + " OVERSPEED - SHUTDOWN", COLOR_RED, AlertSignal::N1_PCT, uint8_t(e), 0, AlertCompare::ABOVE, 120.0, IN_ANY_STATE, GROUP_SPEED + e, true });
+		rules.push_back({ lamp, "N1 " + name + " OVERSPEED CAUTION", COLOR_AMBER, AlertSignal::N1_PCT, uint8_t(e), 0, AlertCompare::ABOVE, 105.0, IN_ANY_STATE, GROUP_SPEED + e, false });
+	}
+
+	rules.push_back({ IND_OVERTEMP2, "EGT STARTING OVERTEMP - SHUTDOWN", COLOR_RED, AlertSignal::EGT_HIGHEST, 0, 0, AlertCompare::ABOVE, 1000.0, IN_STARTING, GROUP_EGT_START, true });
+	rules.push_back({ IND_OVERTEMP1, "EGT STARTING OVERTEMP CAUTION", COLOR_AMBER, AlertSignal::EGT_HIGHEST, 0, 0, AlertCompare::ABOVE, 850.0, IN_STARTING, GROUP_EGT_START, false });
+	rules.push_back({ IND_OVERTEMP4, "EGT STABLE OVERTEMP - SHUTDOWN", COLOR_RED, AlertSignal::EGT_HIGHEST, 0, 0, AlertCompare::ABOVE, 1100.0, IN_STABLE, GROUP_EGT_STABLE, true });
+	rules.push_back({ IND_OVERTEMP3, "EGT STABLE OVERTEMP CAUTION", COLOR_AMBER, AlertSignal::EGT_HIGHEST, 0, 0, AlertCompare::ABOVE, 950.0, IN_STABLE, GROUP_EGT_STABLE, false });
+	return rules;
+}
+
+int AlertProgram::signalSlot(const EngineLayout& layout, AlertSignal signal, int engine, int sensor) {
+	int perChannel = layout.engines * layout.sensors;
+	int global = 2 * perChannel; // N1_FAULT_ANY 的位置，其后依次为 AlertSignal 中的全局信号
+	bool perSensor = (signal == AlertSignal::N1_ANOMAL || signal == AlertSignal::EGT_ANOMAL);
+	bool perEngine = perSensor || signal == AlertSignal::N1_PCT || signal == AlertSignal::N1_DISAGREE || signal == AlertSignal::EGT_DISAGREE;
+	if (perEngine && (engine < 0 || engine >= layout.engines)) return -1;
+	if (perSensor && (sensor < 0 || sensor >= layout.sensors)) return -1;
+	switch (signal) {
+	case AlertSignal::N1_ANOMAL:   return engine * layout.sensors + sensor;
+	case AlertSignal::EGT_ANOMAL:  return perChannel + engine * layout.sensors + sensor;
+	case AlertSignal::N1_PCT:      return global + 8 + engine;
+	case AlertSignal::EGT_HIGHEST: return global + 8 + layout.engines;
+	case AlertSignal::N1_DISAGREE: return global + 9 + layout.engines + engine;
+	case AlertSignal::EGT_DISAGREE: return global + 9 + 2 * layout.engines + engine;
+	case AlertSignal::COUNT:       return -1;
+	default:                       return global + (static_cast<int>(signal) - static_cast<int>(AlertSignal::N1_FAULT_ANY));
+	}
+}
+
+AlertProgram::AlertProgram(const vector<AlertRule>& rules, const EngineLayout& layout) : engineLayout(layout) {
+	size_t count = min(rules.size(), MAX_ALERT_RULES);
+	ops.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		const AlertRule& rule = rules[i];
+		Op op;
+		int slot = signalSlot(layout, rule.signal, rule.engine, rule.sensor);
+		op.slot = static_cast<uint8_t>(max(slot, 0));
+		op.compare = rule.compare;
+		op.states = (slot < 0) ? 0 : rule.states; // 下标越界的规则在任何状态都不生效
+		op.shutdown = rule.shutdown;
+		op.threshold = rule.threshold;
+		op.groupMask = 0;
+		if (rule.group != NO_GROUP) {
+			for (size_t j = 0; j < count; ++j) {
+				if (rules[j].group == rule.group) op.groupMask |= uint64_t(1) << j;
+			}
+		}
+		op.indicator = rule.indicator;
+		op.alert = internAlert(rule.message);
+		op.color = rule.color;
+		ops.push_back(op);
+	}
+}
+
+template <class Config>
+AlertResult AlertProgram::evaluate(const BasicEngineSnapshot<Config>& r) const {
+	const int E = Config::ENGINES, S = Config::SENSORS;
+	if (engineLayout != EngineLayout::of<Config>()) return AlertResult();
+
+	// 先把读数展开成信号表（布局见 signalSlot），布尔信号记为 0/1，NaN 与任何阈值比较都不成立
+	double signal[2 * E * S + 3 * E + 9];
+	double* global = signal + 2 * E * S;
+	bool n1Any = false, n1All = true, egtAny = false, egtAll = true;
+	double egtHighest = r.egt[0];
+	for (int e = 0; e < E; ++e) {
+		for (int s = 0; s < S; ++s) {
+			signal[e * S + s] = r.n1Anomal[e][s];
+			signal[E * S + e * S + s] = r.egtAnomal[e][s];
+		}
+		bool n1Fault = r.n1SystemFault(e), egtFault = r.egtSystemFault(e);
+		n1Any = n1Any || n1Fault;
+		n1All = n1All && n1Fault;
+		egtAny = egtAny || egtFault;
+		egtAll = egtAll && egtFault;
+		global[8 + e] = r.n1Percentage(e);
+		global[9 + E + e] = r.n1Disagree[e];
+		global[9 + 2 * E + e] = r.egtDisagree[e];
+		if (e > 0) egtHighest = fmax(egtHighest, r.egt[e]);
+	}
+	global[0] = n1Any;
+	global[1] = n1All;
+	global[2] = egtAny;
+	global[3] = egtAll;
+	global[4] = r.fuelReserveInvalid;
+	global[5] = r.fuelReserve;
+	global[6] = r.fuelFlowInvalid;
+	global[7] = r.fuelFlow;
+	global[8 + E] = egtHighest;
+
+	AlertResult result;
+	uint8_t stateBit = static_cast<uint8_t>(1 << static_cast<int>(r.state));
+	for (size_t i = 0; i < ops.size(); ++i) {
+		const Op& op = ops[i];
+		if (!(op.states & stateBit) || (result.fired & op.groupMask)) continue;
+		double v = signal[op.slot];
+		bool hit = false;
+		switch (op.compare) {
+		case AlertCompare::IS_SET:  hit = (v != 0.0); break;
+		case AlertCompare::ABOVE:   hit = (v > op.threshold); break;
+		case AlertCompare::AT_MOST: hit = (v <= op.threshold); break;
+		case AlertCompare::BELOW:   hit = (v < op.threshold); break;
+		}
+		if (hit) {
+			result.fired |= uint64_t(1) << i;
+			result.shutdown |= op.shutdown;
+		}
+	}
+	return result;
+}
+
+template <class Config>
+const AlertProgram& defaultAlertProgram() {
+	static_assert(2 * Config::ENGINES * Config::SENSORS + 2 * Config::ENGINES + 13 <= int(MAX_ALERT_RULES), "default rules exceed MAX_ALERT_RULES");
+	static const AlertProgram program(defaultAlertRules(EngineLayout::of<Config>()), EngineLayout::of<Config>());
+	return program;
+}
+
+const AlertProgram& defaultAlertProgram() {
+	return defaultAlertProgram<TwinConfig>();
+}
+
+#define INSTANTIATE_ALERT_PROGRAM(C) \
+	template AlertResult AlertProgram::evaluate<C>(const BasicEngineSnapshot<C>&) const; \
+	template const AlertProgram& defaultAlertProgram<C>();
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_ALERT_PROGRAM)
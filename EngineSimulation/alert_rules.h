@@ -0,0 +1,110 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "colors.h"
+#include "engine.h"
+#include "indicators.h"
+#include "alert.h"
+
+// 规则可以引用的输入信号，每步从读数计算一次；带引擎/传感器下标的信号由规则的 engine、sensor 字段选择
+enum class AlertSignal : uint8_t {
+    N1_ANOMAL, EGT_ANOMAL,           // 某台引擎某个传感器异常
+    N1_FAULT_ANY, N1_FAULT_ALL,      // 任一/全部引擎 N1 所有传感器都异常
+    EGT_FAULT_ANY, EGT_FAULT_ALL,
+    FUEL_RES_INVALID, FUEL_RES,
+    FUEL_FLOW_INVALID, FUEL_FLOW,
+    N1_PCT,                          // 某台引擎 N1 显示值百分比
+    EGT_HIGHEST,                     // 各引擎 EGT 显示值的最大者（忽略 NaN）
+    N1_DISAGREE, EGT_DISAGREE,       // 某台引擎的有效传感器读数不一致（见 vote.h），默认规则表不使用
+    COUNT
+};
+
+enum class AlertCompare : uint8_t {
+    IS_SET,   // 信号为真
+    ABOVE,    // 信号 > 阈值
+    AT_MOST,  // 信号 <= 阈值
+    BELOW     // 信号 < 阈值
+};
+
+// 允许规则生效的发动机状态
+const uint8_t IN_OFF = 1 << static_cast<int>(EngineState::OFF);
+const uint8_t IN_STARTING = 1 << static_cast<int>(EngineState::STARTING);
+const uint8_t IN_STABLE = 1 << static_cast<int>(EngineState::STABLE);
+const uint8_t IN_STOPPING = 1 << static_cast<int>(EngineState::STOPPING);
+const uint8_t IN_ANY_STATE = IN_OFF | IN_STARTING | IN_STABLE | IN_STOPPING;
+const uint8_t IN_RUNNING = IN_STARTING | IN_STABLE | IN_STOPPING;
+
+const int NO_GROUP = -1;
+
+// 一条告警规则；同一 group 中按顺序只取第一条命中的规则（相当于 else if）
+struct AlertRule {
+    IndicatorId indicator;
+    std::string message;
+    COLORREF color;
+    AlertSignal signal;
+    uint8_t engine;        // N1_ANOMAL、EGT_ANOMAL、N1_PCT、*_DISAGREE 使用，其余信号为 0
+    uint8_t sensor;        // N1_ANOMAL、EGT_ANOMAL 使用
+    AlertCompare compare;
+    double threshold;
+    uint8_t states;
+    int group;
+    bool shutdown;         // 命中时请求停机
+};
+
+// 默认规则表，按配置生成：各传感器异常、系统故障、燃油、各引擎超速 105/120%、EGT 启动 850/1000、稳定 950/1100
+// 双发时与原来写死的规则表逐条相同（顺序、文字、指示灯）；其他配置的传感器异常和超速按引擎前后半点亮左/右的指示灯，
+// 界面上没有位置的第 3 个及以后的传感器点亮系统故障灯
+std::vector<AlertRule> defaultAlertRules(const EngineLayout& layout);
+
+const size_t MAX_ALERT_RULES = 64; // 命中结果用 64 位掩码表示
+
+struct AlertResult {
+    uint64_t fired = 0;     // 第 i 位表示第 i 条规则命中
+    bool shutdown = false;
+};
+
+// 规则表编译成的扁平指令序列，只读，可以在多个线程中共用
+class AlertProgram {
+public:
+    // 超过 MAX_ALERT_RULES 的规则被忽略；引擎/传感器下标超出 layout 的规则永不命中
+    AlertProgram(const std::vector<AlertRule>& rules, const EngineLayout& layout = TWIN_LAYOUT);
+
+    // Config 须与构造时的 layout 一致，否则不命中任何规则；实现在 alert_rules.cpp，按 FOR_EACH_ENGINE_CONFIG 显式实例化
+    template <class Config>
+    AlertResult evaluate(const BasicEngineSnapshot<Config>& readings) const;
+
+    const EngineLayout& layout() const { return engineLayout; }
+
+    size_t size() const { return ops.size(); }
+    IndicatorId indicator(size_t i) const { return ops[i].indicator; }
+    AlertId alert(size_t i) const { return ops[i].alert; } // 构造时登记到警报目录
+    const std::string& message(size_t i) const { return alertMessage(ops[i].alert); }
+    COLORREF color(size_t i) const { return ops[i].color; }
+    bool shutdown(size_t i) const { return ops[i].shutdown; }
+
+private:
+    struct Op {
+        uint8_t slot;       // 在展开后的信号表中的位置，见 signalSlot
+        AlertCompare compare;
+        uint8_t states;
+        bool shutdown;
+        double threshold;
+        uint64_t groupMask; // 同组所有规则的位，组内已有命中时跳过；独立规则为 0
+        IndicatorId indicator;
+        AlertId alert;
+        COLORREF color;
+    };
+    // 信号表布局：N1 异常 [引擎][传感器]、EGT 异常 [引擎][传感器]、8 个全局信号、N1 百分比 [引擎]、EGT 最大值、
+    // N1 不一致 [引擎]、EGT 不一致 [引擎]；下标越界时返回 -1
+    static int signalSlot(const EngineLayout& layout, AlertSignal signal, int engine, int sensor);
+
+    EngineLayout engineLayout;
+    std::vector<Op> ops;
+};
+
+// 默认规则表编译后的程序：不带参数为双发，其他配置用 defaultAlertProgram<Config>()
+const AlertProgram& defaultAlertProgram();
+template <class Config>
+const AlertProgram& defaultAlertProgram();
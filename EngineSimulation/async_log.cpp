@@ -0,0 +1,128 @@
+﻿#include "async_log.h"
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+static const size_t LINE_BUFFER_SIZE = 256 * 1024;
+
+AsyncLogger::AsyncLogger(size_t capacity, bool blockWhenFull)
+	: samples(capacity), alerts(256), blockWhenFull(blockWhenFull), lineBuffer(LINE_BUFFER_SIZE) {}
+
+AsyncLogger::~AsyncLogger() {
+	close();
+}
+
+bool AsyncLogger::open(const string& dataPath, const string& alertPath,
+	const string& telemetryPath, const string& compressedPath) {
+	close();
+	if (!dataPath.empty()) {
+		dataFile.open(dataPath);
+		if (!dataFile.is_open()) return false;
+		logDataHeader(dataFile);
+	}
+	lineBytes = 0;
+	if (!compressedPath.empty() && !compressed.open(compressedPath)) {
+		if (dataFile.is_open()) dataFile.close();
+		return false;
+	}
+	if (!telemetryPath.empty() && !telemetry.open(telemetryPath)) {
+		if (dataFile.is_open()) dataFile.close();
+		compressed.close();
+		return false;
+	}
+	if (!alertPath.empty()) {
+		alertFile.open(alertPath, ios::app);
+	}
+	writtenSamples = 0;
+	droppedSamples = 0;
+	highWaterMark = 0;
+	running = true;
+	writer = thread(&AsyncLogger::writerLoop, this);
+	return true;
+}
+
+void AsyncLogger::close() {
+	if (!running.exchange(false)) return;
+	if (writer.joinable()) writer.join();
+	drain(); // 写线程退出后可能还有最后几条
+	flushLines();
+	if (dataFile.is_open()) dataFile.close();
+	if (alertFile.is_open()) alertFile.close();
+	telemetry.close();
+	compressed.close();
+}
+
+void AsyncLogger::pushSample(const LogSample& sample) {
+	if (!running.load(memory_order_relaxed)) return;
+	while (!samples.tryPush(sample)) {
+		if (!blockWhenFull) {
+			droppedSamples.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+		this_thread::yield();
+	}
+	// 只有生产者写高水位，读-比较-写不需要 CAS
+	size_t used = samples.size();
+	if (used > highWaterMark.load(memory_order_relaxed)) {
+		highWaterMark.store(used, memory_order_relaxed);
+	}
+}
+
+void AsyncLogger::pushAlert(time_t wallTime, const string& message) {
+	if (!running.load(memory_order_relaxed)) return;
+	AlertRecord record;
+	record.wallTime = wallTime;
+	size_t n = min(message.size(), sizeof(record.message) - 1);
+	memcpy(record.message, message.data(), n);
+	record.message[n] = '\0';
+	alerts.tryPush(record); // 警报很少，队列满时直接丢弃
+}
+
+bool AsyncLogger::drain() {
+	bool wrote = false;
+	LogSample sample;
+	while (samples.tryPop(sample)) {
+		if (dataFile.is_open()) {
+			if (lineBuffer.size() - lineBytes < LOG_LINE_MAX) flushLines();
+			lineBytes += formatSample(lineBuffer.data() + lineBytes, sample);
+		}
+		telemetry.append(sample);
+		compressed.append(sample);
+		writtenSamples.fetch_add(1, memory_order_relaxed);
+		wrote = true;
+	}
+	AlertRecord record;
+	while (alerts.tryPop(record)) {
+		if (alertFile.is_open()) writeAlertLine(alertFile, record.wallTime, record.message);
+		wrote = true;
+	}
+	return wrote;
+}
+
+void AsyncLogger::flushLines() {
+	if (lineBytes == 0) return;
+	dataFile.write(lineBuffer.data(), lineBytes);
+	lineBytes = 0;
+}
+
+void AsyncLogger::writerLoop() {
+	auto lastFlush = chrono::steady_clock::now();
+	bool dirty = false;
+	while (running.load()) {
+		if (drain()) {
+			dirty = true;
+			continue;
+		}
+		// 队列空闲时按固定间隔把缓冲写入磁盘，再短暂休眠
+		auto now = chrono::steady_clock::now();
+		if (dirty && now - lastFlush >= chrono::milliseconds(500)) {
+			flushLines();
+			dataFile.flush();
+			if (alertFile.is_open()) alertFile.flush();
+			lastFlush = now;
+			dirty = false;
+		}
+		this_thread::sleep_for(chrono::milliseconds(2));
+	}
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+#include <fstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include <vector>
+#include "log.h"
+#include "spsc_ring.h"
+#include "telemetry.h"
+#include "log_codec.h"
+
+// 警报日志的定长记录，消息超长时截断
+struct AlertRecord {
+    std::time_t wallTime;
+    char message[96];
+};
+
+// 异步日志：仿真线程把定长记录放入无锁环形队列，写线程负责格式化和写盘
+// 磁盘卡顿只会让队列变长或丢样本，不会阻塞仿真步
+class AsyncLogger {
+public:
+    // blockWhenFull 为 true 时队列满则等待写线程（无界面批量运行，不允许丢数据）
+    explicit AsyncLogger(size_t capacity = 8192, bool blockWhenFull = false);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // 打开数据文件（写表头）和警报文件（追加），alertPath 为空时不记录警报
+    // telemetryPath 非空时同时写一份二进制列式遥测文件，compressedPath 非空时同时写压缩日志
+    // dataPath 为空时不写 CSV；三者都为空时只消费队列（仍统计写入/丢弃数）；数据、遥测或压缩文件打不开时返回 false
+    bool open(const std::string& dataPath, const std::string& alertPath,
+              const std::string& telemetryPath = "", const std::string& compressedPath = "");
+    // 写完队列中剩余的记录后关闭文件
+    void close();
+    bool isOpen() const { return running.load(); }
+
+    void pushSample(const LogSample& sample);
+    void pushAlert(std::time_t wallTime, const std::string& message);
+
+    // 统计：写出的样本数、因队列满丢弃的样本数、队列最高占用
+    uint64_t getWrittenSamples() const { return writtenSamples.load(); }
+    uint64_t getDroppedSamples() const { return droppedSamples.load(); }
+    size_t getHighWaterMark() const { return highWaterMark.load(); }
+    size_t getCapacity() const { return samples.capacity(); }
+    // 压缩日志的统计（CSV 等价字节数/压缩后字节数），close 之后读取
+    const CompressedLogWriter& getCompressedLog() const { return compressed; }
+
+private:
+    void writerLoop();
+    bool drain(); // 写出队列中的所有记录，有记录写出时返回 true
+    void flushLines(); // 把行缓冲整块写入数据文件
+
+    SpscRing<LogSample> samples;
+    SpscRing<AlertRecord> alerts;
+    bool blockWhenFull;
+
+    std::ofstream dataFile;
+    std::vector<char> lineBuffer; // 写线程的格式化缓冲，攒满后整块写入
+    size_t lineBytes = 0;
+    std::ofstream alertFile;
+    TelemetryWriter telemetry;
+    CompressedLogWriter compressed;
+    std::thread writer;
+    std::atomic<bool> running{ false };
+
+    std::atomic<uint64_t> writtenSamples{ 0 };
+    std::atomic<uint64_t> droppedSamples{ 0 };
+    std::atomic<size_t> highWaterMark{ 0 };
+};
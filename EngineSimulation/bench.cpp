@@ -0,0 +1,344 @@
+﻿// 仿真热路径微基准：逐项测量每次操作的耗时 (ns) 和堆分配次数，用于发布前发现性能回退
+// 每项先预热一轮，再重复测量取最快的一轮；分配次数统计所有测量轮
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "engine.h"
+#include "vote.h"
+#include "log.h"
+#include "alert.h"
+#include "alert_rules.h"
+#include "monitor.h"
+#include "sim_clock.h"
+using namespace std;
+
+// -----分配计数-----
+// 替换全局 operator new，只计数，不改变分配行为
+static atomic<uint64_t> allocationCount{ 0 };
+
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, memory_order_relaxed);
+	if (size == 0) size = 1;
+	if (void* p = malloc(size)) return p;
+	throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// 防止被测代码的结果被优化掉
+static volatile double sink;
+
+struct BenchOptions {
+	string filter;       // 只运行名称包含该子串的项
+	double scale = 1.0;  // 操作次数的倍数
+	int repeats = 5;
+	string csv;          // 非空时把结果写成 CSV，便于不同版本对比
+};
+
+struct BenchResult {
+	string name;
+	uint64_t ops;
+	double nsPerOp;
+	double allocsPerOp;
+};
+
+// body(ops) 执行 ops 次被测操作
+template <typename Body>
+static bool measure(const BenchOptions& opt, const char* name, uint64_t ops, Body body, vector<BenchResult>& results) {
+	if (!opt.filter.empty() && string(name).find(opt.filter) == string::npos) return false;
+	ops = max<uint64_t>(1, static_cast<uint64_t>(ops * opt.scale));
+	body(ops); // 预热
+
+	double best = 1e300;
+	uint64_t allocBefore = allocationCount.load(memory_order_relaxed);
+	for (int r = 0; r < opt.repeats; ++r) {
+		auto t0 = chrono::steady_clock::now();
+		body(ops);
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+		best = min(best, ns);
+	}
+	uint64_t allocs = allocationCount.load(memory_order_relaxed) - allocBefore;
+	BenchResult result{ name, ops, best / ops, static_cast<double>(allocs) / (static_cast<double>(ops) * opt.repeats) };
+	cout << "[Bench] " << left << setw(36) << name << right << fixed << setprecision(1) << setw(10) << result.nsPerOp
+		<< " ns/op" << setprecision(3) << setw(10) << result.allocsPerOp << " allocs/op\n";
+	results.push_back(result);
+	return true;
+}
+
+// 可以访问 Engine 私有成员的基准（engine.h 中声明为友元）
+class EngineBench {
+public:
+	static void updateSensor(Engine& engine, const uint32_t* noise) { engine.updateSensor(engine.engines[0], noise); }
+	static void voteDisplayValues(Engine& engine) { engine.voteDisplayValues(); }
+	static SingleEngine<Engine::SENSORS>& left(Engine& engine) { return engine.engines[0]; }
+};
+
+// 生成各状态起点的快照：启动瞬间、稳定运行、停机瞬间
+struct StateSnapshots {
+	vector<uint8_t> starting, stable, stopping;
+};
+
+static StateSnapshots makeSnapshots() {
+	StateSnapshots s;
+	Engine engine(20240601);
+	engine.setVerbose(false);
+	engine.start();
+	engine.saveSnapshot(s.starting);
+	while (engine.getState() != EngineState::STABLE) engine.advance(0.005);
+	for (int i = 0; i < 2000; ++i) engine.advance(0.005);
+	engine.saveSnapshot(s.stable);
+	engine.stop();
+	engine.saveSnapshot(s.stopping);
+	return s;
+}
+
+// 从快照开始推进，每 BATCH 步恢复一次，保证始终停留在同一状态（启动约 7 s、停机最长 8 s，每批 1 s）
+static void advanceInState(const vector<uint8_t>& snapshot, EngineState expected, uint64_t ops) {
+	const uint64_t BATCH = 200;
+	Engine engine(1);
+	engine.setVerbose(false);
+	for (uint64_t done = 0; done < ops; done += BATCH) {
+		engine.loadSnapshot(snapshot.data(), snapshot.size());
+		uint64_t n = min(BATCH, ops - done);
+		for (uint64_t i = 0; i < n; ++i) engine.advance(0.005);
+	}
+	if (engine.getState() != expected) {
+		cerr << "[Bench] Engine left the benchmarked state\n";
+		exit(1);
+	}
+	sink = engine.getN1Left();
+}
+
+static void printUsage(const char* prog) {
+	cout << "Usage: " << prog << " [--filter <text>] [--scale <x>] [--repeats <n>] [--csv <path>]\n";
+	cout << "       --filter   run only benchmarks whose name contains text\n";
+	cout << "       --scale    multiply the operation counts (default 1)\n";
+	cout << "       --repeats  measured repetitions per benchmark, fastest is reported (default 5)\n";
+	cout << "       --csv      also write Name,Ops,NsPerOp,AllocsPerOp to path\n";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& opt) {
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--help" || arg == "-h") return false;
+		if (i + 1 >= argc) {
+			cerr << "[Bench] Missing value for " << arg << "\n";
+			return false;
+		}
+		string value = argv[++i];
+		try {
+			if (arg == "--filter") opt.filter = value;
+			else if (arg == "--scale") opt.scale = stod(value);
+			else if (arg == "--repeats") opt.repeats = stoi(value);
+			else if (arg == "--csv") opt.csv = value;
+			else {
+				cerr << "[Bench] Unknown option: " << arg << "\n";
+				return false;
+			}
+		}
+		catch (...) {
+			cerr << "[Bench] Invalid value for " << arg << ": " << value << "\n";
+			return false;
+		}
+	}
+	if (opt.scale <= 0.0 || opt.repeats <= 0) {
+		cerr << "[Bench] Scale and repeats must be positive.\n";
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	BenchOptions opt;
+	if (!parseOptions(argc, argv, opt)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	vector<BenchResult> results;
+	StateSnapshots snapshots = makeSnapshots();
+
+	// -----发动机推进-----
+	measure(opt, "advance/STARTING", 200000, [&](uint64_t n) { advanceInState(snapshots.starting, EngineState::STARTING, n); }, results);
+	measure(opt, "advance/STABLE", 200000, [&](uint64_t n) { advanceInState(snapshots.stable, EngineState::STABLE, n); }, results);
+	measure(opt, "advance/STOPPING", 200000, [&](uint64_t n) { advanceInState(snapshots.stopping, EngineState::STOPPING, n); }, results);
+
+	// 启动/停车曲线查表，时间按界面步长在整条曲线上循环
+	const SpoolProfile& spool = SpoolProfile::builtin();
+	measure(opt, "SpoolProfile::start", 5000000, [&](uint64_t n) {
+		double sum = 0.0;
+		for (uint64_t i = 0; i < n; ++i) {
+			double n1, fuelFlow, egt;
+			spool.start((i % 2000) * 0.005, n1, fuelFlow, egt);
+			sum += n1 + fuelFlow + egt;
+		}
+		sink = sum;
+	}, results);
+	measure(opt, "SpoolProfile::stopFactor", 5000000, [&](uint64_t n) {
+		double sum = 0.0;
+		for (uint64_t i = 0; i < n; ++i) sum += spool.stopFactor((i % 1600) * 0.005);
+		sink = sum;
+	}, results);
+
+	Engine stable(1);
+	stable.setVerbose(false);
+	stable.loadSnapshot(snapshots.stable.data(), snapshots.stable.size());
+
+	// 预先生成噪声，只计传感器更新本身
+	vector<uint32_t> noise(4096 * 4);
+	PhiloxRng rng(7);
+	rng.fill(noise.data(), noise.size());
+	measure(opt, "updateSensor", 1000000, [&](uint64_t n) {
+		for (uint64_t i = 0; i < n; ++i) EngineBench::updateSensor(stable, noise.data() + (i & 4095) * 4);
+		sink = EngineBench::left(stable).n1Sensor[0];
+	}, results);
+	measure(opt, "updateSensor/overridden", 1000000, [&](uint64_t n) {
+		Engine engine = stable;
+		engine.setForcedN1Sensor(0, 0, 45000.0);
+		engine.setForcedEGTSensor(0, 1, 1150.0);
+		for (uint64_t i = 0; i < n; ++i) EngineBench::updateSensor(engine, noise.data() + (i & 4095) * 4);
+		sink = EngineBench::left(engine).n1Sensor[0];
+	}, results);
+
+	// -----显示值-----
+	// 表决核心，每次操作为一个通道：机队规模的一批通道，约 1/8 的读数为 NaN（异常）
+	{
+		const size_t lanes = 4096;
+		vector<double> columns[3];
+		PhiloxRng readings(11);
+		for (vector<double>& column : columns) {
+			column.resize(lanes);
+			for (double& v : column) {
+				uint32_t x = readings.next();
+				v = (x % 8 == 0) ? numeric_limits<double>::quiet_NaN() : 30000.0 + (x >> 8) % 1000;
+			}
+		}
+		const double* rows[3] = { columns[0].data(), columns[1].data(), columns[2].data() };
+		vector<double> voted(lanes);
+		vector<uint8_t> disagree(lanes);
+		measure(opt, "voteMidValue/2 sensors per lane", 50000000, [&](uint64_t n) {
+			for (uint64_t done = 0; done < n; done += lanes) {
+				voteMidValue<2>(rows, static_cast<size_t>(min<uint64_t>(lanes, n - done)), voted.data(), disagree.data());
+			}
+			sink = voted[0];
+		}, results);
+		measure(opt, "voteMidValue/3 sensors per lane", 50000000, [&](uint64_t n) {
+			for (uint64_t done = 0; done < n; done += lanes) {
+				voteMidValue<3>(rows, static_cast<size_t>(min<uint64_t>(lanes, n - done)), voted.data(), disagree.data());
+			}
+			sink = voted[0];
+		}, results);
+	}
+	measure(opt, "voteDisplayValues", 1000000, [&](uint64_t n) {
+		Engine engine = stable;
+		for (uint64_t i = 0; i < n; ++i) EngineBench::voteDisplayValues(engine);
+		sink = engine.getN1Left();
+	}, results);
+	measure(opt, "getters/all displayed values", 1000000, [&](uint64_t n) {
+		double sum = 0.0;
+		for (uint64_t i = 0; i < n; ++i) {
+			sum += stable.getN1Left() + stable.getN1Right() + stable.getEgtLeft() + stable.getEgtRight();
+			sum += stable.getN1LeftPercentage() + stable.getN1RightPercentage() + stable.getFuelFlow() + stable.getFuelReserve();
+		}
+		sink = sum;
+	}, results);
+	measure(opt, "readEngine", 1000000, [&](uint64_t n) {
+		double sum = 0.0;
+		for (uint64_t i = 0; i < n; ++i) sum += readEngine(stable).n1[0];
+		sink = sum;
+	}, results);
+
+	// -----数据日志-----
+	LogSample sample = captureSample(stable, stable.getSimTime());
+	measure(opt, "captureSample", 1000000, [&](uint64_t n) {
+		double sum = 0.0;
+		for (uint64_t i = 0; i < n; ++i) sum += captureSample(stable, static_cast<double>(i)).values[0];
+		sink = sum;
+	}, results);
+	measure(opt, "formatSample", 500000, [&](uint64_t n) {
+		char line[LOG_LINE_MAX];
+		size_t total = 0;
+		for (uint64_t i = 0; i < n; ++i) {
+			sample.timestamp = i * 0.005;
+			total += formatSample(line, sample);
+		}
+		sink = static_cast<double>(total);
+	}, results);
+	{
+		// logData 写入带缓冲的文件流，计入格式化和 ofstream 开销
+		const char* path = "engine_bench_data.tmp";
+		ofstream file(path);
+		measure(opt, "logData", 500000, [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i) logData(stable, file, i * 0.005);
+			file.seekp(0);
+		}, results);
+		file.close();
+		remove(path);
+	}
+
+	// -----警报-----
+	// 仿真时钟驱动过期；编号多于历史容量，覆盖新增、去重命中和挤出最旧的路径
+	SimClock clock;
+	const AlertProgram& program = defaultAlertProgram();
+	measure(opt, "triggerAlert/duplicate", 2000000, [&](uint64_t n) {
+		AlertInfo alerts;
+		alerts.setClock(&clock);
+		alerts.triggerAlert(program.alert(0), program.color(0));
+		for (uint64_t i = 0; i < n; ++i) alerts.triggerAlert(program.alert(0), program.color(0));
+		sink = static_cast<double>(alerts.getCurrentAlert().id);
+	}, results);
+	measure(opt, "triggerAlert+update/churn", 500000, [&](uint64_t n) {
+		AlertInfo alerts;
+		alerts.setClock(&clock);
+		size_t rules = program.size();
+		for (uint64_t i = 0; i < n; ++i) {
+			clock.set(i * 0.5); // 每 10 次触发过期一批
+			size_t r = static_cast<size_t>(i % rules);
+			alerts.triggerAlert(program.alert(r), program.color(r));
+			alerts.update();
+			if ((i & 63) == 0) alerts.getAndClearNewAlerts();
+		}
+		sink = static_cast<double>(alerts.getCurrentAlert().id);
+	}, results);
+
+	// -----告警判定（界面每步的规则判定和指示灯）-----
+	IndicatorSetter countLamp = [](IndicatorId id, COLORREF) { sink = id; };
+	measure(opt, "evaluateAlerts/nominal", 1000000, [&](uint64_t n) {
+		AlertInfo alerts;
+		alerts.setClock(&clock);
+		EngineSnapshot readings = readEngine(stable);
+		for (uint64_t i = 0; i < n; ++i) evaluateAlerts(readings, alerts, countLamp);
+	}, results);
+	{
+		Engine faulty = stable;
+		faulty.setForcedN1Sensor(0, 0, 47000.0);
+		faulty.setForcedEGTSensor(1, 0, 1150.0);
+		faulty.setForcedEGTSensor(1, 1, 1150.0);
+		faulty.setFuelFlowSensorInvalid(true);
+		faulty.advance(0.005);
+		EngineSnapshot readings = readEngine(faulty);
+		measure(opt, "evaluateAlerts/faults", 1000000, [&](uint64_t n) {
+			AlertInfo alerts;
+			alerts.setClock(&clock);
+			for (uint64_t i = 0; i < n; ++i) evaluateAlerts(readings, alerts, countLamp);
+		}, results);
+	}
+
+	if (!opt.csv.empty()) {
+		ofstream out(opt.csv);
+		if (!out.is_open()) {
+			cerr << "[Bench] Cannot open output file: " << opt.csv << "\n";
+			return 1;
+		}
+		out << "Name,Ops,NsPerOp,AllocsPerOp\n";
+		for (const BenchResult& r : results) out << r.name << "," << r.ops << "," << r.nsPerOp << "," << r.allocsPerOp << "\n";
+		cout << "[Bench] Results written to " << opt.csv << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,265 @@
+﻿// 蒙特卡洛故障注入批量运行：读取故障矩阵，在线程池上并行运行大量独立的仿真，汇总结果
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "engine.h"
+#include "event.h"
+#include "monitor.h"
+#include "scenario.h"
+#include "checkpoint.h"
+#include "thread_pool.h"
+using namespace std;
+
+// 故障矩阵格式见 scenario.h，例如
+//   dual_n1_left: 10 set N1_L1 fail; 20 set N1_L2 fail
+//   fuel_flow_high: 15 set FUEL_FLOW value 60
+// 每条指令在读入矩阵时解析一次，运行时直接执行
+struct CampaignOptions {
+	string matrix;
+	string output = "campaign_results.csv";
+	int runs = 100;          // 每个场景的运行次数
+	double duration = 120.0; // 每次运行的仿真时长（秒）
+	double step = 0.005;
+	double jitter = 0.0;     // 故障时间随机偏移范围 ±jitter 秒
+	uint64_t seed = 1;
+	unsigned threads = 0;
+	string snapshot;         // 非空时每次运行从该检查点恢复，不再经过启动过程
+	string spool;            // 非空时从曲线表读取启动/停车曲线，所有运行共用
+};
+
+// 单次运行的结果
+struct RunResult {
+	bool shutdown = false;
+	double shutdownTime = numeric_limits<double>::quiet_NaN();
+	double fuelRemaining = numeric_limits<double>::quiet_NaN();
+	set<string> alerts;
+};
+
+// splitmix64：依次混入基础种子、场景序号和运行序号，每一步都是双射，各组合的种子互不相关
+static uint64_t splitmix64(uint64_t x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// CSV 字段：含逗号、双引号或换行时整体加双引号，内部的双引号写两遍
+static string csvField(const string& text) {
+	if (text.find_first_of(",\"\r\n") == string::npos) return text;
+	string quoted = "\"";
+	for (char c : text) {
+		if (c == '"') quoted += '"';
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+static uint64_t runSeedFor(uint64_t seed, uint64_t scenario, uint64_t run) {
+	return splitmix64(splitmix64(splitmix64(seed) ^ scenario) ^ run);
+}
+
+// 运行一次：启动发动机（或从检查点恢复），按时间注入故障，每步做告警判定，直到时长结束或停机完成
+// 故障时间和停机时间都从运行开始（启动或恢复的时刻）算起
+static RunResult runOnce(const ScenarioCase& sc, const CampaignOptions& opt, const vector<uint8_t>& snapshot, const SpoolProfile& spool,
+	uint64_t runSeed) {
+	RunResult result;
+	Engine engine(runSeed);
+	engine.setVerbose(false);
+	engine.setSpoolProfile(spool);
+	if (!snapshot.empty()) {
+		engine.loadSnapshot(snapshot.data(), snapshot.size()); // 已在读入时校验
+		engine.reseed(runSeed);
+	}
+	AlertInfo alertInfo;
+	SimClock clock; // 警报过期按仿真时间计，与墙钟和线程数无关
+	alertInfo.setClock(&clock);
+	IndicatorSetter noIndicator = [](IndicatorId, COLORREF) {};
+
+	// 故障时间抖动使用独立的随机数流
+	vector<ScenarioEvent> commands = sc.events;
+	if (opt.jitter > 0.0) {
+		PhiloxRng jitterRng(runSeed, 2);
+		for (auto& c : commands) {
+			double u = jitterRng.next() / 4294967296.0;
+			c.time = max(0.0, c.time + (2.0 * u - 1.0) * opt.jitter);
+		}
+	}
+	ScenarioPlayer player(move(commands)); // 按时间排序
+
+	if (snapshot.empty()) engine.start();
+	const double t0 = engine.getSimTime();
+	long long totalSteps = static_cast<long long>(opt.duration / opt.step + 0.5);
+	for (long long i = 0; i < totalSteps; ++i) {
+		player.applyDue(engine, engine.getSimTime() - t0);
+
+		EngineState before = engine.getState();
+		engine.advance(opt.step);
+		clock.set(engine.getSimTime() - t0);
+		evaluateAlerts(engine, alertInfo, noIndicator);
+		for (const Alert& a : alertInfo.getAndClearNewAlerts()) {
+			result.alerts.insert(a.message());
+		}
+
+		EngineState after = engine.getState();
+		if (!result.shutdown && before != EngineState::STOPPING && after == EngineState::STOPPING) {
+			result.shutdown = true;
+			result.shutdownTime = engine.getSimTime() - t0;
+		}
+		if (after == EngineState::OFF) break;
+	}
+	result.fuelRemaining = engine.getFuelReserve();
+	return result;
+}
+
+static void printUsage(const char* prog) {
+	cout << "Usage: " << prog << " --matrix <file> [--runs <n>] [--duration <s>] [--step <s>]\n"
+		"       [--jitter <s>] [--seed <n>] [--threads <n>] [--snapshot <path>] [--spool <file>] [--output <path>]\n";
+	cout << "       fault matrix lines: <name>: <time> <command>; <time> <command> ...\n";
+	cout << "       e.g. dual_n1_left: 10 set N1_L1 fail; 20 set N1_L2 fail\n";
+	cout << "       --snapshot starts every run from an engine checkpoint (see EngineHeadless --snapshot-out)\n";
+	cout << "       --spool    start/stop spool profile table for all runs (see EngineHeadless --spool)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], CampaignOptions& opt) {
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--help" || arg == "-h") return false;
+		if (i + 1 >= argc) {
+			cerr << "[Campaign] Missing value for " << arg << "\n";
+			return false;
+		}
+		string value = argv[++i];
+		try {
+			if (arg == "--matrix") opt.matrix = value;
+			else if (arg == "--output") opt.output = value;
+			else if (arg == "--runs") opt.runs = stoi(value);
+			else if (arg == "--duration") opt.duration = stod(value);
+			else if (arg == "--step") opt.step = stod(value);
+			else if (arg == "--jitter") opt.jitter = stod(value);
+			else if (arg == "--seed") opt.seed = stoull(value);
+			else if (arg == "--snapshot") opt.snapshot = value;
+			else if (arg == "--spool") opt.spool = value;
+			else if (arg == "--threads") opt.threads = static_cast<unsigned>(stoul(value));
+			else {
+				cerr << "[Campaign] Unknown option: " << arg << "\n";
+				return false;
+			}
+		}
+		catch (...) {
+			cerr << "[Campaign] Invalid value for " << arg << ": " << value << "\n";
+			return false;
+		}
+	}
+	if (opt.matrix.empty()) {
+		cerr << "[Campaign] --matrix is required.\n";
+		return false;
+	}
+	if (opt.runs <= 0 || opt.duration <= 0.0 || opt.step <= 0.0) {
+		cerr << "[Campaign] Runs, duration and step must be positive.\n";
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	CampaignOptions opt;
+	if (!parseOptions(argc, argv, opt)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	vector<ScenarioCase> scenarios;
+	string error;
+	if (!loadScenarioMatrix(opt.matrix, scenarios, error)) {
+		cerr << "[Campaign] Fault matrix " << opt.matrix << ": " << error << "\n";
+		return 1;
+	}
+	if (scenarios.empty()) {
+		cerr << "[Campaign] Fault matrix has no scenarios.\n";
+		return 1;
+	}
+
+	vector<uint8_t> snapshot;
+	if (!opt.snapshot.empty()) {
+		if (!readCheckpointFile(opt.snapshot, snapshot, error)) {
+			cerr << "[Campaign] Checkpoint " << opt.snapshot << ": " << error << "\n";
+			return 1;
+		}
+	}
+
+	SpoolProfile spool;
+	if (!opt.spool.empty() && !SpoolProfile::load(opt.spool, spool, error)) {
+		cerr << "[Campaign] Spool profile " << opt.spool << ": " << error << "\n";
+		return 1;
+	}
+
+	// 每次运行写入自己的结果槽，运行之间不共享任何状态
+	vector<vector<RunResult>> results(scenarios.size(), vector<RunResult>(opt.runs));
+	auto wallStart = chrono::steady_clock::now();
+	{
+		WorkStealingPool pool(opt.threads);
+		cout << "[Campaign] " << scenarios.size() << " scenarios x " << opt.runs << " runs on " << pool.size() << " threads\n";
+		for (size_t s = 0; s < scenarios.size(); ++s) {
+			for (int r = 0; r < opt.runs; ++r) {
+				// 种子只由场景和运行序号决定，结果与线程数无关
+				uint64_t runSeed = runSeedFor(opt.seed, s, static_cast<uint64_t>(r));
+				pool.submit([&, s, r, runSeed] {
+					results[s][r] = runOnce(scenarios[s], opt, snapshot, spool, runSeed);
+				});
+			}
+		}
+		pool.wait();
+	}
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+	ofstream out(opt.output);
+	if (!out.is_open()) {
+		cerr << "[Campaign] Cannot open output file: " << opt.output << "\n";
+		return 1;
+	}
+	out << "Scenario,Runs,Shutdowns,ShutdownRate,ShutdownTimeMean,ShutdownTimeMin,ShutdownTimeMax,FuelRemainingMean,Alerts\n";
+	for (size_t s = 0; s < scenarios.size(); ++s) {
+		int shutdowns = 0;
+		double ttsSum = 0.0, ttsMin = numeric_limits<double>::infinity(), ttsMax = -numeric_limits<double>::infinity();
+		double fuelSum = 0.0;
+		int fuelCount = 0;
+		map<string, int> alertCounts;
+		for (const RunResult& r : results[s]) {
+			if (r.shutdown) {
+				++shutdowns;
+				ttsSum += r.shutdownTime;
+				ttsMin = min(ttsMin, r.shutdownTime);
+				ttsMax = max(ttsMax, r.shutdownTime);
+			}
+			if (!isnan(r.fuelRemaining)) {
+				fuelSum += r.fuelRemaining;
+				++fuelCount;
+			}
+			for (const string& a : r.alerts) alertCounts[a]++;
+		}
+
+		out << csvField(scenarios[s].name) << "," << opt.runs << "," << shutdowns << "," << static_cast<double>(shutdowns) / opt.runs << ",";
+		if (shutdowns > 0) out << ttsSum / shutdowns << "," << ttsMin << "," << ttsMax << ",";
+		else out << "NaN,NaN,NaN,";
+		if (fuelCount > 0) out << fuelSum / fuelCount << ",";
+		else out << "NaN,";
+		string alerts;
+		for (const auto& kv : alertCounts) {
+			if (!alerts.empty()) alerts += '|';
+			alerts += kv.first + "=" + to_string(kv.second);
+		}
+		out << csvField(alerts) << "\n";
+
+		cout << "[Campaign] " << scenarios[s].name << ": " << shutdowns << "/" << opt.runs << " shutdowns";
+		if (shutdowns > 0) cout << ", mean time " << ttsSum / shutdowns << " s";
+		cout << ", " << alertCounts.size() << " distinct alerts\n";
+	}
+	cout << "[Campaign] " << scenarios.size() * opt.runs << " runs in " << wall << " s, results written to " << opt.output << "\n";
+	return 0;
+}
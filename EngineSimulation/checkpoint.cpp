@@ -0,0 +1,43 @@
+﻿#include "checkpoint.h"
+#include <fstream>
+#include <iterator>
+using namespace std;
+
+bool writeCheckpoint(const string& path, const Engine& engine, string& error) {
+	vector<uint8_t> blob;
+	engine.saveSnapshot(blob);
+	ofstream out(path, ios::binary);
+	if (!out.is_open()) {
+		error = "cannot open file for writing";
+		return false;
+	}
+	out.write(reinterpret_cast<const char*>(blob.data()), static_cast<streamsize>(blob.size()));
+	if (!out) {
+		error = "write failed";
+		return false;
+	}
+	return true;
+}
+
+bool readCheckpointFile(const string& path, vector<uint8_t>& blob, string& error) {
+	ifstream in(path, ios::binary);
+	if (!in.is_open()) {
+		error = "cannot open file";
+		return false;
+	}
+	blob.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+
+	// 用一台临时发动机校验格式和版本，调用方之后可以直接 loadSnapshot
+	Engine probe(1);
+	if (!probe.loadSnapshot(blob.data(), blob.size())) {
+		error = "not an engine snapshot or unsupported version";
+		return false;
+	}
+	return true;
+}
+
+bool readCheckpoint(const string& path, Engine& engine, string& error) {
+	vector<uint8_t> blob;
+	if (!readCheckpointFile(path, blob, error)) return false;
+	return engine.loadSnapshot(blob.data(), blob.size());
+}
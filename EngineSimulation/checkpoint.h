@@ -0,0 +1,11 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "engine.h"
+
+// 发动机检查点文件：内容就是 Engine::saveSnapshot 生成的版本化二进制快照
+// 典型用法是把预热到 STABLE 的发动机存一次，之后的故障实验都从这里恢复，不再重复启动过程
+bool writeCheckpoint(const std::string& path, const Engine& engine, std::string& error);
+bool readCheckpointFile(const std::string& path, std::vector<uint8_t>& blob, std::string& error); // 只读入并校验，供多次恢复
+bool readCheckpoint(const std::string& path, Engine& engine, std::string& error);
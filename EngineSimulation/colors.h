@@ -0,0 +1,19 @@
+﻿#pragma once
+
+// 颜色值与 EasyX/Win32 的 COLORREF 布局一致 (0x00BBGGRR)
+// 无界面程序不包含 <Windows.h>，这里给出同类型的定义（重复 typedef 为同一类型是合法的）
+typedef unsigned long COLORREF;
+
+constexpr COLORREF makeColor(int r, int g, int b) {
+	return static_cast<COLORREF>(r) | (static_cast<COLORREF>(g) << 8) | (static_cast<COLORREF>(b) << 16);
+}
+
+const COLORREF COLOR_WHITE = makeColor(255, 255, 255);
+const COLORREF COLOR_BLACK = makeColor(0, 0, 0);
+const COLORREF COLOR_RED = makeColor(255, 0, 0);
+const COLORREF COLOR_AMBER = makeColor(255, 165, 0); // 琥珀色
+const COLORREF COLOR_YELLOW = makeColor(255, 255, 0);
+const COLORREF COLOR_GREEN = makeColor(0, 255, 0);
+const COLORREF COLOR_BLUE = makeColor(0, 0, 255);
+const COLORREF COLOR_LIGHT_GREY = makeColor(180, 180, 180);
+const COLORREF COLOR_GREY = makeColor(100, 100, 100);
@@ -0,0 +1,89 @@
+﻿#include "easyx_renderer.h"
+#include <vector>
+#include "ui.h"
+using namespace std;
+
+void EasyXRenderer::rectangle(int left, int top, int right, int bottom) {
+	::rectangle(left, top, right, bottom);
+	markDirty(left, top, right, bottom);
+}
+
+void EasyXRenderer::solidRectangle(int left, int top, int right, int bottom) {
+	::solidrectangle(left, top, right, bottom);
+	markDirty(left, top, right, bottom);
+}
+
+void EasyXRenderer::pie(int left, int top, int right, int bottom, double startAngle, double endAngle) {
+	::pie(left, top, right, bottom, startAngle, endAngle);
+	markDirty(left, top, right, bottom);
+}
+
+void EasyXRenderer::solidPie(int left, int top, int right, int bottom, double startAngle, double endAngle) {
+	::solidpie(left, top, right, bottom, startAngle, endAngle);
+	markDirty(left, top, right, bottom);
+}
+
+void EasyXRenderer::fillPolygon(const RenderPoint* points, int count) {
+	if (count <= 0) return;
+	vector<POINT> pts(count);
+	RenderRect box = { points[0].x, points[0].y, points[0].x, points[0].y };
+	for (int i = 0; i < count; ++i) {
+		pts[i] = { points[i].x, points[i].y };
+		box = unionRect(box, { points[i].x, points[i].y, points[i].x, points[i].y });
+	}
+	::fillpolygon(pts.data(), count);
+	markDirty(box.left, box.top, box.right, box.bottom);
+}
+
+void EasyXRenderer::outText(int x, int y, const wchar_t* text) {
+	setbkmode(TRANSPARENT);
+	outtextxy(x, y, text);
+	markDirty(x, y, x + textwidth(text), y + textheight(text));
+}
+
+void EasyXRenderer::clear() {
+	cleardevice();
+	markDirty(0, 0, width() - 1, height() - 1);
+}
+
+void EasyXRenderer::clearRect(const RenderRect& rect) {
+	clearrectangle(rect.left, rect.top, rect.right, rect.bottom);
+	markDirty(rect.left, rect.top, rect.right, rect.bottom);
+}
+
+void EasyXRenderer::present() {
+	// 没有变化时不刷新窗口，静止的表盘和边框不再每帧拷贝
+	const RenderRect& d = dirtyRect();
+	if (!d.empty()) FlushBatchDraw(d.left, d.top, d.right, d.bottom);
+	clearDirty();
+}
+
+void fixConsoleWindow() {
+	HWND consoleWindow = GetConsoleWindow();
+	HWND graphicsWindow = GetHWnd();
+
+	if (consoleWindow != NULL && graphicsWindow != NULL) {
+		RECT graphicsRect;
+		GetWindowRect(graphicsWindow, &graphicsRect);
+		int graphicsWidth = graphicsRect.right - graphicsRect.left;
+		int graphicsHeight = graphicsRect.bottom - graphicsRect.top;
+
+		int consoleWidth = 500;
+		int consoleHeight = graphicsHeight;
+
+		// 将控制台窗口放置在图形窗口的右侧，并设置其大小
+		SetWindowPos(consoleWindow, NULL, graphicsRect.left + graphicsWidth, graphicsRect.top, consoleWidth, consoleHeight, SWP_NOZORDER);
+	}
+}
+
+void initializeUI(const string& windowName, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr) {
+	initgraph(WINDOW_WIDTH, WINDOW_HEIGHT, EW_SHOWCONSOLE); 
+
+	HWND graphicsWindow = GetHWnd();
+	if (graphicsWindow != NULL) {
+		SetWindowPos(graphicsWindow, NULL, 10, 10, 0, 0, SWP_NOSIZE | SWP_NOZORDER);
+	}
+	setbkcolor(BLACK);
+	fixConsoleWindow();
+	cleardevice();
+}
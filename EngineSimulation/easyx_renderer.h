@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <string>
+#include <graphics.h>
+#include <Windows.h>
+#include "render.h"
+
+// EasyX 窗口后端：在批量绘制模式下画到后台缓冲，present 只把脏区域刷到窗口
+class EasyXRenderer : public Renderer {
+public:
+    int width() const override { return getwidth(); }
+    int height() const override { return getheight(); }
+
+    void setLineColor(COLORREF color) override { setlinecolor(color); }
+    void setFillColor(COLORREF color) override { setfillcolor(color); }
+    void setTextColor(COLORREF color) override { settextcolor(color); }
+    void setTextStyle(int height, const wchar_t* face) override { settextstyle(height, 0, face); }
+
+    void rectangle(int left, int top, int right, int bottom) override;
+    void solidRectangle(int left, int top, int right, int bottom) override;
+    void pie(int left, int top, int right, int bottom, double startAngle, double endAngle) override;
+    void solidPie(int left, int top, int right, int bottom, double startAngle, double endAngle) override;
+    void fillPolygon(const RenderPoint* points, int count) override;
+    void outText(int x, int y, const wchar_t* text) override;
+    int textWidth(const wchar_t* text) override { return textwidth(text); }
+    int textHeight(const wchar_t* text) override { return textheight(text); }
+
+    void clear() override;
+    void clearRect(const RenderRect& rect) override;
+    void present() override;
+};
+
+// 创建图形窗口（带控制台），需在 BeginBatchDraw 之前调用
+void initializeUI(const std::string& windowName, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr);
+void fixConsoleWindow();
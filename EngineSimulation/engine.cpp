@@ -1,14 +1,26 @@
 ﻿#include "engine.h"
+#include "vote.h"
 #include <iostream>
 #include <limits>
+#include <ctime>
+#include <cstring>
 using namespace std;
 
-Engine::Engine() {
-	srand(static_cast<unsigned int>(time(nullptr)));  // 根据当前时间的随机种子
+// 原 (rand() % n) / divisor - shift 的替代，x 为 32 位随机数
+static double noiseOffset(uint32_t x, uint32_t n, double divisor, double shift) {
+	return uniformInt(x, n) / divisor - shift;
+}
+
+template <class Config>
+EngineModel<Config>::EngineModel() : EngineModel(static_cast<uint64_t>(time(nullptr))) {}  // 根据当前时间的随机种子
+
+template <class Config>
+EngineModel<Config>::EngineModel(uint64_t seed) : noiseRng(seed, 0), thrustRng(seed, 1) {
 	resetParameters();
 }
 
-void Engine::resetParameters() {
+template <class Config>
+void EngineModel<Config>::resetParameters() {
 	// 重置引擎参数到初始状态
 	state = EngineState::OFF;
 	simElapsed = 0.0;
@@ -21,25 +33,29 @@ void Engine::resetParameters() {
 	fuelReserveSensorInvalid = false;
 	fuelFlowSensorInvalid = false;
 	fuelFlowOverridden = false;
-	leftEngine = SingleEngine(); // 用构造函数重置左引擎
-	rightEngine = SingleEngine(); // 用构造函数重置右引擎
+	engines.fill(Unit()); // 用构造函数重置各台引擎
+	voteDisplayValues();
+	refreshStatus();
 }
 
-void Engine::start() {
+template <class Config>
+void EngineModel<Config>::start() {
 	if (state == EngineState::OFF) {
 		resetParameters();
 		state = EngineState::STARTING;
-		cout << "[Engine] Starting sequence initiated." << endl;
+		refreshStatus();
+		if (verbose) cout << "[Engine] Starting sequence initiated." << endl;
 	}
 	else {
-		cout << "[Engine] Start command ignored. Engine is not OFF." << endl;
+		if (verbose) cout << "[Engine] Start command ignored. Engine is not OFF." << endl;
 		return;
 	}
 }
 
 // 解除传感器覆盖
-static void releaseCoolingOverride(SingleEngine& engine) {
-	for (int s = 0; s < 2; ++s) {
+template <int Sensors>
+static void releaseCoolingOverride(SingleEngine<Sensors>& engine) {
+	for (int s = 0; s < Sensors; ++s) {
 		// N1 覆盖释放条件：已覆盖 + 非强制异常 + 覆盖值在有效范围 (0 <= v <= 1.25 * 40000)
 		if (engine.n1SensorOverridden[s]) {
 			double value = engine.n1SensorOverrideVal[s];
@@ -60,42 +76,45 @@ static void releaseCoolingOverride(SingleEngine& engine) {
 	}
 }
 
-void Engine::stop() {
+template <class Config>
+void EngineModel<Config>::stop() {
 	if (state == EngineState::STOPPING || state == EngineState::OFF) {
-		cout << "[Engine] Stop command ignored. Engine is already stopping or off." << endl;
+		if (verbose) cout << "[Engine] Stop command ignored. Engine is already stopping or off." << endl;
 		return;
 	}
 
-	// 需要从显示值开始冷却
-	double n1_left = getN1Left();
-	double n1_right = getN1Right();
-	double egt_left = getEgtLeft();
-	double egt_right = getEgtRight();
-
-	// 如果不是NaN，则将基准值改为当前显示值，就可以实现从显示值开始冷却
-	if (!isnan(n1_left)) leftEngine.n1Base = n1_left;
-	if (!isnan(n1_right)) rightEngine.n1Base = n1_right;
-	if (!isnan(egt_left)) leftEngine.egtBase = egt_left;
-	if (!isnan(egt_right)) rightEngine.egtBase = egt_right;
-
-	releaseCoolingOverride(leftEngine);
-	releaseCoolingOverride(rightEngine);
+	for (int e = 0; e < ENGINES; ++e) {
+		// 需要从显示值开始冷却（快照在每步传感器更新后已表决）
+		// 如果不是NaN，则将基准值改为当前显示值，就可以实现从显示值开始冷却
+		double n1 = snapshot.n1[e];
+		double egt = snapshot.egt[e];
+		if (!isnan(n1)) engines[e].n1Base = n1;
+		if (!isnan(egt)) engines[e].egtBase = egt;
+		releaseCoolingOverride(engines[e]);
+	}
 
 	state = EngineState::STOPPING;
 	stopPhaseElapsed = 0.0;
 	fuelFlow = 0.0;
 	fuelFlowOverridden = false;
-	cout << "[Engine] Stopping sequence initiated.\n";
+	refreshStatus();
+	if (verbose) cout << "[Engine] Stopping sequence initiated.\n";
 }
 
-void Engine::advance(double dt) {
+template <class Config>
+void EngineModel<Config>::advance(double dt) {
 	if (state == EngineState::OFF) {
 		simElapsed += dt;
+		snapshot.simTime = simElapsed;
 		return;
 	}
 
 	simElapsed += dt;
 
+	// 每步固定取一批噪声，不论走哪个分支，保证随机数流与状态无关
+	uint32_t noise[NOISE_PER_STEP];
+	noiseRng.fill(noise, NOISE_PER_STEP);
+
 	// 传感器无效检查 - 移除了自动停机逻辑
 	if (fuelReserve < 0.0 || fuelReserve > FUEL_CAPACITY) {
 		fuelReserveSensorInvalid = true;
@@ -105,35 +124,37 @@ void Engine::advance(double dt) {
 	switch (state) {
 	case EngineState::STARTING: {
 		startPhaseElapsed += dt;  // 累积时间
-		double t = startPhaseElapsed;
-
-		double nVal = (t <= 2.0) ? (10000.0 * t) : (23000.0 * log10(t - 1.0) + 20000.0);
-		double vVal = (t <= 2.0) ? (5.0 * t) : (42.0 * log10(t - 1.0) + 10.0);
-		double tVal = (t <= 2.0) ? AMBIENT_TEMP : (900.0 * log10(t - 1.0) + AMBIENT_TEMP);
-
-		leftEngine.n1True = rightEngine.n1True = min(nVal, N1_MAX_RATED);
-		leftEngine.egtTrue = rightEngine.egtTrue = min(tVal, EGT_MAX);
+		double nVal, vVal, tVal;
+		spool->start(startPhaseElapsed, nVal, vVal, tVal);
+
+		bool allStable = true;
+		for (Unit& engine : engines) {
+			engine.n1True = min(nVal, N1_MAX_RATED);
+			engine.egtTrue = min(tVal, EGT_MAX);
+			allStable = allStable && engine.n1True >= N1_STABLE_THRESHOLD;
+		}
 		fuelFlow = min(vVal, FUEL_FLOW_MAX);
 
-		//  状态转换判断
-		if (leftEngine.n1True >= N1_STABLE_THRESHOLD && rightEngine.n1True >= N1_STABLE_THRESHOLD) {
+		//  状态转换判断：所有引擎都达到稳定阈值
+		if (allStable) {
 			state = EngineState::STABLE;
-			leftEngine.n1Base = leftEngine.n1True;
-			rightEngine.n1Base = rightEngine.n1True;
-			leftEngine.egtBase = leftEngine.egtTrue;
-			rightEngine.egtBase = rightEngine.egtTrue;
+			for (Unit& engine : engines) {
+				engine.n1Base = engine.n1True;
+				engine.egtBase = engine.egtTrue;
+			}
 			fuelFlowBase = fuelFlow;
-			cout << "[Engine] Reached stable state.\n";
+			if (verbose) cout << "[Engine] Reached stable state.\n";
 		}
 		break;
 	}
 	case EngineState::STABLE: {
-		leftEngine.n1True = leftEngine.n1Base * (1.0 + ((rand() % 101) / 10000.0) - 0.005);
-		leftEngine.egtTrue = leftEngine.egtBase * (1.0 + ((rand() % 101) / 10000.0) - 0.005);
-		rightEngine.n1True = rightEngine.n1Base * (1.0 + ((rand() % 101) / 10000.0) - 0.005);
-		rightEngine.egtTrue = rightEngine.egtBase * (1.0 + ((rand() % 101) / 10000.0) - 0.005);
+		for (int e = 0; e < ENGINES; ++e) {
+			Unit& engine = engines[e];
+			engine.n1True = engine.n1Base * (1.0 + noiseOffset(noise[NOISE_TRUE + 2 * e], 101, 10000.0, 0.005));
+			engine.egtTrue = engine.egtBase * (1.0 + noiseOffset(noise[NOISE_TRUE + 2 * e + 1], 101, 10000.0, 0.005));
+		}
 		if (!fuelFlowOverridden) {
-			fuelFlow = min(fuelFlowBase * (1.0 + ((rand() % 101) / 10000.0) - 0.005), FUEL_FLOW_MAX);
+			fuelFlow = min(fuelFlowBase * (1.0 + noiseOffset(noise[NOISE_FUEL], 101, 10000.0, 0.005)), FUEL_FLOW_MAX);
 		}
 		break;
 	}
@@ -141,18 +162,22 @@ void Engine::advance(double dt) {
 		stopPhaseElapsed += dt;
 		double t = stopPhaseElapsed;
 
-		double factor = (t < 8.0) ? (1.0 - log10(t + 1.0) / log10(9.0)) : 0.0;
-		leftEngine.n1True = leftEngine.n1Base * factor;
-		leftEngine.egtTrue = AMBIENT_TEMP + (leftEngine.egtBase - AMBIENT_TEMP) * factor;
-		rightEngine.n1True = rightEngine.n1Base * factor;
-		rightEngine.egtTrue = AMBIENT_TEMP + (rightEngine.egtBase - AMBIENT_TEMP) * factor;
+		double factor = spool->stopFactor(t);
+		bool allStopped = true;
+		for (Unit& engine : engines) {
+			engine.n1True = engine.n1Base * factor;
+			engine.egtTrue = AMBIENT_TEMP + (engine.egtBase - AMBIENT_TEMP) * factor;
+			allStopped = allStopped && engine.n1True <= 0.5;
+		}
 
-		if (t >= 8.0 || (leftEngine.n1True <= 0.5 && rightEngine.n1True <= 0.5)) {
+		if (t >= spool->stopDuration() || allStopped) {
 			state = EngineState::OFF;
-			leftEngine.n1True = rightEngine.n1True = 0.0;
-			leftEngine.egtTrue = rightEngine.egtTrue = AMBIENT_TEMP;
+			for (Unit& engine : engines) {
+				engine.n1True = 0.0;
+				engine.egtTrue = AMBIENT_TEMP;
+			}
 			fuelFlow = 0.0;
-			cout << "[Engine] Engine fully stopped.\n";
+			if (verbose) cout << "[Engine] Engine fully stopped.\n";
 		}
 		break;
 	}
@@ -160,8 +185,10 @@ void Engine::advance(double dt) {
 		break;
 	}
 
-	updateSensor(leftEngine);
-	updateSensor(rightEngine);
+	for (int e = 0; e < ENGINES; ++e) {
+		updateSensor(engines[e], noise + NOISE_SENSOR + e * 2 * SENSORS);
+	}
+	voteDisplayValues(); // 燃油耗尽时 stop() 从这里的显示值开始冷却
 
 	// 燃油消耗 - 只有在传感器有效时才消耗燃油
 	if (!fuelReserveSensorInvalid) {
@@ -169,43 +196,48 @@ void Engine::advance(double dt) {
 		if (fuelReserve <= 0) {
 			fuelReserve = 0;
 			if (state != EngineState::STOPPING && state != EngineState::OFF) {
-				cout << "[Engine] Fuel used-up. Shutting down engine.\n";
+				if (verbose) cout << "[Engine] Fuel used-up. Shutting down engine.\n";
 				stop();
 			}
 		}
 	}
+	refreshStatus();
 }
 
-// 增加推力
-void Engine::increaseThrust() {
+// 增加推力，所有引擎按同一比例调整
+template <class Config>
+void EngineModel<Config>::increaseThrust() {
 	if (state != EngineState::STABLE) {
 		return;
 	}
 	fuelFlowBase = min(fuelFlowBase + 1.0, FUEL_FLOW_MAX);
-	double increase = 0.03 + (rand() % 21) / 1000.0; // 3% - 5%
-	leftEngine.n1Base = min(leftEngine.n1Base * (1.0 + increase), N1_MAX);
-	rightEngine.n1Base = min(rightEngine.n1Base * (1.0 + increase), N1_MAX);
-	leftEngine.egtBase = min(leftEngine.egtBase * (1.0 + increase), EGT_MAX);
-	rightEngine.egtBase = min(rightEngine.egtBase * (1.0 + increase), EGT_MAX);
-	cout << "[Engine] Thrust increased.\n";
+	double increase = 0.03 + uniformInt(thrustRng.next(), 21) / 1000.0; // 3% - 5%
+	for (Unit& engine : engines) {
+		engine.n1Base = min(engine.n1Base * (1.0 + increase), N1_MAX);
+		engine.egtBase = min(engine.egtBase * (1.0 + increase), EGT_MAX);
+	}
+	if (verbose) cout << "[Engine] Thrust increased.\n";
 }
 
 // 减少推力
-void Engine::decreaseThrust() {
+template <class Config>
+void EngineModel<Config>::decreaseThrust() {
 	if (state != EngineState::STABLE) {
 		return;
 	}
 	fuelFlowBase = max(fuelFlowBase - 1.0, 0.0);
-	double decrease = 0.03 + (rand() % 21) / 1000.0; // 3% - 5%
-	leftEngine.n1Base = max(leftEngine.n1Base * (1.0 - decrease), 0.0);
-	rightEngine.n1Base = max(rightEngine.n1Base * (1.0 - decrease), 0.0);
-	leftEngine.egtBase = max(leftEngine.egtBase * (1.0 - decrease), AMBIENT_TEMP);
-	rightEngine.egtBase = max(rightEngine.egtBase * (1.0 - decrease), AMBIENT_TEMP);
-	cout << "[Engine] Thrust decreased.\n";
+	double decrease = 0.03 + uniformInt(thrustRng.next(), 21) / 1000.0; // 3% - 5%
+	for (Unit& engine : engines) {
+		engine.n1Base = max(engine.n1Base * (1.0 - decrease), 0.0);
+		engine.egtBase = max(engine.egtBase * (1.0 - decrease), AMBIENT_TEMP);
+	}
+	if (verbose) cout << "[Engine] Thrust decreased.\n";
 }
-void Engine::updateSensor(SingleEngine& engine) {
+// noise 依次为 N1 s1, EGT s1, N1 s2, EGT s2, ... 的随机数
+template <class Config>
+void EngineModel<Config>::updateSensor(Unit& engine, const uint32_t* noise) {
 	// 更新N1传感器读数
-	for (int s = 0; s < 2; ++s) {
+	for (int s = 0; s < SENSORS; ++s) {
 		if (engine.n1SensorOverridden[s]) {
 			engine.n1Sensor[s] = engine.n1SensorOverrideVal[s];
 		}
@@ -214,8 +246,8 @@ void Engine::updateSensor(SingleEngine& engine) {
 				engine.n1Sensor[s] = std::numeric_limits<double>::quiet_NaN();
 			}
 			else {
-				double noise = engine.n1True * (((rand() % 201) / 10000.0) - 0.005);
-				engine.n1Sensor[s] = engine.n1True + noise;
+				double offset = engine.n1True * noiseOffset(noise[2 * s], 201, 10000.0, 0.005);
+				engine.n1Sensor[s] = engine.n1True + offset;
 			}
 		}
 
@@ -228,8 +260,8 @@ void Engine::updateSensor(SingleEngine& engine) {
 				engine.egtSensor[s] = std::numeric_limits<double>::quiet_NaN();
 			}
 			else {
-				double noise = engine.egtTrue * (((rand() % 201) / 10000.0) - 0.01);
-				engine.egtSensor[s] = engine.egtTrue + noise;
+				double offset = engine.egtTrue * noiseOffset(noise[2 * s + 1], 201, 10000.0, 0.01);
+				engine.egtSensor[s] = engine.egtTrue + offset;
 			}
 		}
 
@@ -245,98 +277,94 @@ void Engine::updateSensor(SingleEngine& engine) {
 		}
 	}
 }
-// 仪表显示函数，两个都正常时取平均值，一个异常时取另一个，两个都异常时返回NaN
-double Engine::getDisplayedValue(const SingleEngine& engine, bool isN1) const {
-	double sum = 0.0;
-	int count = 0;
-	for (int s = 0; s < 2; ++s) {
-		bool bad = isN1 ? engine.n1SensorAnomal[s] : engine.egtSensorAnomal[s];
-		if (!bad) {
-			double value = isN1 ? engine.n1Sensor[s] : engine.egtSensor[s];
-			if (!isnan(value)) {
-				sum += value;
-				++count;
-			}
+// 每步只表决一次，日志、告警和界面读到的都是这里的结果
+// 各引擎的 N1 排在前、EGT 排在后，组成 2 * ENGINES 个通道，一次调用表决完
+template <class Config>
+void EngineModel<Config>::voteDisplayValues() {
+	double column[SENSORS][2 * ENGINES];
+	for (int e = 0; e < ENGINES; ++e) {
+		const Unit& engine = engines[e];
+		for (int s = 0; s < SENSORS; ++s) {
+			snapshot.n1Anomal[e][s] = engine.n1SensorAnomal[s];
+			snapshot.egtAnomal[e][s] = engine.egtSensorAnomal[s];
+			double n1 = engine.n1SensorAnomal[s] ? numeric_limits<double>::quiet_NaN() : engine.n1Sensor[s];
+			double egt = engine.egtSensorAnomal[s] ? numeric_limits<double>::quiet_NaN() : engine.egtSensor[s];
+			snapshot.n1Sensor[e][s] = column[s][e] = n1;
+			snapshot.egtSensor[e][s] = column[s][ENGINES + e] = egt;
 		}
 	}
 
-	return (count > 0) ? (sum / count) : numeric_limits<double>::quiet_NaN();
-}
-
-double Engine::getSimTime() const { return simElapsed; }
-
-// 传感器与显示值
-double Engine::getN1Left() const {return getDisplayedValue(leftEngine, true);}
-double Engine::getN1Right() const {return getDisplayedValue(rightEngine, true);}
-double Engine::getEgtLeft() const {return getDisplayedValue(leftEngine, false);}
-double Engine::getEgtRight() const {return getDisplayedValue(rightEngine, false);}
-
-double Engine::getN1LeftPercentage() const {
-	double n1 = getN1Left();
-	return isnan(n1) ? numeric_limits<double>::quiet_NaN() : (n1 / N1_MAX_RATED) * 100.0;
-}
-
-double Engine::getN1RightPercentage() const {
-	double n1 = getN1Right();
-	return isnan(n1) ? numeric_limits<double>::quiet_NaN() : (n1 / N1_MAX_RATED) * 100.0;
-}
-
-double Engine::getFuelFlow() const {
-	return fuelFlowSensorInvalid ? numeric_limits<double>::quiet_NaN() : fuelFlow;
+	const double* rows[SENSORS];
+	for (int s = 0; s < SENSORS; ++s) rows[s] = column[s];
+	double voted[2 * ENGINES];
+	uint8_t disagree[2 * ENGINES];
+	voteMidValue<SENSORS>(rows, 2 * ENGINES, voted, disagree);
+
+	for (int e = 0; e < ENGINES; ++e) {
+		double n1 = voted[e];
+		snapshot.n1[e] = n1;
+		snapshot.egt[e] = voted[ENGINES + e];
+		snapshot.n1Percent[e] = isnan(n1) ? numeric_limits<double>::quiet_NaN() : (n1 / N1_MAX_RATED) * 100.0;
+		snapshot.n1Disagree[e] = disagree[e] != 0;
+		snapshot.egtDisagree[e] = disagree[ENGINES + e] != 0;
+	}
 }
 
-double Engine::getFuelReserve() const {
-	return fuelReserveSensorInvalid ? numeric_limits<double>::quiet_NaN() : fuelReserve;
+template <class Config>
+void EngineModel<Config>::refreshStatus() {
+	snapshot.state = state;
+	snapshot.simTime = simElapsed;
+	snapshot.fuelFlow = fuelFlowSensorInvalid ? numeric_limits<double>::quiet_NaN() : fuelFlow;
+	snapshot.fuelReserve = fuelReserveSensorInvalid ? numeric_limits<double>::quiet_NaN() : fuelReserve;
+	snapshot.fuelReserveInvalid = fuelReserveSensorInvalid;
+	snapshot.fuelFlowInvalid = fuelFlowSensorInvalid;
 }
 
-EngineState Engine::getState() const {return state;}
-
-
+template <class Config>
+double EngineModel<Config>::getSimTime() const { return simElapsed; }
+template <class Config>
+uint64_t EngineModel<Config>::getSeed() const { return noiseRng.getSeed(); }
 
 // 控制接口，用于指令行传感器覆盖和异常
-double Engine::getSensorValue(int engine_id, int sensor_type, int sensor_id) const {
-	const SingleEngine& engine = (engine_id == 0) ? leftEngine : rightEngine;
-	if (sensor_type == 0) { // N1
-		if (engine.n1SensorAnomal[sensor_id])
-			return numeric_limits<double>::quiet_NaN();
-		return engine.n1Sensor[sensor_id];
-	}
-	else {
-		if (engine.egtSensorAnomal[sensor_id])
-			return numeric_limits<double>::quiet_NaN();
-		return engine.egtSensor[sensor_id];
-	}
+template <class Config>
+double EngineModel<Config>::getSensorValue(int engine_id, int sensor_type, int sensor_id) const {
+	return (sensor_type == 0) ? snapshot.n1Sensor[engine_id][sensor_id] : snapshot.egtSensor[engine_id][sensor_id]; // N1 / EGT
 }
 
-void Engine::setForcedN1Sensor(int engine_id, int sensor_id, double value) {
-	SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	if (sensor_id < 0 || sensor_id>1) return;
+template <class Config>
+void EngineModel<Config>::setForcedN1Sensor(int engine_id, int sensor_id, double value) {
+	if (engine_id < 0 || engine_id >= ENGINES || sensor_id < 0 || sensor_id >= SENSORS) return;
+	Unit& eng = engines[engine_id];
 	eng.n1SensorOverridden[sensor_id] = true;
 	eng.n1SensorOverrideVal[sensor_id] = value;
 }
 
-void Engine::resetN1SensorOverride(int engine_id, int sensor_id) {
-	SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	if (sensor_id < 0 || sensor_id>1) return;
-	eng.n1SensorOverridden[sensor_id] = false;
+template <class Config>
+void EngineModel<Config>::resetN1SensorOverride(int engine_id, int sensor_id) {
+	if (engine_id < 0 || engine_id >= ENGINES || sensor_id < 0 || sensor_id >= SENSORS) return;
+	engines[engine_id].n1SensorOverridden[sensor_id] = false;
 }
 
-void Engine::setForcedEGTSensor(int engine_id, int sensor_id, double value) {
-	SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	if (sensor_id < 0 || sensor_id>1) return;
+template <class Config>
+void EngineModel<Config>::setForcedEGTSensor(int engine_id, int sensor_id, double value) {
+	if (engine_id < 0 || engine_id >= ENGINES || sensor_id < 0 || sensor_id >= SENSORS) return;
+	Unit& eng = engines[engine_id];
 	eng.egtSensorOverridden[sensor_id] = true;
 	eng.egtSensorOverrideVal[sensor_id] = value;
 }
 
-void Engine::resetEGTSensorOverride(int engine_id, int sensor_id) {
-	SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	if (sensor_id < 0 || sensor_id>1) return;
-	eng.egtSensorOverridden[sensor_id] = false;
+template <class Config>
+void EngineModel<Config>::resetEGTSensorOverride(int engine_id, int sensor_id) {
+	if (engine_id < 0 || engine_id >= ENGINES || sensor_id < 0 || sensor_id >= SENSORS) return;
+	engines[engine_id].egtSensorOverridden[sensor_id] = false;
 }
 
-void Engine::setForcedFuelReserve(double value) {fuelReserve = value;}
-void Engine::resetFuelReserveOverride() { fuelReserve = FUEL_CAPACITY; }
-void Engine::setFuelReserveSensorInvalid(bool invalid) {
+template <class Config>
+void EngineModel<Config>::setForcedFuelReserve(double value) { fuelReserve = value; refreshStatus(); }
+template <class Config>
+void EngineModel<Config>::resetFuelReserveOverride() { fuelReserve = FUEL_CAPACITY; refreshStatus(); }
+template <class Config>
+void EngineModel<Config>::setFuelReserveSensorInvalid(bool invalid) {
 	if (invalid && !fuelReserveSensorInvalid) {
 		// 在设置为无效之前，备份当前燃油余量
 		fuelReserveBeforeInvalid = fuelReserve;
@@ -347,12 +375,14 @@ void Engine::setFuelReserveSensorInvalid(bool invalid) {
 		// 恢复到设置为无效之前的状态
 		fuelReserve = fuelReserveBeforeInvalid;
 	}
+	refreshStatus();
 }
-bool Engine::isFuelReserveSensorInvalid() const { return fuelReserveSensorInvalid; }
-void Engine::setFuelFlowSensorInvalid(bool invalid) { fuelFlowSensorInvalid = invalid; }
-bool Engine::isFuelFlowSensorInvalid() const { return fuelFlowSensorInvalid; }
-void Engine::setForcedFuelFlow(double value) { fuelFlow = value; fuelFlowOverridden = true; }
-void Engine::resetForcedFuelFlow() {
+template <class Config>
+void EngineModel<Config>::setFuelFlowSensorInvalid(bool invalid) { fuelFlowSensorInvalid = invalid; refreshStatus(); }
+template <class Config>
+void EngineModel<Config>::setForcedFuelFlow(double value) { fuelFlow = value; fuelFlowOverridden = true; refreshStatus(); }
+template <class Config>
+void EngineModel<Config>::resetForcedFuelFlow() {
 	fuelFlowOverridden = false;
 	// 恢复为当前基准值，下一帧会正常计算
 	if (state == EngineState::STABLE && fuelFlowBase > 0) {
@@ -361,22 +391,171 @@ void Engine::resetForcedFuelFlow() {
 	else if (state == EngineState::OFF || state == EngineState::STOPPING) {
 		fuelFlow = 0.0;
 	}
+	refreshStatus();
+}
+
+// 是否所有传感器均异常
+template <class Config>
+bool EngineModel<Config>::isN1SystemFault(int engine_id) const {
+	return (engine_id >= 0 && engine_id < ENGINES) ? snapshot.n1SystemFault(engine_id) : false;
+}
+template <class Config>
+bool EngineModel<Config>::isEGTSystemFault(int engine_id) const {
+	return (engine_id >= 0 && engine_id < ENGINES) ? snapshot.egtSystemFault(engine_id) : false;
+}
+template <class Config>
+bool EngineModel<Config>::isN1SensorAnomal(int engine_id, int s) const {
+	return (engine_id >= 0 && engine_id < ENGINES && s >= 0 && s < SENSORS) ? snapshot.n1Anomal[engine_id][s] : false;
+}
+template <class Config>
+bool EngineModel<Config>::isEGTSensorAnomal(int engine_id, int s) const {
+	return (engine_id >= 0 && engine_id < ENGINES && s >= 0 && s < SENSORS) ? snapshot.egtAnomal[engine_id][s] : false;
+}
+// -----快照-----
+// 布局：魔数 "ESNP"、版本 (uint32)、载荷长度 (uint32)，随后各字段按声明顺序紧密排列，字节序与本机相同
+static const char SNAPSHOT_MAGIC[4] = { 'E', 'S', 'N', 'P' };
+static const size_t SNAPSHOT_HEADER_SIZE = 12;
+
+// 魔数、版本和载荷长度都对得上时返回 true
+static bool checkSnapshotHeader(const uint8_t* data, size_t size, uint32_t expectedVersion) {
+	if (size < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, 4) != 0) return false;
+	uint32_t version, payload;
+	memcpy(&version, data + 4, sizeof(version));
+	memcpy(&payload, data + 8, sizeof(payload));
+	return version == expectedVersion && payload == size - SNAPSHOT_HEADER_SIZE;
+}
+
+namespace {
+	struct SnapshotWriter {
+		vector<uint8_t>& out;
+		template <typename T> void put(const T& value) {
+			size_t at = out.size();
+			out.resize(at + sizeof(T));
+			memcpy(out.data() + at, &value, sizeof(T));
+		}
+		void put(bool value) { put(static_cast<uint8_t>(value ? 1 : 0)); }
+		template <typename T, size_t N> void put(const T (&values)[N]) {
+			for (size_t i = 0; i < N; ++i) put(values[i]);
+		}
+		template <typename T, size_t N> void put(const array<T, N>& values) {
+			for (size_t i = 0; i < N; ++i) put(values[i]);
+		}
+	};
+
+	struct SnapshotReader {
+		const uint8_t* p;
+		const uint8_t* end;
+		bool failed = false; // 越界或取值非法，由 ok() 报告
+		template <typename T> void get(T& value) {
+			if (failed || static_cast<size_t>(end - p) < sizeof(T)) { failed = true; return; }
+			memcpy(&value, p, sizeof(T));
+			p += sizeof(T);
+		}
+		// bool 按单字节读取，只接受 0/1，避免把任意字节拷成非法的 bool 表示
+		void get(bool& value) {
+			uint8_t byte = 0;
+			get(byte);
+			if (byte > 1) failed = true;
+			value = (byte == 1);
+		}
+		template <typename T, size_t N> void get(T (&values)[N]) {
+			for (size_t i = 0; i < N && ok(); ++i) get(values[i]);
+		}
+		template <typename T, size_t N> void get(array<T, N>& values) {
+			for (size_t i = 0; i < N && ok(); ++i) get(values[i]);
+		}
+		bool ok() const { return !failed; }
+	};
+}
+
+template <int Sensors>
+static void putEngine(SnapshotWriter& w, const SingleEngine<Sensors>& e) {
+	w.put(e.n1True); w.put(e.egtTrue);
+	w.put(e.n1Sensor); w.put(e.egtSensor);
+	w.put(e.n1SensorAnomal); w.put(e.egtSensorAnomal);
+	w.put(e.n1SensorOverridden); w.put(e.egtSensorOverridden);
+	w.put(e.n1SensorForcedAnomal); w.put(e.egtSensorForcedAnomal);
+	w.put(e.n1SensorOverrideVal); w.put(e.egtSensorOverrideVal);
+	w.put(e.n1Base); w.put(e.egtBase);
 }
 
-// 是否两个传感器均异常
-bool Engine::isN1SystemFault(int engine_id) const {
-	const SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	return eng.n1SensorAnomal[0] && eng.n1SensorAnomal[1];
+template <int Sensors>
+static void getEngine(SnapshotReader& r, SingleEngine<Sensors>& e) {
+	r.get(e.n1True); r.get(e.egtTrue);
+	r.get(e.n1Sensor); r.get(e.egtSensor);
+	r.get(e.n1SensorAnomal); r.get(e.egtSensorAnomal);
+	r.get(e.n1SensorOverridden); r.get(e.egtSensorOverridden);
+	r.get(e.n1SensorForcedAnomal); r.get(e.egtSensorForcedAnomal);
+	r.get(e.n1SensorOverrideVal); r.get(e.egtSensorOverrideVal);
+	r.get(e.n1Base); r.get(e.egtBase);
 }
-bool Engine::isEGTSystemFault(int engine_id) const {
-	const SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	return eng.egtSensorAnomal[0] && eng.egtSensorAnomal[1];
+
+template <class Config>
+void EngineModel<Config>::saveSnapshot(vector<uint8_t>& out) const {
+	out.clear();
+	out.reserve(512);
+	SnapshotWriter w{ out };
+	w.put(SNAPSHOT_MAGIC);
+	w.put(SNAPSHOT_VERSION);
+	w.put(uint32_t(0)); // 载荷长度，写完后回填
+
+	w.put(static_cast<uint8_t>(state));
+	w.put(simElapsed); w.put(startPhaseElapsed); w.put(stopPhaseElapsed);
+	w.put(fuelFlow); w.put(fuelReserve); w.put(fuelFlowBase); w.put(fuelReserveBeforeInvalid);
+	w.put(fuelReserveSensorInvalid); w.put(fuelFlowSensorInvalid); w.put(fuelFlowOverridden);
+	for (const Unit& engine : engines) putEngine(w, engine);
+	w.put(noiseRng.getSeed()); w.put(noiseRng.position());
+	w.put(thrustRng.getSeed()); w.put(thrustRng.position());
+
+	uint32_t payload = static_cast<uint32_t>(out.size() - SNAPSHOT_HEADER_SIZE);
+	memcpy(out.data() + 8, &payload, sizeof(payload));
+}
+
+template <class Config>
+bool EngineModel<Config>::loadSnapshot(const uint8_t* data, size_t size) {
+	if (!checkSnapshotHeader(data, size, SNAPSHOT_VERSION)) return false;
+
+	// 先读到副本，全部成功后再替换，失败时引擎保持原样
+	EngineModel restored(*this);
+	SnapshotReader r{ data + SNAPSHOT_HEADER_SIZE, data + size };
+	uint8_t stateValue = 0;
+	r.get(stateValue);
+	r.get(restored.simElapsed); r.get(restored.startPhaseElapsed); r.get(restored.stopPhaseElapsed);
+	r.get(restored.fuelFlow); r.get(restored.fuelReserve); r.get(restored.fuelFlowBase); r.get(restored.fuelReserveBeforeInvalid);
+	r.get(restored.fuelReserveSensorInvalid); r.get(restored.fuelFlowSensorInvalid); r.get(restored.fuelFlowOverridden);
+	for (Unit& engine : restored.engines) getEngine(r, engine);
+	uint64_t noiseSeed = 0, noisePos = 0, thrustSeed = 0, thrustPos = 0;
+	r.get(noiseSeed); r.get(noisePos);
+	r.get(thrustSeed); r.get(thrustPos);
+	if (!r.ok() || r.p != r.end || stateValue > static_cast<uint8_t>(EngineState::STOPPING)) return false;
+
+	restored.state = static_cast<EngineState>(stateValue);
+	restored.noiseRng = PhiloxRng(noiseSeed, 0);
+	restored.noiseRng.seek(noisePos);
+	restored.thrustRng = PhiloxRng(thrustSeed, 1);
+	restored.thrustRng.seek(thrustPos);
+	restored.verbose = verbose;
+	restored.voteDisplayValues();
+	restored.refreshStatus();
+	*this = restored;
+	return true;
 }
-bool Engine::isN1SensorAnomal(int engine_id, int s) const {
-	const SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	return (s >= 0 && s < 2) ? eng.n1SensorAnomal[s] : false;
+
+template <class Config>
+bool EngineModel<Config>::snapshotSimTime(const uint8_t* data, size_t size, double& simTime) {
+	if (!checkSnapshotHeader(data, size, SNAPSHOT_VERSION)) return false;
+	SnapshotReader r{ data + SNAPSHOT_HEADER_SIZE, data + size };
+	uint8_t stateValue = 0;
+	r.get(stateValue); // 载荷依次为状态和运行时间，见 saveSnapshot
+	r.get(simTime);
+	return r.ok();
 }
-bool Engine::isEGTSensorAnomal(int engine_id, int s) const {
-	const SingleEngine& eng = (engine_id == 0) ? leftEngine : rightEngine;
-	return (s >= 0 && s < 2) ? eng.egtSensorAnomal[s] : false;
-}
\ No newline at end of file
+
+template <class Config>
+void EngineModel<Config>::reseed(uint64_t seed) {
+	noiseRng = PhiloxRng(seed, 0);
+	thrustRng = PhiloxRng(seed, 1);
+}
+
+#define INSTANTIATE_ENGINE_MODEL(C) template class EngineModel<C>;
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_ENGINE_MODEL)
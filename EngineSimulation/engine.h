@@ -6,6 +6,11 @@
 #include <algorithm>
 #include <random>
 #include <limits>
+#include <cstdint>
+#include <array>
+#include "rng.h"
+#include "engine_config.h"
+#include "spool.h"
 
 // -----CONSTANTS-----
 const double FUEL_CAPACITY = 20000.0; // ȼ
@@ -18,27 +23,82 @@ const double N1_STABLE_THRESHOLD = 0.95 * N1_MAX_RATED; // 
 
 enum class EngineState { OFF, STARTING, STABLE, STOPPING }; 
 
-// Ľṹ
+// Ľṹ壬Sensors Ϊÿͨഫ
+template <int Sensors>
 struct SingleEngine {
 	double n1True = 0.0;  // ׼ֵ+N1ת
 	double egtTrue = AMBIENT_TEMP;  // ׼ֵ+EGT¶
-	double n1Sensor[2] = { 0.0, 0.0 }; // N1x2
-	double egtSensor[2] = { AMBIENT_TEMP, AMBIENT_TEMP }; // EGTx2
-	bool n1SensorAnomal[2] = { false, false }; // N1쳣־x2
-	bool egtSensorAnomal[2] = { false, false }; // EGT쳣־x2
-	bool n1SensorOverridden[2] = { false, false }; // N1Ǳ־x2(failʱǷҪ)
-	bool egtSensorOverridden[2] = { false, false }; // EGTǱ־x2(failʱǷҪ)
-	bool n1SensorForcedAnomal[2] = { false, false }; // N1ǿ쳣־x2֣
-	bool egtSensorForcedAnomal[2] = { false, false }; // EGTǿ쳣־x2֣
-	double n1SensorOverrideVal[2] = { 0.0, 0.0 }; // N1ֵx2
-	double egtSensorOverrideVal[2] = { 0.0, 0.0 }; // EGTֵx2
+	std::array<double, Sensors> n1Sensor = {}; // N1
+	std::array<double, Sensors> egtSensor = {}; // EGTʱ¶
+	std::array<bool, Sensors> n1SensorAnomal = {}; // N1쳣־
+	std::array<bool, Sensors> egtSensorAnomal = {}; // EGT쳣־
+	std::array<bool, Sensors> n1SensorOverridden = {}; // N1Ǳ־(failʱǷҪ)
+	std::array<bool, Sensors> egtSensorOverridden = {}; // EGTǱ־(failʱǷҪ)
+	std::array<bool, Sensors> n1SensorForcedAnomal = {}; // N1ǿ쳣־֣
+	std::array<bool, Sensors> egtSensorForcedAnomal = {}; // EGTǿ쳣־֣
+	std::array<double, Sensors> n1SensorOverrideVal = {}; // N1ֵ
+	std::array<double, Sensors> egtSensorOverrideVal = {}; // EGTֵ
     double n1Base = 0.0; // ֵ
 	double egtBase = AMBIENT_TEMP; // ֵ
+
+	SingleEngine() { egtSensor.fill(AMBIENT_TEMP); }
+};
+
+// ÿƽһεֻգʾֵٷֱȡ쳣λȼͺ״̬
+// ־澯жͽ涼ٸظطʱɼ¼־ԭ readSample
+template <class Config>
+struct BasicEngineSnapshot {
+    static const int ENGINES = Config::ENGINES;
+    static const int SENSORS = Config::SENSORS;
+    typedef std::array<std::array<double, SENSORS>, ENGINES> SensorValues; // [][]
+    typedef std::array<std::array<bool, SENSORS>, ENGINES> SensorFlags;
+
+    EngineState state = EngineState::OFF;
+    double simTime = 0.0;
+    std::array<double, ENGINES> n1 = {};        //  N1 ʾֵд쳣ʱΪ NaN
+    std::array<double, ENGINES> egt = {};       //  EGT ʾֵʱ¶
+    std::array<double, ENGINES> n1Percent = {}; // N1 ʾֵռתٵİٷֱȣʾֵΪ NaN ʱΪ NaN
+    SensorValues n1Sensor = {};                 // 쳣ʱΪ NaN
+    SensorValues egtSensor = {};
+    double fuelFlow = 0.0;                      // ЧʱΪ NaN
+    double fuelReserve = 0.0;                   // ЧʱΪ NaN
+    SensorFlags n1Anomal = {};
+    SensorFlags egtAnomal = {};
+    std::array<bool, ENGINES> n1Disagree = {};  // Чݲ vote.hʾֵΪֵ
+    std::array<bool, ENGINES> egtDisagree = {};
+    bool fuelReserveInvalid = false;
+    bool fuelFlowInvalid = false;
+
+    BasicEngineSnapshot() {
+        egt.fill(AMBIENT_TEMP);
+        for (auto& sensors : egtSensor) sensors.fill(AMBIENT_TEMP);
+    }
+
+    double n1Percentage(int e) const { return n1Percent[e]; }
+    // д쳣
+    bool n1SystemFault(int e) const { return allSet(n1Anomal[e]); }
+    bool egtSystemFault(int e) const { return allSet(egtAnomal[e]); }
+
+private:
+    static bool allSet(const std::array<bool, SENSORS>& flags) {
+        bool all = true;
+        for (int s = 0; s < SENSORS; ++s) all = all && flags[s];
+        return all;
+    }
 };
 
-class Engine {
+// ģͣConfig Ϊ̨ȣ engine_config.h湲һȼϵͳ
+// ʵ engine.cpp FOR_EACH_ENGINE_CONFIG ʽʵ
+template <class Config>
+class EngineModel {
 public:
-    Engine();
+    static const int ENGINES = Config::ENGINES;
+    static const int SENSORS = Config::SENSORS;
+    typedef Config ConfigType;
+    typedef BasicEngineSnapshot<Config> Snapshot;
+
+    EngineModel(); // ǰʱѡȡ
+    explicit EngineModel(uint64_t seed); // ָӣͬӺͬеõȫͬĽ
 
 	// ֹͣ
     void start();
@@ -53,21 +113,32 @@ public:
 
     //  UI / ־ȡ
     double getSimTime() const;
-
-    // ʾֵ
-    double getN1Left() const;
-    double getN1Right() const;
-    double getEgtLeft() const;
-    double getEgtRight() const;
-    double getN1LeftPercentage() const;
-    double getN1RightPercentage() const;
-    double getFuelFlow() const;
-    double getFuelReserve() const;
-    EngineState getState() const;
+    uint64_t getSeed() const;
+    void setVerbose(bool enabled) { verbose = enabled; } // ʱرտ̨
+    // /ͣߣ spool.hĬΪߣֻãprofile þá߲״̬浽
+    void setSpoolProfile(const SpoolProfile& profile) { spool = &profile; }
+
+    // һĶգ saveSnapshot Ķ״ֻ̬ͬ getter ֻǶȡеֶ
+    // һ޸ģadvancestart/stopȼصĿƽӿڣݸı䣬Ҫʱ
+    const Snapshot& getSnapshot() const { return snapshot; }
+
+    // ʾֵe Ϊ±ꣻLeft/Right Ϊ˫ϰдӦ± 0  1
+    double getN1(int e) const { return snapshot.n1[e]; }
+    double getEgt(int e) const { return snapshot.egt[e]; }
+    double getN1Percentage(int e) const { return snapshot.n1Percent[e]; }
+    double getN1Left() const { return snapshot.n1[0]; }
+    double getN1Right() const { return snapshot.n1[1]; }
+    double getEgtLeft() const { return snapshot.egt[0]; }
+    double getEgtRight() const { return snapshot.egt[1]; }
+    double getN1LeftPercentage() const { return snapshot.n1Percent[0]; }
+    double getN1RightPercentage() const { return snapshot.n1Percent[1]; }
+    double getFuelFlow() const { return snapshot.fuelFlow; }
+    double getFuelReserve() const { return snapshot.fuelReserve; }
+    EngineState getState() const { return state; }
 
     double getSensorValue(int engine_idx, int sensor_type, int sensor_idx) const;
 
-    // ƽӿ
+    // ƽӿڣ򴫸±Խʱ
     void setForcedN1Sensor(int e, int s, double v);
     void resetN1SensorOverride(int e, int s);
     void setForcedEGTSensor(int e, int s, double v);
@@ -75,9 +146,9 @@ public:
     void setForcedFuelReserve(double value);
     void resetFuelReserveOverride();
     void setFuelReserveSensorInvalid(bool invalid);
-    bool isFuelReserveSensorInvalid() const;
+    bool isFuelReserveSensorInvalid() const { return snapshot.fuelReserveInvalid; }
     void setFuelFlowSensorInvalid(bool invalid);
-    bool isFuelFlowSensorInvalid() const;
+    bool isFuelFlowSensorInvalid() const { return snapshot.fuelFlowInvalid; }
     void setForcedFuelFlow(double value);
     void resetForcedFuelFlow();
 
@@ -86,13 +157,28 @@ public:
     bool isN1SystemFault(int e) const;
     bool isEGTSystemFault(int e) const;
 
+    // ״̬գ״̬׶μʱȼ̨͡棨Ǻǿ쳣־Լλõİ汾Ʊʾ
+    // ָƽ뱣ʱһ£verbose ״̬
+    // غɳòͬͬõĿ򳤶Ȳܾ
+    static constexpr uint32_t SNAPSHOT_VERSION = 1;
+    void saveSnapshot(std::vector<uint8_t>& out) const; //  out 
+    bool loadSnapshot(const uint8_t* data, size_t size); // ʽ汾򳤶Ȳʱ false޸
+    static bool snapshotSimTime(const uint8_t* data, size_t size, double& simTime); // ֻյʱ䣬
+    // ӣ״̬䣻ͬһճĶʵòͬӵõͬ
+    void reseed(uint64_t seed);
 
 
 private:
+    friend class EngineBench; // ׼򵥶ʱºʾֵ
+    typedef SingleEngine<SENSORS> Unit;
+
 	// ״̬º
     void resetParameters();
-    void updateSensor(SingleEngine& eng);
-    double getDisplayedValue(const SingleEngine& eng, bool isN1) const;
+    void updateSensor(Unit& eng, const uint32_t* noise);
+    // ˢ£仯ÿ updateSensor ֮áָ voteMidValue һα N1  EGT
+    // ״̬ʱȼͱ仯ˢֶΣֻǼθֵ
+    void voteDisplayValues();
+    void refreshStatus();
 
 	// ״̬ʼ
     EngineState state = EngineState::OFF;
@@ -110,8 +196,28 @@ private:
     bool fuelFlowSensorInvalid = false;
     bool fuelFlowOverridden = false;
 
-	// 2̨
-    SingleEngine leftEngine;
-    SingleEngine rightEngine;
-    double fuelReserveBeforeInvalid;
-};
\ No newline at end of file
+	// ̨棬˫ʱ± 0 Ϊ󷢡1 Ϊҷ
+    std::array<Unit, ENGINES> engines;
+    double fuelReserveBeforeInvalid = 0.0;
+
+    bool verbose = true;
+    const SpoolProfile* spool = &SpoolProfile::builtin();
+
+    Snapshot snapshot;
+
+	// ÿȡ̶ʹöӰ
+	// ÿΪ N1/EGT ֵȼĴN1/EGT 棩 Philox ճ 4 ı
+    static const int NOISE_TRUE = 0;
+    static const int NOISE_FUEL = 2 * ENGINES;
+    static const int NOISE_SENSOR = NOISE_FUEL + 1;
+    static const int NOISE_PER_STEP = (NOISE_SENSOR + 2 * ENGINES * SENSORS + 3) / 4 * 4;
+    PhiloxRng noiseRng;
+    PhiloxRng thrustRng;
+};
+
+#define DECLARE_ENGINE_MODEL(C) extern template class EngineModel<C>;
+FOR_EACH_ENGINE_CONFIG(DECLARE_ENGINE_MODEL)
+#undef DECLARE_ENGINE_MODEL
+
+typedef EngineModel<TwinConfig> Engine;              // ĬϹʹõ˫ģ
+typedef BasicEngineSnapshot<TwinConfig> EngineSnapshot;
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <string>
+
+// 发动机配置：引擎台数和每个通道（N1、EGT）的冗余传感器个数，作为模板参数在编译期确定
+// 存储用定长数组，循环次数是常量，编译器全部展开；2x2 与原来写死两台两传感器时生成的代码相同
+template <int Engines, int Sensors>
+struct EngineConfig {
+    static_assert(Engines >= 2 && Engines <= 8, "2-8 engines supported");
+    static_assert(Sensors >= 1 && Sensors <= 8, "1-8 sensors per channel supported");
+
+    static const int ENGINES = Engines;
+    static const int SENSORS = Sensors;
+    // 日志数据列：每台引擎依次为 N1 传感器 x M、N1 显示值、EGT 传感器 x M、EGT 显示值，最后是燃油流量和余量
+    static const int LOG_COLUMNS = Engines * (2 * Sensors + 2) + 2;
+};
+
+typedef EngineConfig<2, 2> TwinConfig;    // 双发双余度，界面程序和默认工具使用
+typedef EngineConfig<3, 3> TrijetConfig;  // 三发三余度
+typedef EngineConfig<4, 3> QuadConfig;    // 四发三余度
+
+// 所有显式实例化的配置；模板实现都在 .cpp 中，新增配置只需在这里加一项
+#define FOR_EACH_ENGINE_CONFIG(X) X(TwinConfig) X(TrijetConfig) X(QuadConfig)
+
+// 运行时用到的配置描述：指令目标、日志列名和警报文字按它生成
+struct EngineLayout {
+    int engines;
+    int sensors;
+
+    template <class Config>
+    static EngineLayout of() { return { Config::ENGINES, Config::SENSORS }; }
+
+    bool operator==(const EngineLayout& other) const { return engines == other.engines && sensors == other.sensors; }
+    bool operator!=(const EngineLayout& other) const { return !(*this == other); }
+
+    // 双发沿用左右命名（L/R、LEFT/RIGHT），其他配置按 1..N 编号
+    std::string engineTag(int e) const {
+        if (engines == 2) return e == 0 ? "L" : "R";
+        return std::to_string(e + 1);
+    }
+    std::string engineName(int e) const {
+        if (engines == 2) return e == 0 ? "LEFT" : "RIGHT";
+        return "ENGINE " + std::to_string(e + 1);
+    }
+    // 解析 engineTag 生成的名字，不合法时返回 -1
+    int findEngine(const std::string& tag) const {
+        for (int e = 0; e < engines; ++e) {
+            if (tag == engineTag(e)) return e;
+        }
+        return -1;
+    }
+    // 如 "2x2"、"4x3"
+    std::string name() const { return std::to_string(engines) + "x" + std::to_string(sensors); }
+};
+
+const EngineLayout TWIN_LAYOUT = { TwinConfig::ENGINES, TwinConfig::SENSORS };
@@ -1,135 +1,241 @@
 #include "event.h"
 using namespace std;
 
-void commandLoop(bool& cmdThreadRunning, Engine& engine) {
-	cout << "[cmdThread]Usage: set <target> <type> [level]\n";
-	cout << "       <target>: N1_L1/N1_L2/N1_R1/N1_R2/EGT_L1/EGT_L2/EGT_R1/EGT_R2/FUEL_RES/FUEL_FLOW\n";
-	cout << "       <type>: fail/overspeed/overtemp/low/value\n";
-	cout << "       Start the engine before entering command.\n";
-	cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX fail(X=1-2)\n";
-	cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX overspeed/overtemp amber/red(X=1-2)\n";
-	cout << "       e.g., set FUEL_RES low/fail\n";
-	cout << "       e.g., set FUEL_FLOW fail/value 1000\n";
-	string line;
-	while (cmdThreadRunning) {
-		if (!getline(cin, line) || !cmdThreadRunning) {
-			break;
-		}
-		istringstream iss(line);
-		string cmd;
-		if (!(iss >> cmd)) continue;
+// "set FUEL_RES low" ǿƵȼdescribeCommand ݴ˻ԭ low
+static const double FUEL_RESERVE_LOW = 1000.0;
 
-		if (cmd == "set") {
-			string target, type, lvl;
-			if (!(iss >> target >> type)) {
-				// setûв
-				cout << "[cmdThread]Usage: set <target> <type> [level]\n";
-				cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX fail(X=1-2)\n";
-				cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX overspeed/overtemp amber/red(X=1-2)\n";
-				cout << "       e.g., set FUEL_RES low/fail\n";
-				cout << "       e.g., set FUEL_FLOW fail/value 1000\n";
-				continue;
-				// 
-			}
-			iss >> lvl;
-			if (target == "FUEL_RES") {
-				if (type == "low") {
-					engine.setForcedFuelReserve(1000.0);
-					cout << "[cmdThread]Set " << target << " to state 'low'\n";
-				}
-				else if (type == "fail") {
-					engine.setFuelReserveSensorInvalid(true);
-					cout << "[cmdThread]Set " << target << " to state 'invalid'\n";
-				}
-				else {
-					cout << "[cmdThread]Invalid type for FUEL_RES. Use 'low' or 'fail'.\n";
-				}
-				continue;
-			}
-			else if (target == "FUEL_FLOW") {
-				if (type == "value" && !lvl.empty()) {
-					try {
-						double value_to_set = stod(lvl);
-						engine.setForcedFuelFlow(value_to_set);
-						cout << "[cmdThread]Set " << target << " to value " << value_to_set << "\n";
-					}
-					catch (...) {
-						cout << "[cmdThread]Invalid value for FUEL_FLOW.\n";
-					}
-				}
-				else if (type == "fail") {
-					engine.setFuelFlowSensorInvalid(true);
-					cout << "[cmdThread]Set " << target << " to state 'invalid'\n";
-				}
-				else {
-					cout << "[cmdThread]Invalid type for FUEL_FLOW. Use 'value <number>' or 'fail'.\n";
-				}
-				continue;
-			}
-			double value;
-			bool is_n1_target = (target.find("N1") != string::npos);
-			bool is_egt_target = (target.find("EGT") != string::npos);
+// Ŀƣͨ +  + ţ˫ N1_L1EGT_R2ķ N1_313  1 Ŵ
+struct SensorTarget {
+	bool egt;
+	int engine;
+	int sensor;
+};
 
-			if (type == "fail") {
-				value = -50; // ʱıֵ
-			}
-			else if (type == "overspeed" && is_n1_target) {
-				if (lvl == "amber") value = 43000.0;
-				else if (lvl == "red") value = 49000.0;
-				else { cout << "[cmdThread]Invalid level for overspeed. Use 'amber' or 'red'.\n"; continue; }
-			}
-			else if (type == "overtemp" && is_egt_target) {
-				if (lvl == "amber") value = 960.0;
-				else if (lvl == "red") value = 1110.0;
-				else { cout << "[cmdThread]Invalid level for overtemp. Use 'amber' or 'red'.\n"; continue; }
+static string sensorTargetName(const SensorTarget& target, const EngineLayout& layout) {
+	return (target.egt ? "EGT_" : "N1_") + layout.engineTag(target.engine) + to_string(target.sensor + 1);
+}
+
+static bool findSensorTarget(const string& name, const EngineLayout& layout, SensorTarget& target) {
+	size_t prefix = (name.compare(0, 3, "N1_") == 0) ? 3 : (name.compare(0, 4, "EGT_") == 0) ? 4 : 0;
+	if (prefix == 0 || name.size() < prefix + 2) return false;
+	char digit = name.back(); //  8 ֻһλ
+	target.egt = (prefix == 4);
+	target.engine = layout.findEngine(name.substr(prefix, name.size() - prefix - 1));
+	target.sensor = digit - '1';
+	return target.engine >= 0 && digit >= '1' && target.sensor < layout.sensors;
+}
+
+static EngineCommand sensorCommand(const SensorTarget& target, bool set, double value) {
+	EngineCommand command;
+	if (set) command.type = target.egt ? CommandType::SET_EGT_SENSOR : CommandType::SET_N1_SENSOR;
+	else command.type = target.egt ? CommandType::RESET_EGT_SENSOR : CommandType::RESET_N1_SENSOR;
+	command.engine = static_cast<int8_t>(target.engine);
+	command.sensor = static_cast<int8_t>(target.sensor);
+	command.value = value;
+	return command;
+}
+
+bool parseCommand(const string& line, EngineCommand& command, ostream& out, const EngineLayout& layout) {
+	istringstream iss(line);
+	string cmd;
+	if (!(iss >> cmd)) return false;
+	command = EngineCommand();
+
+	if (cmd == "start" || cmd == "stop") {
+		command.type = (cmd == "start") ? CommandType::START : CommandType::STOP;
+	}
+	else if (cmd == "thrust") {
+		string direction;
+		iss >> direction;
+		if (direction == "up") command.type = CommandType::THRUST_UP;
+		else if (direction == "down") command.type = CommandType::THRUST_DOWN;
+		else {
+			out << "[cmdThread]Usage: thrust up/down\n";
+			return false;
+		}
+	}
+	else if (cmd == "set") {
+		string target, type, lvl;
+		if (!(iss >> target >> type)) {
+			// setûв
+			out << "[cmdThread]Usage: set <target> <type> [level]\n";
+			out << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX fail(X=1-2)\n";
+			out << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX overspeed/overtemp amber/red(X=1-2)\n";
+			out << "       e.g., set FUEL_RES low/fail\n";
+			out << "       e.g., set FUEL_FLOW fail/value 1000\n";
+			return false;
+			// 
+		}
+		iss >> lvl;
+		if (target == "FUEL_RES") {
+			if (type == "low") {
+				command.type = CommandType::SET_FUEL_RESERVE;
+				command.value = FUEL_RESERVE_LOW;
+				out << "[cmdThread]Set " << target << " to state 'low'\n";
+				return true;
 			}
-			else {
-				std::cout << "[cmdThread]Invalid type '" << type << "' for target '" << target << "'.\n";
-				continue;
+			else if (type == "fail") {
+				command.type = CommandType::FUEL_RESERVE_INVALID;
+				out << "[cmdThread]Set " << target << " to state 'invalid'\n";
+				return true;
 			}
-			if (target == "N1_L1") engine.setForcedN1Sensor(0, 0, value);
-			else if (target == "N1_L2") engine.setForcedN1Sensor(0, 1, value);
-			else if (target == "N1_R1") engine.setForcedN1Sensor(1, 0, value);
-			else if (target == "N1_R2") engine.setForcedN1Sensor(1, 1, value);
-			else if (target == "EGT_L1") engine.setForcedEGTSensor(0, 0, value);
-			else if (target == "EGT_L2") engine.setForcedEGTSensor(0, 1, value);
-			else if (target == "EGT_R1") engine.setForcedEGTSensor(1, 0, value);
-			else if (target == "EGT_R2") engine.setForcedEGTSensor(1, 1, value);
 			else {
-				cout << "[cmdThread]Invalid target sensor: " << target << "\n";
-				continue;
+				out << "[cmdThread]Invalid type for FUEL_RES. Use 'low' or 'fail'.\n";
 			}
+			return false;
 		}
-		else if (cmd == "reset") {
-			string name;
-			if (!(iss >> name)) {
-				std::cout << "[cmdThread]Usage: reset NAME\n";
-				continue;
-			}
-			if (name == "N1_L1") engine.resetN1SensorOverride(0, 0);
-			else if (name == "N1_L2") engine.resetN1SensorOverride(0, 1);
-			else if (name == "N1_R1") engine.resetN1SensorOverride(1, 0);
-			else if (name == "N1_R2") engine.resetN1SensorOverride(1, 1);
-			else if (name == "EGT_L1") engine.resetEGTSensorOverride(0, 0);
-			else if (name == "EGT_L2") engine.resetEGTSensorOverride(0, 1);
-			else if (name == "EGT_R1") engine.resetEGTSensorOverride(1, 0);
-			else if (name == "EGT_R2") engine.resetEGTSensorOverride(1, 1);
-			else if (name == "FUEL_RES") {
-				engine.resetFuelReserveOverride();
-				engine.setFuelReserveSensorInvalid(false);
+		else if (target == "FUEL_FLOW") {
+			if (type == "value" && !lvl.empty()) {
+				try {
+					double value_to_set = stod(lvl);
+					command.type = CommandType::SET_FUEL_FLOW;
+					command.value = value_to_set;
+					out << "[cmdThread]Set " << target << " to value " << value_to_set << "\n";
+					return true;
+				}
+				catch (...) {
+					out << "[cmdThread]Invalid value for FUEL_FLOW.\n";
+				}
 			}
-			else if (name == "FUEL_FLOW") {
-				engine.resetForcedFuelFlow();
-				engine.setFuelFlowSensorInvalid(false);
+			else if (type == "fail") {
+				command.type = CommandType::FUEL_FLOW_INVALID;
+				out << "[cmdThread]Set " << target << " to state 'invalid'\n";
+				return true;
 			}
 			else {
-				cout << "[cmdThread]Invalid target to reset: " << name << "\n";
-				continue;
+				out << "[cmdThread]Invalid type for FUEL_FLOW. Use 'value <number>' or 'fail'.\n";
 			}
-			cout << "[cmdThread]Reset " << name << " override\n";
+			return false;
+		}
+		double value;
+		bool is_n1_target = (target.find("N1") != string::npos);
+		bool is_egt_target = (target.find("EGT") != string::npos);
+
+		if (type == "fail") {
+			value = -50; // ʱıֵ
+		}
+		else if (type == "overspeed" && is_n1_target) {
+			if (lvl == "amber") value = 43000.0;
+			else if (lvl == "red") value = 49000.0;
+			else { out << "[cmdThread]Invalid level for overspeed. Use 'amber' or 'red'.\n"; return false; }
+		}
+		else if (type == "overtemp" && is_egt_target) {
+			if (lvl == "amber") value = 960.0;
+			else if (lvl == "red") value = 1110.0;
+			else { out << "[cmdThread]Invalid level for overtemp. Use 'amber' or 'red'.\n"; return false; }
 		}
 		else {
-			std::cout << "[cmdThread]Unknown command. Supported: set, reset\n";
+			out << "[cmdThread]Invalid type '" << type << "' for target '" << target << "'.\n";
+			return false;
+		}
+		SensorTarget sensor;
+		if (!findSensorTarget(target, layout, sensor)) {
+			out << "[cmdThread]Invalid target sensor: " << target << "\n";
+			return false;
+		}
+		command = sensorCommand(sensor, true, value);
+	}
+	else if (cmd == "reset") {
+		string name;
+		if (!(iss >> name)) {
+			out << "[cmdThread]Usage: reset NAME\n";
+			return false;
+		}
+		SensorTarget sensor;
+		if (findSensorTarget(name, layout, sensor)) command = sensorCommand(sensor, false, 0.0);
+		else if (name == "FUEL_RES") command.type = CommandType::RESET_FUEL_RESERVE;
+		else if (name == "FUEL_FLOW") command.type = CommandType::RESET_FUEL_FLOW;
+		else {
+			out << "[cmdThread]Invalid target to reset: " << name << "\n";
+			return false;
+		}
+		out << "[cmdThread]Reset " << name << " override\n";
+	}
+	else {
+		out << "[cmdThread]Unknown command. Supported: start, stop, thrust, set, reset\n";
+		return false;
+	}
+	return true;
+}
+
+template <class Config>
+void applyCommand(const EngineCommand& command, EngineModel<Config>& engine) {
+	switch (command.type) {
+	case CommandType::START: engine.start(); break;
+	case CommandType::STOP: engine.stop(); break;
+	case CommandType::THRUST_UP: engine.increaseThrust(); break;
+	case CommandType::THRUST_DOWN: engine.decreaseThrust(); break;
+	case CommandType::SET_N1_SENSOR: engine.setForcedN1Sensor(command.engine, command.sensor, command.value); break;
+	case CommandType::RESET_N1_SENSOR: engine.resetN1SensorOverride(command.engine, command.sensor); break;
+	case CommandType::SET_EGT_SENSOR: engine.setForcedEGTSensor(command.engine, command.sensor, command.value); break;
+	case CommandType::RESET_EGT_SENSOR: engine.resetEGTSensorOverride(command.engine, command.sensor); break;
+	case CommandType::SET_FUEL_RESERVE: engine.setForcedFuelReserve(command.value); break;
+	case CommandType::FUEL_RESERVE_INVALID: engine.setFuelReserveSensorInvalid(true); break;
+	case CommandType::RESET_FUEL_RESERVE:
+		engine.resetFuelReserveOverride();
+		engine.setFuelReserveSensorInvalid(false);
+		break;
+	case CommandType::SET_FUEL_FLOW: engine.setForcedFuelFlow(command.value); break;
+	case CommandType::FUEL_FLOW_INVALID: engine.setFuelFlowSensorInvalid(true); break;
+	case CommandType::RESET_FUEL_FLOW:
+		engine.resetForcedFuelFlow();
+		engine.setFuelFlowSensorInvalid(false);
+		break;
+	}
+}
+
+#define INSTANTIATE_APPLY_COMMAND(C) template void applyCommand<C>(const EngineCommand&, EngineModel<C>&);
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_APPLY_COMMAND)
+
+string describeCommand(const EngineCommand& command, const EngineLayout& layout) {
+	ostringstream oss;
+	string n1 = sensorTargetName({ false, command.engine, command.sensor }, layout);
+	string egt = sensorTargetName({ true, command.engine, command.sensor }, layout);
+	switch (command.type) {
+	case CommandType::START: oss << "start"; break;
+	case CommandType::STOP: oss << "stop"; break;
+	case CommandType::THRUST_UP: oss << "thrust up"; break;
+	case CommandType::THRUST_DOWN: oss << "thrust down"; break;
+	case CommandType::SET_N1_SENSOR: oss << "set " << n1 << " " << command.value; break;
+	case CommandType::RESET_N1_SENSOR: oss << "reset " << n1; break;
+	case CommandType::SET_EGT_SENSOR: oss << "set " << egt << " " << command.value; break;
+	case CommandType::RESET_EGT_SENSOR: oss << "reset " << egt; break;
+	case CommandType::SET_FUEL_RESERVE: oss << "set FUEL_RES low"; break; // ֻ low/fail
+	case CommandType::FUEL_RESERVE_INVALID: oss << "set FUEL_RES fail"; break;
+	case CommandType::RESET_FUEL_RESERVE: oss << "reset FUEL_RES"; break;
+	case CommandType::SET_FUEL_FLOW: oss << "set FUEL_FLOW value " << command.value; break;
+	case CommandType::FUEL_FLOW_INVALID: oss << "set FUEL_FLOW fail"; break;
+	case CommandType::RESET_FUEL_FLOW: oss << "reset FUEL_FLOW"; break;
+	}
+	return oss.str();
+}
+
+bool executeCommand(const string& line, Engine& engine, ostream& out) {
+	EngineCommand command;
+	if (!parseCommand(line, command, out)) return false;
+	applyCommand(command, engine);
+	return true;
+}
+
+void commandLoop(atomic<bool>& cmdThreadRunning, CommandQueue& commands, const ConsoleHandler& extra, const char* extraUsage) {
+	cout << "[cmdThread]Usage: set <target> <type> [level] | reset <target> | start | stop | thrust up/down\n";
+	cout << "       <target>: N1_L1/N1_L2/N1_R1/N1_R2/EGT_L1/EGT_L2/EGT_R1/EGT_R2/FUEL_RES/FUEL_FLOW\n";
+	cout << "       <type>: fail/overspeed/overtemp/low/value\n";
+	cout << "       Start the engine before entering command.\n";
+	cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX fail(X=1-2)\n";
+	cout << "       e.g., set N1_LX/N1_RX/EGT_LX/EGT_RX overspeed/overtemp amber/red(X=1-2)\n";
+	cout << "       e.g., set FUEL_RES low/fail\n";
+	cout << "       e.g., set FUEL_FLOW fail/value 1000\n";
+	if (extraUsage) cout << extraUsage;
+	string line;
+	while (cmdThreadRunning) {
+		if (!getline(cin, line) || !cmdThreadRunning) {
+			break;
+		}
+		if (extra && extra(line)) continue;
+		EngineCommand command;
+		if (parseCommand(line, command, cout) && !commands.tryPush(command)) {
+			cout << "[cmdThread]Command queue full, command dropped\n";
 		}
 	}
 }
\ No newline at end of file
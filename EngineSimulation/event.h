@@ -3,8 +3,42 @@
 #include <iostream>
 #include <sstream>
 #include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
 #include "engine.h"
+#include "mpsc_queue.h"
 
-void commandLoop(bool& cmdThreadRunning, Engine& engine); // ̨
+// ָĶ¼̨水ťȰָɼ¼ڷ沽ִ֮
+enum class CommandType : uint8_t {
+    START, STOP, THRUST_UP, THRUST_DOWN,
+    SET_N1_SENSOR, RESET_N1_SENSOR,      // engine/sensor ָSET ʱ value Ϊֵ
+    SET_EGT_SENSOR, RESET_EGT_SENSOR,
+    SET_FUEL_RESERVE,                    // value ΪǿƵȼ
+    FUEL_RESERVE_INVALID, RESET_FUEL_RESERVE,
+    SET_FUEL_FLOW,                       // value ΪǿƵȼ
+    FUEL_FLOW_INVALID, RESET_FUEL_FLOW
+};
 
+struct EngineCommand {
+    CommandType type = CommandType::START;
+    int8_t engine = 0;
+    int8_t sensor = 0;
+    double value = 0.0;
+    double appliedAt = -1.0; // Чʱķʱ䣬ִǰΪ
+};
 
+typedef MpscQueue<EngineCommand> CommandQueue;
+
+// һָout Ϊʾɹ trueĿ갴 layout ˫ N1_L1 N1_31  3  1 Ŵ
+bool parseCommand(const std::string& line, EngineCommand& command, std::ostream& out, const EngineLayout& layout = TWIN_LAYOUT);
+// ִһָֻƽ߳еã event.cpp а FOR_EACH_ENGINE_CONFIG ʽʵ
+template <class Config>
+void applyCommand(const EngineCommand& command, EngineModel<Config>& engine);
+std::string describeCommand(const EngineCommand& command, const EngineLayout& layout = TWIN_LAYOUT); // ԭָ֣ "set N1_L1 -50"
+bool executeCommand(const std::string& line, Engine& engine, std::ostream& out); // ִУ̹߳ʹ
+// ̨չָ true ʾѴУָٰ
+typedef std::function<bool(const std::string& line)> ConsoleHandler;
+// ̨Уextra ǿʱȽextraUsage ÷˵
+void commandLoop(std::atomic<bool>& cmdThreadRunning, CommandQueue& commands,
+    const ConsoleHandler& extra = ConsoleHandler(), const char* extraUsage = nullptr);
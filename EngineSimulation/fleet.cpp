@@ -0,0 +1,373 @@
+﻿#include "fleet.h"
+#include "vote.h"
+#include <cmath>
+#include <limits>
+#include <ctime>
+using namespace std;
+
+static const int E = EngineFleet::ENGINES_PER_AIRCRAFT;
+static const int S = EngineFleet::SENSORS_PER_CHANNEL;
+
+EngineFleet::EngineFleet(size_t aircraftCount, uint64_t seed)
+	: seed(seed != 0 ? seed : static_cast<uint64_t>(time(nullptr))), thrustRng(this->seed, 1) {
+	size_t n = aircraftCount;
+	size_t m = aircraftCount * E;
+
+	state.assign(n, static_cast<uint8_t>(EngineState::OFF));
+	startPhaseElapsed.assign(n, 0.0);
+	stopPhaseElapsed.assign(n, 0.0);
+	fuelFlow.assign(n, 0.0);
+	fuelFlowBase.assign(n, 0.0);
+	fuelReserve.assign(n, FUEL_CAPACITY);
+	fuelFlowOverridden.assign(n, 0);
+	fuelReserveSensorInvalid.assign(n, 0);
+	stepActive.assign(n, 0);
+	curveN1.assign(n, 0.0);
+	curveEgt.assign(n, AMBIENT_TEMP);
+	stopFactor.assign(n, 0.0);
+	stableNoiseFuel.assign(n, 0.0);
+
+	n1True.assign(m, 0.0);
+	egtTrue.assign(m, AMBIENT_TEMP);
+	n1Base.assign(m, 0.0);
+	egtBase.assign(m, AMBIENT_TEMP);
+	stableNoiseN1.assign(m, 0.0);
+	stableNoiseEgt.assign(m, 0.0);
+	display.assign(2 * m, 0.0);
+	fill(display.begin() + m, display.end(), AMBIENT_TEMP);
+	displayDisagree.assign(2 * m, 0);
+	for (int s = 0; s < S; ++s) {
+		reading[s].assign(2 * m, 0.0);
+		fill(reading[s].begin() + m, reading[s].end(), AMBIENT_TEMP);
+		n1Sensor[s].assign(m, 0.0);
+		egtSensor[s].assign(m, AMBIENT_TEMP);
+		n1SensorAnomal[s].assign(m, 0);
+		egtSensorAnomal[s].assign(m, 0);
+		n1SensorOverridden[s].assign(m, 0);
+		egtSensorOverridden[s].assign(m, 0);
+		n1SensorOverrideVal[s].assign(m, 0.0);
+		egtSensorOverrideVal[s].assign(m, 0.0);
+		sensorNoiseN1[s].assign(m, 0.0);
+		sensorNoiseEgt[s].assign(m, 0.0);
+	}
+}
+
+// 与 Engine::resetParameters 相同的初始状态
+void EngineFleet::resetAircraft(size_t a) {
+	state[a] = static_cast<uint8_t>(EngineState::OFF);
+	startPhaseElapsed[a] = 0.0;
+	stopPhaseElapsed[a] = 0.0;
+	fuelFlow[a] = 0.0;
+	fuelFlowBase[a] = 0.0;
+	fuelReserve[a] = FUEL_CAPACITY;
+	fuelFlowOverridden[a] = 0;
+	fuelReserveSensorInvalid[a] = 0;
+	for (int e = 0; e < E; ++e) {
+		size_t j = a * E + e;
+		size_t k = egtLane(a, e);
+		n1True[j] = 0.0;
+		egtTrue[j] = AMBIENT_TEMP;
+		n1Base[j] = 0.0;
+		egtBase[j] = AMBIENT_TEMP;
+		display[j] = 0.0;
+		display[k] = AMBIENT_TEMP;
+		displayDisagree[j] = displayDisagree[k] = 0;
+		for (int s = 0; s < S; ++s) {
+			reading[s][j] = 0.0;
+			reading[s][k] = AMBIENT_TEMP;
+			n1Sensor[s][j] = 0.0;
+			egtSensor[s][j] = AMBIENT_TEMP;
+			n1SensorAnomal[s][j] = 0;
+			egtSensorAnomal[s][j] = 0;
+			n1SensorOverridden[s][j] = 0;
+			egtSensorOverridden[s][j] = 0;
+			n1SensorOverrideVal[s][j] = 0.0;
+			egtSensorOverrideVal[s][j] = 0.0;
+		}
+	}
+}
+
+void EngineFleet::start(size_t a) {
+	if (getState(a) != EngineState::OFF) return;
+	resetAircraft(a);
+	state[a] = static_cast<uint8_t>(EngineState::STARTING);
+}
+
+void EngineFleet::startAll() {
+	for (size_t a = 0; a < size(); ++a) start(a);
+}
+
+// 与 Engine::stop 相同：从显示值开始冷却，并释放有效范围内的传感器覆盖
+void EngineFleet::stop(size_t a) {
+	EngineState st = getState(a);
+	if (st == EngineState::STOPPING || st == EngineState::OFF) return;
+
+	for (int e = 0; e < E; ++e) {
+		size_t j = a * E + e;
+		double n1 = getN1(a, e);
+		double egt = getEgt(a, e);
+		if (!isnan(n1)) n1Base[j] = n1;
+		if (!isnan(egt)) egtBase[j] = egt;
+
+		for (int s = 0; s < S; ++s) {
+			double v = n1SensorOverrideVal[s][j] / N1_MAX_RATED;
+			if (n1SensorOverridden[s][j] && !(isnan(v) || v < 0.0 || v > 1.25)) {
+				n1SensorOverridden[s][j] = 0;
+			}
+			v = egtSensorOverrideVal[s][j];
+			if (egtSensorOverridden[s][j] && !(isnan(v) || v < -5.0 || v > 1200.0)) {
+				egtSensorOverridden[s][j] = 0;
+			}
+		}
+	}
+
+	state[a] = static_cast<uint8_t>(EngineState::STOPPING);
+	stopPhaseElapsed[a] = 0.0;
+	fuelFlow[a] = 0.0;
+	fuelFlowOverridden[a] = 0;
+}
+
+// 噪声分布与 Engine 相同；每架飞机每步取 NOISE_BLOCKS 个 Philox 块
+// 块内顺序：燃油，然后每台发动机依次为 N1 稳态、EGT 稳态、各传感器的 N1/EGT
+static const int NOISE_PER_ENGINE = 2 + 2 * S;
+static const int NOISE_BLOCKS = (1 + E * NOISE_PER_ENGINE + 3) / 4;
+
+void EngineFleet::generateNoise() {
+	uint32_t lo = static_cast<uint32_t>(stepIndex), hi = static_cast<uint32_t>(stepIndex >> 32);
+	for (size_t a = 0; a < size(); ++a) {
+		uint32_t r[NOISE_BLOCKS * 4];
+		for (int b = 0; b < NOISE_BLOCKS; ++b) {
+			PhiloxBlock blk = philox4x32(seed, lo, hi, static_cast<uint32_t>(a), static_cast<uint32_t>(b));
+			for (int k = 0; k < 4; ++k) r[b * 4 + k] = blk[k];
+		}
+		stableNoiseFuel[a] = uniformInt(r[0], 101) / 10000.0 - 0.005;
+		for (int e = 0; e < E; ++e) {
+			size_t j = a * E + e;
+			const uint32_t* q = r + 1 + e * NOISE_PER_ENGINE;
+			stableNoiseN1[j] = uniformInt(q[0], 101) / 10000.0 - 0.005;
+			stableNoiseEgt[j] = uniformInt(q[1], 101) / 10000.0 - 0.005;
+			for (int s = 0; s < S; ++s) {
+				sensorNoiseN1[s][j] = uniformInt(q[2 + 2 * s], 201) / 10000.0 - 0.005;
+				sensorNoiseEgt[s][j] = uniformInt(q[3 + 2 * s], 201) / 10000.0 - 0.01;
+			}
+		}
+	}
+	++stepIndex;
+}
+
+void EngineFleet::advance(double dt) {
+	simElapsed += dt;
+	generateNoise();
+
+	const size_t n = size();
+	const size_t m = n * E;
+	const uint8_t OFF = static_cast<uint8_t>(EngineState::OFF);
+	const uint8_t STARTING = static_cast<uint8_t>(EngineState::STARTING);
+	const uint8_t STABLE = static_cast<uint8_t>(EngineState::STABLE);
+	const uint8_t STOPPING = static_cast<uint8_t>(EngineState::STOPPING);
+
+	// 1. 按飞机查阶段曲线
+	for (size_t a = 0; a < n; ++a) {
+		uint8_t st = state[a];
+		stepActive[a] = (st != OFF);
+		if (st == OFF) continue;
+
+		if (fuelReserve[a] < 0.0 || fuelReserve[a] > FUEL_CAPACITY) {
+			fuelReserveSensorInvalid[a] = 1;
+		}
+
+		if (st == STARTING) {
+			startPhaseElapsed[a] += dt;
+			double nVal, vVal, tVal;
+			spool->start(startPhaseElapsed[a], nVal, vVal, tVal);
+			curveN1[a] = min(nVal, N1_MAX_RATED);
+			curveEgt[a] = min(tVal, EGT_MAX);
+			fuelFlow[a] = min(vVal, FUEL_FLOW_MAX);
+		}
+		else if (st == STABLE) {
+			if (!fuelFlowOverridden[a]) {
+				fuelFlow[a] = min(fuelFlowBase[a] * (1.0 + stableNoiseFuel[a]), FUEL_FLOW_MAX);
+			}
+		}
+		else if (st == STOPPING) {
+			stopPhaseElapsed[a] += dt;
+			stopFactor[a] = spool->stopFactor(stopPhaseElapsed[a]);
+		}
+	}
+
+	// 2. 按发动机更新真实值，无分支选择，可向量化
+	{
+		const uint8_t* st = state.data();
+		const double* cN1 = curveN1.data();
+		const double* cEgt = curveEgt.data();
+		const double* fac = stopFactor.data();
+		const double* nb = n1Base.data();
+		const double* eb = egtBase.data();
+		const double* sn = stableNoiseN1.data();
+		const double* se = stableNoiseEgt.data();
+		double* nt = n1True.data();
+		double* et = egtTrue.data();
+		for (size_t j = 0; j < m; ++j) {
+			size_t a = j / E;
+			uint8_t s = st[a];
+			double n1Stable = nb[j] * (1.0 + sn[j]);
+			double egtStable = eb[j] * (1.0 + se[j]);
+			double n1Stop = nb[j] * fac[a];
+			double egtStop = AMBIENT_TEMP + (eb[j] - AMBIENT_TEMP) * fac[a];
+			nt[j] = (s == STARTING) ? cN1[a] : (s == STABLE) ? n1Stable : (s == STOPPING) ? n1Stop : nt[j];
+			et[j] = (s == STARTING) ? cEgt[a] : (s == STABLE) ? egtStable : (s == STOPPING) ? egtStop : et[j];
+		}
+	}
+
+	// 3. 按飞机处理状态转换
+	for (size_t a = 0; a < n; ++a) {
+		size_t j0 = a * E;
+		if (state[a] == STARTING) {
+			bool reached = true;
+			for (int e = 0; e < E; ++e) reached = reached && n1True[j0 + e] >= N1_STABLE_THRESHOLD;
+			if (reached) {
+				state[a] = STABLE;
+				for (int e = 0; e < E; ++e) {
+					n1Base[j0 + e] = n1True[j0 + e];
+					egtBase[j0 + e] = egtTrue[j0 + e];
+				}
+				fuelFlowBase[a] = fuelFlow[a];
+			}
+		}
+		else if (state[a] == STOPPING) {
+			bool spunDown = true;
+			for (int e = 0; e < E; ++e) spunDown = spunDown && n1True[j0 + e] <= 0.5;
+			if (stopPhaseElapsed[a] >= spool->stopDuration() || spunDown) {
+				state[a] = OFF;
+				for (int e = 0; e < E; ++e) {
+					n1True[j0 + e] = 0.0;
+					egtTrue[j0 + e] = AMBIENT_TEMP;
+				}
+				fuelFlow[a] = 0.0;
+			}
+		}
+	}
+
+	// 4. 按发动机、按传感器更新读数与异常标志，可向量化
+	const uint8_t* active = stepActive.data();
+	for (int s = 0; s < S; ++s) {
+		const double* nt = n1True.data();
+		const double* et = egtTrue.data();
+		const double* nNoise = sensorNoiseN1[s].data();
+		const double* eNoise = sensorNoiseEgt[s].data();
+		const uint8_t* nOvr = n1SensorOverridden[s].data();
+		const uint8_t* eOvr = egtSensorOverridden[s].data();
+		const double* nOvrVal = n1SensorOverrideVal[s].data();
+		const double* eOvrVal = egtSensorOverrideVal[s].data();
+		double* ns = n1Sensor[s].data();
+		double* es = egtSensor[s].data();
+		uint8_t* nBad = n1SensorAnomal[s].data();
+		uint8_t* eBad = egtSensorAnomal[s].data();
+		double* nRead = reading[s].data();
+		double* eRead = reading[s].data() + m;
+		for (size_t j = 0; j < m; ++j) {
+			bool on = active[j / E] != 0;
+			double n1v = nOvr[j] ? nOvrVal[j] : nt[j] + nt[j] * nNoise[j];
+			double egtv = eOvr[j] ? eOvrVal[j] : et[j] + et[j] * eNoise[j];
+			ns[j] = on ? n1v : ns[j];
+			es[j] = on ? egtv : es[j];
+			// 写成“不在有效范围内”，NaN 比较结果为 false，自然判为异常
+			double percent = (ns[j] / N1_MAX_RATED) * 100.0;
+			nBad[j] = !(percent >= 0.0 && percent <= 125.0);
+			eBad[j] = !(es[j] >= -5.0 && es[j] <= 1200.0);
+			// 表决用的读数，异常时记为 NaN
+			nRead[j] = nBad[j] ? numeric_limits<double>::quiet_NaN() : ns[j];
+			eRead[j] = eBad[j] ? numeric_limits<double>::quiet_NaN() : es[j];
+		}
+	}
+
+	// 5. 所有发动机的 N1 和 EGT 一次表决
+	const double* rows[S];
+	for (int s = 0; s < S; ++s) rows[s] = reading[s].data();
+	voteMidValue<S>(rows, 2 * m, display.data(), displayDisagree.data());
+
+	// 6. 按飞机消耗燃油，燃油耗尽时停机
+	for (size_t a = 0; a < n; ++a) {
+		if (!stepActive[a] || fuelReserveSensorInvalid[a]) continue;
+		fuelReserve[a] -= fuelFlow[a] * dt;
+		if (fuelReserve[a] <= 0) {
+			fuelReserve[a] = 0;
+			stop(a);
+		}
+	}
+}
+
+void EngineFleet::increaseThrust(size_t a) {
+	if (getState(a) != EngineState::STABLE) return;
+	fuelFlowBase[a] = min(fuelFlowBase[a] + 1.0, FUEL_FLOW_MAX);
+	double increase = 0.03 + uniformInt(thrustRng.next(), 21) / 1000.0; // 3% - 5%
+	for (int e = 0; e < E; ++e) {
+		size_t j = a * E + e;
+		n1Base[j] = min(n1Base[j] * (1.0 + increase), N1_MAX);
+		egtBase[j] = min(egtBase[j] * (1.0 + increase), EGT_MAX);
+	}
+}
+
+void EngineFleet::decreaseThrust(size_t a) {
+	if (getState(a) != EngineState::STABLE) return;
+	fuelFlowBase[a] = max(fuelFlowBase[a] - 1.0, 0.0);
+	double decrease = 0.03 + uniformInt(thrustRng.next(), 21) / 1000.0; // 3% - 5%
+	for (int e = 0; e < E; ++e) {
+		size_t j = a * E + e;
+		n1Base[j] = max(n1Base[j] * (1.0 - decrease), 0.0);
+		egtBase[j] = max(egtBase[j] * (1.0 - decrease), AMBIENT_TEMP);
+	}
+}
+
+// 与 Engine 相同：显示值是每步表决的结果
+double EngineFleet::getN1(size_t a, int e) const { return display[a * E + e]; }
+double EngineFleet::getEgt(size_t a, int e) const { return display[egtLane(a, e)]; }
+
+double EngineFleet::getN1Percentage(size_t a, int e) const {
+	double n1 = getN1(a, e);
+	return isnan(n1) ? numeric_limits<double>::quiet_NaN() : (n1 / N1_MAX_RATED) * 100.0;
+}
+
+double EngineFleet::getFuelFlow(size_t a) const { return fuelFlow[a]; }
+
+double EngineFleet::getFuelReserve(size_t a) const {
+	return fuelReserveSensorInvalid[a] ? numeric_limits<double>::quiet_NaN() : fuelReserve[a];
+}
+
+double EngineFleet::getSensorValue(size_t a, int e, int sensor_type, int s) const {
+	return reading[s][(sensor_type == 0) ? a * E + e : egtLane(a, e)];
+}
+
+bool EngineFleet::isN1SystemFault(size_t a, int e) const {
+	size_t j = a * E + e;
+	for (int s = 0; s < S; ++s) if (!n1SensorAnomal[s][j]) return false;
+	return true;
+}
+
+bool EngineFleet::isEGTSystemFault(size_t a, int e) const {
+	size_t j = a * E + e;
+	for (int s = 0; s < S; ++s) if (!egtSensorAnomal[s][j]) return false;
+	return true;
+}
+
+void EngineFleet::setForcedN1Sensor(size_t a, int e, int s, double v) {
+	if (s < 0 || s >= S) return;
+	n1SensorOverridden[s][a * E + e] = 1;
+	n1SensorOverrideVal[s][a * E + e] = v;
+}
+
+void EngineFleet::resetN1SensorOverride(size_t a, int e, int s) {
+	if (s < 0 || s >= S) return;
+	n1SensorOverridden[s][a * E + e] = 0;
+}
+
+void EngineFleet::setForcedEGTSensor(size_t a, int e, int s, double v) {
+	if (s < 0 || s >= S) return;
+	egtSensorOverridden[s][a * E + e] = 1;
+	egtSensorOverrideVal[s][a * E + e] = v;
+}
+
+void EngineFleet::resetEGTSensorOverride(size_t a, int e, int s) {
+	if (s < 0 || s >= S) return;
+	egtSensorOverridden[s][a * E + e] = 0;
+}
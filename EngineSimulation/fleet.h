@@ -0,0 +1,110 @@
+﻿#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "engine.h"
+#include "rng.h"
+
+// 机队仿真：按字段分列存储（structure-of-arrays），一次 advance 推进所有飞机
+// 每架飞机与 Engine 相同，包含左右两台发动机、共用一套状态机和燃油
+// 发动机列按 [飞机 * 2 + 左右] 排列，飞机列按飞机下标排列
+class EngineFleet {
+public:
+    static const int ENGINES_PER_AIRCRAFT = 2;
+    static const int SENSORS_PER_CHANNEL = 2;
+
+    explicit EngineFleet(size_t aircraftCount, uint64_t seed = 0);
+
+    size_t size() const { return state.size(); }
+
+    // 启动、停止
+    void start(size_t a);
+    void startAll();
+    void stop(size_t a);
+
+    // 固定步长推进所有飞机
+    void advance(double dt);
+
+    // 所有飞机共用的启动/停车曲线，默认为内置曲线；只保存引用，profile 需比机队活得久
+    void setSpoolProfile(const SpoolProfile& profile) { spool = &profile; }
+
+    // 推力调整
+    void increaseThrust(size_t a);
+    void decreaseThrust(size_t a);
+
+    // 读数（与 Engine 的显示值规则一致）
+    EngineState getState(size_t a) const { return static_cast<EngineState>(state[a]); }
+    double getSimTime() const { return simElapsed; }
+    double getN1(size_t a, int e) const;
+    double getEgt(size_t a, int e) const;
+    double getN1Percentage(size_t a, int e) const;
+    double getFuelFlow(size_t a) const;
+    double getFuelReserve(size_t a) const;
+    double getSensorValue(size_t a, int e, int sensor_type, int s) const;
+    bool isN1SystemFault(size_t a, int e) const;
+    bool isEGTSystemFault(size_t a, int e) const;
+    bool isN1Disagree(size_t a, int e) const { return displayDisagree[a * ENGINES_PER_AIRCRAFT + e] != 0; }
+    bool isEGTDisagree(size_t a, int e) const { return displayDisagree[egtLane(a, e)] != 0; }
+
+    // 故障注入
+    void setForcedN1Sensor(size_t a, int e, int s, double v);
+    void resetN1SensorOverride(size_t a, int e, int s);
+    void setForcedEGTSensor(size_t a, int e, int s, double v);
+    void resetEGTSensorOverride(size_t a, int e, int s);
+
+private:
+    void resetAircraft(size_t a);
+    void generateNoise();
+    size_t egtLane(size_t a, int e) const { return (size() + a) * ENGINES_PER_AIRCRAFT + e; }
+
+    double simElapsed = 0.0;
+    const SpoolProfile* spool = &SpoolProfile::builtin();
+
+    // -----飞机列-----
+    std::vector<uint8_t> state;          // EngineState
+    std::vector<double> startPhaseElapsed;
+    std::vector<double> stopPhaseElapsed;
+    std::vector<double> fuelFlow;
+    std::vector<double> fuelFlowBase;
+    std::vector<double> fuelReserve;
+    std::vector<uint8_t> fuelFlowOverridden;
+    std::vector<uint8_t> fuelReserveSensorInvalid;
+    std::vector<uint8_t> stepActive;     // 本步开始时是否处于非 OFF 状态
+
+    // 每步的阶段曲线值（按飞机计算一次，左右发动机共用）
+    std::vector<double> curveN1;
+    std::vector<double> curveEgt;
+    std::vector<double> stopFactor;
+
+    // -----发动机列-----
+    std::vector<double> n1True;
+    std::vector<double> egtTrue;
+    std::vector<double> n1Base;
+    std::vector<double> egtBase;
+    std::vector<double> n1Sensor[SENSORS_PER_CHANNEL];
+    std::vector<double> egtSensor[SENSORS_PER_CHANNEL];
+    std::vector<uint8_t> n1SensorAnomal[SENSORS_PER_CHANNEL];
+    std::vector<uint8_t> egtSensorAnomal[SENSORS_PER_CHANNEL];
+    std::vector<uint8_t> n1SensorOverridden[SENSORS_PER_CHANNEL];
+    std::vector<uint8_t> egtSensorOverridden[SENSORS_PER_CHANNEL];
+    std::vector<double> n1SensorOverrideVal[SENSORS_PER_CHANNEL];
+    std::vector<double> egtSensorOverrideVal[SENSORS_PER_CHANNEL];
+
+    // -----表决列-----
+    // 通道 j < m 为发动机 j 的 N1，m + j 为其 EGT（m 为发动机总数），每步用 voteMidValue 一次表决全部通道
+    std::vector<double> reading[SENSORS_PER_CHANNEL]; // 传感器读数，异常时为 NaN
+    std::vector<double> display;                       // 显示值
+    std::vector<uint8_t> displayDisagree;              // 有效传感器读数不一致
+
+    // 噪声列：每步先批量生成，再由计算循环读取，使计算循环不含函数调用
+    std::vector<double> stableNoiseN1;
+    std::vector<double> stableNoiseEgt;
+    std::vector<double> stableNoiseFuel;
+    std::vector<double> sensorNoiseN1[SENSORS_PER_CHANNEL];
+    std::vector<double> sensorNoiseEgt[SENSORS_PER_CHANNEL];
+
+    // 噪声由 (seed, 步序号, 飞机下标) 唯一确定，与遍历顺序和线程划分无关
+    uint64_t seed;
+    uint64_t stepIndex = 0;
+    PhiloxRng thrustRng;
+};
@@ -0,0 +1,152 @@
+﻿#include "fork.h"
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include "monitor.h"
+#include "alert_rules.h"
+#include "thread_pool.h"
+using namespace std;
+
+namespace {
+	// 每步记录的读数，用于与基线逐步比较
+	struct TracePoint {
+		double n1[2];
+		double egt[2];
+		double fuelReserve;
+	};
+
+	struct BranchRun {
+		ForkOutcome outcome;
+		vector<TracePoint> trace;
+	};
+
+	void runBranch(const vector<uint8_t>& snapshot, const vector<ScenarioEvent>& events, const ForkOptions& options,
+		long long totalSteps, BranchRun& run) {
+		Engine engine(1);
+		engine.setVerbose(false);
+		engine.loadSnapshot(snapshot.data(), snapshot.size());
+		engine.setSpoolProfile(*options.spool);
+		ScenarioPlayer player(events);
+		const AlertProgram& program = defaultAlertProgram();
+		ForkOutcome& outcome = run.outcome;
+		run.trace.resize(static_cast<size_t>(totalSteps));
+
+		EngineSnapshot readings = readEngine(engine);
+		// 分叉时已经命中的规则不算新警报，只记录分叉之后的上升沿
+		uint64_t activeRules = program.evaluate(readings).fired;
+		for (long long i = 0; i < totalSteps; ++i) {
+			double t = i * options.step;
+			player.applyDue(engine, t);
+			engine.advance(options.step);
+
+			readings = readEngine(engine);
+			AlertResult result = program.evaluate(readings);
+			uint64_t onset = result.fired & ~activeRules;
+			activeRules = result.fired;
+			double now = t + options.step;
+			if (onset != 0 && outcome.firstAlertTime < 0.0) {
+				size_t r = 0;
+				while (!((onset >> r) & 1)) ++r;
+				outcome.firstAlertTime = now;
+				outcome.firstAlert = program.message(r);
+			}
+			if (result.shutdown && readings.state != EngineState::STOPPING && readings.state != EngineState::OFF) {
+				if (outcome.shutdownTime < 0.0) {
+					outcome.shutdownTime = now;
+					for (size_t r = 0; r < program.size(); ++r) {
+						if (((result.fired >> r) & 1) && program.shutdown(r)) {
+							outcome.shutdownRule = program.message(r);
+							break;
+						}
+					}
+				}
+				engine.stop();
+			}
+
+			TracePoint& p = run.trace[static_cast<size_t>(i)];
+			for (int e = 0; e < 2; ++e) {
+				p.n1[e] = readings.n1[e];
+				p.egt[e] = readings.egt[e];
+			}
+			p.fuelReserve = readings.fuelReserve;
+		}
+
+		for (int e = 0; e < 2; ++e) {
+			outcome.n1[e] = readings.n1[e];
+			outcome.egt[e] = readings.egt[e];
+		}
+		outcome.fuelReserve = readings.fuelReserve;
+		outcome.finalState = readings.state;
+	}
+
+	// |a - b| 的最大值，任一边为 NaN（传感器异常）的点不计
+	void accumulate(double& maxDiff, double a, double b) {
+		double d = fabs(a - b);
+		if (!isnan(d)) maxDiff = max(maxDiff, d);
+	}
+
+	const char* stateName(EngineState state) {
+		switch (state) {
+		case EngineState::OFF: return "OFF";
+		case EngineState::STARTING: return "STARTING";
+		case EngineState::STABLE: return "STABLE";
+		case EngineState::STOPPING: return "STOPPING";
+		}
+		return "?";
+	}
+}
+
+vector<ForkOutcome> runForks(const vector<uint8_t>& snapshot, const vector<ScenarioCase>& branches, const ForkOptions& options) {
+	Engine probe(1);
+	if (!probe.loadSnapshot(snapshot.data(), snapshot.size())) return {};
+
+	long long totalSteps = static_cast<long long>(options.duration / options.step + 0.5);
+	vector<BranchRun> runs(branches.size() + 1);
+	runs[0].outcome.name = "baseline";
+	static const vector<ScenarioEvent> noEvents;
+	{
+		// 每个分支只写自己的结果槽
+		WorkStealingPool pool(options.threads);
+		for (size_t b = 0; b < runs.size(); ++b) {
+			if (b > 0) runs[b].outcome.name = branches[b - 1].name;
+			const vector<ScenarioEvent>& events = (b == 0) ? noEvents : branches[b - 1].events;
+			pool.submit([&, b] { runBranch(snapshot, events, options, totalSteps, runs[b]); });
+		}
+		pool.wait();
+	}
+
+	const vector<TracePoint>& base = runs[0].trace;
+	vector<ForkOutcome> outcomes;
+	outcomes.reserve(runs.size());
+	for (BranchRun& run : runs) {
+		ForkOutcome& outcome = run.outcome;
+		for (size_t i = 0; i < run.trace.size(); ++i) {
+			const TracePoint& p = run.trace[i];
+			for (int e = 0; e < 2; ++e) {
+				accumulate(outcome.maxN1Divergence, p.n1[e], base[i].n1[e]);
+				accumulate(outcome.maxEgtDivergence, p.egt[e], base[i].egt[e]);
+			}
+			accumulate(outcome.maxFuelDivergence, p.fuelReserve, base[i].fuelReserve);
+		}
+		outcomes.push_back(move(outcome));
+	}
+	return outcomes;
+}
+
+void printForkReport(const vector<ForkOutcome>& outcomes, ostream& out, const char* prefix) {
+	ios::fmtflags flags = out.flags();
+	streamsize precision = out.precision();
+	out << fixed << setprecision(1);
+	out << prefix << left << setw(20) << "Branch" << right << setw(10) << "MaxdN1" << setw(10) << "MaxdEGT"
+		<< setw(10) << "MaxdFuel" << setw(10) << "State" << "  First alert / shutdown rule\n";
+	for (const ForkOutcome& o : outcomes) {
+		out << prefix << left << setw(20) << o.name << right << setw(10) << o.maxN1Divergence << setw(10) << o.maxEgtDivergence
+			<< setw(10) << o.maxFuelDivergence << setw(10) << stateName(o.finalState) << "  ";
+		if (o.firstAlertTime >= 0.0) out << o.firstAlertTime << " s " << o.firstAlert;
+		else out << "-";
+		if (o.shutdownTime >= 0.0) out << " / " << o.shutdownTime << " s " << o.shutdownRule;
+		out << "\n";
+	}
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "engine.h"
+#include "scenario.h"
+
+// 分叉实验：把当前发动机复制成 K 份，每份按自己的剧本注入故障或推力变化，在线程池上并行推进
+// 所有分支和一条不注入任何指令的基线共用同一个快照和随机数位置，差异只来自剧本
+// 剧本时间从分叉时刻算起；分支请求停机时与界面一样执行 stop，之后继续推进到时长结束
+struct ForkOptions {
+    double duration = 60.0; // 每个分支推进的仿真时长（秒）
+    double step = 0.005;
+    unsigned threads = 0;   // 0 表示硬件线程数
+    const SpoolProfile* spool = &SpoolProfile::builtin(); // 快照不含曲线，须与被分叉的发动机一致
+};
+
+struct ForkOutcome {
+    std::string name;
+    double maxN1Divergence = 0.0;  // 与基线相比 N1 显示值的最大偏差（两台发动机中较大者，NaN 不计）
+    double maxEgtDivergence = 0.0;
+    double maxFuelDivergence = 0.0; // 燃油余量的最大偏差
+    double n1[2] = { 0.0, 0.0 };    // 结束时的读数
+    double egt[2] = { 0.0, 0.0 };
+    double fuelReserve = 0.0;
+    EngineState finalState = EngineState::OFF;
+    double shutdownTime = -1.0;     // 首次请求停机的时间，未停机为负
+    std::string shutdownRule;       // 请求停机的规则中编号最小的一条
+    double firstAlertTime = -1.0;   // 首个警报（规则命中的上升沿）的时间，无警报为负
+    std::string firstAlert;
+};
+
+// 按 options 推进基线和每个分支；结果第 0 项为基线，其余与 branches 一一对应
+// snapshot 由 Engine::saveSnapshot 生成，格式不对时返回空结果
+std::vector<ForkOutcome> runForks(const std::vector<uint8_t>& snapshot, const std::vector<ScenarioCase>& branches,
+    const ForkOptions& options);
+
+// 每个分支一行：偏差、结束状态、首个警报和首个停机规则
+void printForkReport(const std::vector<ForkOutcome>& outcomes, std::ostream& out, const char* prefix);
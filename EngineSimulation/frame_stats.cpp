@@ -0,0 +1,112 @@
+﻿#include "frame_stats.h"
+#include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+static int highestBit(uint64_t x) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return static_cast<int>(index);
+#else
+	return 63 - __builtin_clzll(x);
+#endif
+}
+
+// 小于 SUB_BUCKETS 的值每个值一格；其余按最高位分段，段内取最高位之后的 SUB_BUCKET_BITS 位
+int LatencyHistogram::bucketIndex(uint64_t value) {
+	if (value < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(value);
+	int exponent = highestBit(value) - SUB_BUCKET_BITS;
+	if (exponent > MAX_EXPONENT) return BUCKET_COUNT - 1;
+	int sub = static_cast<int>(value >> exponent) - SUB_BUCKETS;
+	return SUB_BUCKETS * (exponent + 1) + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+	if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+	int exponent = index / SUB_BUCKETS - 1;
+	uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS);
+	return ((sub + 1) << exponent) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+	counts[bucketIndex(nanoseconds)].fetch_add(1, memory_order_relaxed);
+	total.fetch_add(1, memory_order_relaxed);
+	sum.fetch_add(nanoseconds, memory_order_relaxed);
+	uint64_t seen = maxValue.load(memory_order_relaxed);
+	while (nanoseconds > seen && !maxValue.compare_exchange_weak(seen, nanoseconds, memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::reset() {
+	for (auto& c : counts) c.store(0, memory_order_relaxed);
+	total.store(0, memory_order_relaxed);
+	sum.store(0, memory_order_relaxed);
+	maxValue.store(0, memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+	uint64_t n = count();
+	return n ? static_cast<double>(sum.load(memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+	// 按各格计数重新求和，不依赖与写入并发的 total
+	uint64_t n = 0;
+	for (const auto& c : counts) n += c.load(memory_order_relaxed);
+	if (n == 0) return 0;
+	uint64_t rank = static_cast<uint64_t>(p / 100.0 * n + 0.5);
+	if (rank < 1) rank = 1;
+	if (rank > n) rank = n;
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i) {
+		seen += counts[i].load(memory_order_relaxed);
+		if (seen >= rank) return min(bucketUpperBound(i), maximum());
+	}
+	return maximum();
+}
+
+const char* framePhaseName(FramePhase phase) {
+	switch (phase) {
+	case PHASE_SIM_STEP: return "sim step";
+	case PHASE_LOGGING: return "  logging";
+	case PHASE_SIM_BATCH: return "sim batch";
+	case PHASE_FRAME_READ: return "frame read";
+	case PHASE_UPDATE_INDICATORS: return "updateIndicators";
+	case PHASE_DRAW_UI: return "drawUI";
+	case PHASE_MESSAGES: return "messages";
+	case PHASE_SLEEP: return "sleep";
+	case PHASE_FRAME: return "frame";
+	default: return "?";
+	}
+}
+
+void FrameStats::record(FramePhase phase, chrono::steady_clock::duration elapsed) {
+	long long ns = chrono::duration_cast<chrono::nanoseconds>(elapsed).count();
+	histograms[phase].record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+void FrameStats::reset() {
+	for (auto& h : histograms) h.reset();
+	clampedFrames.store(0, memory_order_relaxed);
+}
+
+void FrameStats::report(ostream& out, const char* prefix) const {
+	ios::fmtflags flags = out.flags();
+	streamsize precision = out.precision();
+	out << fixed << setprecision(1);
+	out << prefix << left << setw(18) << "Phase (us)" << right << setw(10) << "Count" << setw(10) << "Mean"
+		<< setw(10) << "p50" << setw(10) << "p99" << setw(10) << "Max" << "\n";
+	for (int p = 0; p < PHASE_COUNT; ++p) {
+		const LatencyHistogram& h = histograms[p];
+		if (h.count() == 0) continue;
+		out << prefix << left << setw(18) << framePhaseName(static_cast<FramePhase>(p)) << right << setw(10) << h.count()
+			<< setw(10) << h.mean() / 1000.0 << setw(10) << h.percentile(50) / 1000.0
+			<< setw(10) << h.percentile(99) / 1000.0 << setw(10) << h.maximum() / 1000.0 << "\n";
+	}
+	out << prefix << "Frames with frameDt clamped to 0.05 s: " << getClampedFrames() << "\n";
+	out.flags(flags);
+	out.precision(precision);
+}
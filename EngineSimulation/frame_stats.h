@@ -0,0 +1,84 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// HDR 风格的耗时直方图：纳秒值按 2 的幂分段，每段再线性分 32 格，相对误差约 3%
+// 记录只做一次原子加，可以在热路径上调用；读取时不加锁，与写入并发时结果是近似值
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAX_EXPONENT = 36;  // 2^41 ns 约 36 分钟，更大的值计入最后一格
+    static const int BUCKET_COUNT = SUB_BUCKETS * (MAX_EXPONENT + 2);
+
+    void record(uint64_t nanoseconds);
+    void reset();
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t maximum() const { return maxValue.load(std::memory_order_relaxed); }
+    double mean() const; // 纳秒
+    uint64_t percentile(double p) const; // p 为 0..100，返回所在格的上界（纳秒），无记录时为 0
+
+private:
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+    std::atomic<uint64_t> counts[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> maxValue{ 0 };
+};
+
+// 主循环和仿真线程各阶段的耗时
+enum FramePhase : uint8_t {
+    PHASE_SIM_STEP,        // 仿真线程：一步（指令、推进、告警判定、写日志）
+    PHASE_LOGGING,         // 仿真线程：一步中写日志的部分
+    PHASE_SIM_BATCH,       // 仿真线程：一次追赶的所有步
+    PHASE_FRAME_READ,      // 界面线程：取快照、回放读数、控制台回报
+    PHASE_UPDATE_INDICATORS,
+    PHASE_DRAW_UI,
+    PHASE_MESSAGES,        // 鼠标/按键消息处理
+    PHASE_SLEEP,
+    PHASE_FRAME,           // 界面线程：整帧
+    PHASE_COUNT
+};
+
+const char* framePhaseName(FramePhase phase);
+
+// 各阶段直方图和 frameDt 被 0.05 s 上限截断的帧数；界面线程、仿真线程写，控制台线程读
+class FrameStats {
+public:
+    void record(FramePhase phase, std::chrono::steady_clock::duration elapsed);
+    void countClampedFrame() { clampedFrames.fetch_add(1, std::memory_order_relaxed); }
+    void reset();
+
+    const LatencyHistogram& phase(FramePhase p) const { return histograms[p]; }
+    uint64_t getClampedFrames() const { return clampedFrames.load(std::memory_order_relaxed); }
+
+    // 每个阶段一行：次数、均值、p50、p99、最大值（微秒）
+    void report(std::ostream& out, const char* prefix) const;
+
+private:
+    LatencyHistogram histograms[PHASE_COUNT];
+    std::atomic<uint64_t> clampedFrames{ 0 };
+};
+
+// 顺序阶段计时：每次 lap 记录从上一次 lap（或构造）到现在的耗时；stats 为空时不计时
+class PhaseTimer {
+public:
+    explicit PhaseTimer(FrameStats* stats) : stats(stats) {
+        if (stats) last = std::chrono::steady_clock::now();
+    }
+    void lap(FramePhase phase) {
+        if (!stats) return;
+        auto now = std::chrono::steady_clock::now();
+        stats->record(phase, now - last);
+        last = now;
+    }
+
+private:
+    FrameStats* stats;
+    std::chrono::steady_clock::time_point last;
+};
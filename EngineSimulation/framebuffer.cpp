@@ -0,0 +1,326 @@
+﻿#include "framebuffer.h"
+#include <cmath>
+#include <fstream>
+#include <cstring>
+using namespace std;
+
+static const double TWO_PI = 6.283185307179586;
+
+// 5x7 点阵字体，ASCII 0x20-0x7E，每个字符 5 列，每列低位在上，第 7 位用于下行笔画
+static const uint8_t FONT_5X7[95][5] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 },
+	{ 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x08, 0x07, 0x03, 0x00 },
+	{ 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },
+	{ 0x00, 0x80, 0x70, 0x30, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x00, 0x60, 0x60, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 },
+	{ 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, { 0x72, 0x49, 0x49, 0x49, 0x46 }, { 0x21, 0x41, 0x49, 0x4D, 0x33 },
+	{ 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, { 0x41, 0x21, 0x11, 0x09, 0x07 },
+	{ 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x46, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x00, 0x14, 0x00, 0x00 }, { 0x00, 0x40, 0x34, 0x00, 0x00 },
+	{ 0x00, 0x08, 0x14, 0x22, 0x41 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x59, 0x09, 0x06 },
+	{ 0x3E, 0x41, 0x5D, 0x59, 0x4E }, { 0x7C, 0x12, 0x11, 0x12, 0x7C }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },
+	{ 0x7F, 0x41, 0x41, 0x41, 0x3E }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 }, { 0x3E, 0x41, 0x41, 0x51, 0x73 },
+	{ 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 },
+	{ 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x1C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },
+	{ 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x26, 0x49, 0x49, 0x49, 0x32 },
+	{ 0x03, 0x01, 0x7F, 0x01, 0x03 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F },
+	{ 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x03, 0x04, 0x78, 0x04, 0x03 }, { 0x61, 0x59, 0x49, 0x4D, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x41 },
+	{ 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x41, 0x7F }, { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 },
+	{ 0x00, 0x03, 0x07, 0x08, 0x00 }, { 0x20, 0x54, 0x54, 0x78, 0x40 }, { 0x7F, 0x28, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x28 },
+	{ 0x38, 0x44, 0x44, 0x28, 0x7F }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x00, 0x08, 0x7E, 0x09, 0x02 }, { 0x18, 0xA4, 0xA4, 0x9C, 0x78 },
+	{ 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, { 0x20, 0x40, 0x40, 0x3D, 0x00 }, { 0x7F, 0x10, 0x28, 0x44, 0x00 },
+	{ 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x78, 0x04, 0x78 }, { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 },
+	{ 0xFC, 0x18, 0x24, 0x24, 0x18 }, { 0x18, 0x24, 0x24, 0x18, 0xFC }, { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x24 },
+	{ 0x04, 0x04, 0x3F, 0x44, 0x24 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, { 0x1C, 0x20, 0x40, 0x20, 0x1C }, { 0x3C, 0x40, 0x30, 0x40, 0x3C },
+	{ 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x4C, 0x90, 0x90, 0x90, 0x7C }, { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 },
+	{ 0x00, 0x00, 0x77, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x02, 0x01, 0x02, 0x04, 0x02 },
+};
+
+// 字符格高 10 个点（上下各留 1 点），宽 6 个点（字间留 1 点），按字高缩放
+static const int GLYPH_CELL_ROWS = 10;
+static const int GLYPH_CELL_COLUMNS = 6;
+static const double GLYPH_ASPECT = 0.8; // 横向再压窄，字宽约为字高的一半，与 Consolas 接近
+
+FramebufferRenderer::FramebufferRenderer(int width, int height, COLORREF background)
+	: w(width), h(height), background(background), rgba(static_cast<size_t>(width) * height * 4) {
+	clear();
+	present();
+}
+
+COLORREF FramebufferRenderer::pixel(int x, int y) const {
+	const uint8_t* p = &rgba[(static_cast<size_t>(y) * w + x) * 4];
+	return makeColor(p[0], p[1], p[2]);
+}
+
+void FramebufferRenderer::putPixel(int x, int y, COLORREF color) {
+	if (x < 0 || y < 0 || x >= w || y >= h) return;
+	uint8_t* p = &rgba[(static_cast<size_t>(y) * w + x) * 4];
+	p[0] = static_cast<uint8_t>(color & 0xFF);
+	p[1] = static_cast<uint8_t>((color >> 8) & 0xFF);
+	p[2] = static_cast<uint8_t>((color >> 16) & 0xFF);
+	p[3] = 0xFF;
+}
+
+void FramebufferRenderer::fillSpan(int y, int x0, int x1, COLORREF color) {
+	if (y < 0 || y >= h) return;
+	x0 = max(x0, 0);
+	x1 = min(x1, w - 1);
+	for (int x = x0; x <= x1; ++x) putPixel(x, y, color);
+}
+
+void FramebufferRenderer::drawLine(int x0, int y0, int x1, int y1, COLORREF color) {
+	markDirty(min(x0, x1), min(y0, y1), max(x0, x1), max(y0, y1));
+	// Bresenham
+	int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+	int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+	int err = dx + dy;
+	while (true) {
+		putPixel(x0, y0, color);
+		if (x0 == x1 && y0 == y1) break;
+		int e2 = 2 * err;
+		if (e2 >= dy) { err += dy; x0 += sx; }
+		if (e2 <= dx) { err += dx; y0 += sy; }
+	}
+}
+
+void FramebufferRenderer::setTextStyle(int height, const wchar_t*) {
+	textSize = max(height, 1);
+}
+
+void FramebufferRenderer::rectangle(int left, int top, int right, int bottom) {
+	drawLine(left, top, right, top, lineColor);
+	drawLine(right, top, right, bottom, lineColor);
+	drawLine(right, bottom, left, bottom, lineColor);
+	drawLine(left, bottom, left, top, lineColor);
+	markDirty(left, top, right, bottom);
+}
+
+void FramebufferRenderer::solidRectangle(int left, int top, int right, int bottom) {
+	for (int y = top; y <= bottom; ++y) fillSpan(y, left, right, fillColor);
+	markDirty(left, top, right, bottom);
+}
+
+// 扇形：外接矩形内的椭圆，从 startAngle 逆时针到 endAngle（屏幕 y 向下，角度按向上为正计算）
+void FramebufferRenderer::rasterizePie(int left, int top, int right, int bottom, double startAngle, double endAngle, bool outline) {
+	double cx = (left + right) / 2.0, cy = (top + bottom) / 2.0;
+	double rx = (right - left) / 2.0, ry = (bottom - top) / 2.0;
+	if (rx <= 0.0 || ry <= 0.0) return;
+	double span = fmod(endAngle - startAngle, TWO_PI);
+	if (span <= 0.0) span += TWO_PI; // 起止相同时画整圆
+
+	auto inEllipse = [&](double x, double y, double ax, double ay) {
+		double dx = (x - cx) / ax, dy = (y - cy) / ay;
+		return dx * dx + dy * dy <= 1.0;
+	};
+	auto inSweep = [&](double x, double y) {
+		double a = fmod(atan2(cy - y, x - cx) - startAngle, TWO_PI);
+		if (a < 0.0) a += TWO_PI;
+		return a <= span;
+	};
+
+	for (int y = top; y <= bottom; ++y) {
+		for (int x = left; x <= right; ++x) {
+			if (!inEllipse(x, y, rx, ry) || !inSweep(x, y)) continue;
+			if (!outline) putPixel(x, y, fillColor);
+			else if (rx <= 1.0 || ry <= 1.0 || !inEllipse(x, y, rx - 1.0, ry - 1.0)) putPixel(x, y, lineColor);
+		}
+	}
+	if (outline) {
+		int sx = static_cast<int>(lround(cx + rx * cos(startAngle))), sy = static_cast<int>(lround(cy - ry * sin(startAngle)));
+		int ex = static_cast<int>(lround(cx + rx * cos(endAngle))), ey = static_cast<int>(lround(cy - ry * sin(endAngle)));
+		int icx = static_cast<int>(lround(cx)), icy = static_cast<int>(lround(cy));
+		drawLine(icx, icy, sx, sy, lineColor);
+		drawLine(icx, icy, ex, ey, lineColor);
+	}
+	markDirty(left, top, right, bottom);
+}
+
+void FramebufferRenderer::pie(int left, int top, int right, int bottom, double startAngle, double endAngle) {
+	rasterizePie(left, top, right, bottom, startAngle, endAngle, true);
+}
+
+void FramebufferRenderer::solidPie(int left, int top, int right, int bottom, double startAngle, double endAngle) {
+	rasterizePie(left, top, right, bottom, startAngle, endAngle, false);
+}
+
+void FramebufferRenderer::fillPolygon(const RenderPoint* points, int count) {
+	if (count < 3) return;
+	int minY = points[0].y, maxY = points[0].y;
+	for (int i = 1; i < count; ++i) {
+		minY = min(minY, points[i].y);
+		maxY = max(maxY, points[i].y);
+	}
+	// 扫描线：在像素中心高度求与各边的交点，成对填充
+	vector<double> xs;
+	for (int y = minY; y <= maxY; ++y) {
+		double sy = y + 0.5;
+		xs.clear();
+		for (int i = 0; i < count; ++i) {
+			const RenderPoint& a = points[i];
+			const RenderPoint& b = points[(i + 1) % count];
+			if ((a.y <= sy && b.y > sy) || (b.y <= sy && a.y > sy)) {
+				xs.push_back(a.x + (sy - a.y) * (b.x - a.x) / static_cast<double>(b.y - a.y));
+			}
+		}
+		sort(xs.begin(), xs.end());
+		for (size_t i = 0; i + 1 < xs.size(); i += 2) {
+			fillSpan(y, static_cast<int>(ceil(xs[i] - 0.5)), static_cast<int>(floor(xs[i + 1] - 0.5)), fillColor);
+		}
+	}
+	for (int i = 0; i < count; ++i) {
+		const RenderPoint& a = points[i];
+		const RenderPoint& b = points[(i + 1) % count];
+		drawLine(a.x, a.y, b.x, b.y, lineColor);
+	}
+}
+
+void FramebufferRenderer::outText(int x, int y, const wchar_t* text) {
+	double scale = static_cast<double>(textSize) / GLYPH_CELL_ROWS;
+	double xScale = scale * GLYPH_ASPECT;
+	int advance = static_cast<int>(lround(GLYPH_CELL_COLUMNS * xScale));
+	int glyphWidth = static_cast<int>(ceil(5 * xScale));
+	int cx = x;
+	for (const wchar_t* c = text; *c; ++c, cx += advance) {
+		wchar_t ch = (*c >= 0x20 && *c <= 0x7E) ? *c : L'?';
+		const uint8_t* glyph = FONT_5X7[ch - 0x20];
+		for (int py = 0; py < textSize; ++py) {
+			int row = static_cast<int>(py / scale) - 1;
+			if (row < 0 || row > 7) continue;
+			for (int px = 0; px < glyphWidth; ++px) {
+				int col = static_cast<int>(px / xScale);
+				if (col < 5 && ((glyph[col] >> row) & 1)) putPixel(cx + px, y + py, textColor);
+			}
+		}
+	}
+	markDirty(x, y, cx - 1, y + textSize - 1);
+}
+
+int FramebufferRenderer::textWidth(const wchar_t* text) {
+	double scale = static_cast<double>(textSize) / GLYPH_CELL_ROWS;
+	return static_cast<int>(wcslen(text)) * static_cast<int>(lround(GLYPH_CELL_COLUMNS * scale * GLYPH_ASPECT));
+}
+
+int FramebufferRenderer::textHeight(const wchar_t*) {
+	return textSize;
+}
+
+void FramebufferRenderer::clear() {
+	clearRect({ 0, 0, w - 1, h - 1 });
+}
+
+void FramebufferRenderer::clearRect(const RenderRect& rect) {
+	for (int y = rect.top; y <= rect.bottom; ++y) fillSpan(y, rect.left, rect.right, background);
+	markDirty(rect.left, rect.top, rect.right, rect.bottom);
+}
+
+void FramebufferRenderer::present() {
+	presented = dirtyRect();
+	if (!presented.empty()) {
+		presentedPixels += static_cast<uint64_t>(presented.right - presented.left + 1) * (presented.bottom - presented.top + 1);
+	}
+	clearDirty();
+}
+
+bool FramebufferRenderer::save(const string& path) const {
+	size_t dot = path.find_last_of('.');
+	string ext = (dot == string::npos) ? "" : path.substr(dot);
+	for (char& c : ext) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	return ext == ".png" ? writePNG(path) : writePPM(path);
+}
+
+bool FramebufferRenderer::writePPM(const string& path) const {
+	ofstream out(path, ios::binary);
+	if (!out.is_open()) return false;
+	out << "P6\n" << w << " " << h << "\n255\n";
+	vector<char> row(static_cast<size_t>(w) * 3);
+	for (int y = 0; y < h; ++y) {
+		const uint8_t* p = &rgba[static_cast<size_t>(y) * w * 4];
+		for (int x = 0; x < w; ++x) {
+			row[x * 3] = static_cast<char>(p[x * 4]);
+			row[x * 3 + 1] = static_cast<char>(p[x * 4 + 1]);
+			row[x * 3 + 2] = static_cast<char>(p[x * 4 + 2]);
+		}
+		out.write(row.data(), static_cast<streamsize>(row.size()));
+	}
+	return static_cast<bool>(out);
+}
+
+// -----PNG-----
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+	static uint32_t table[256];
+	static bool ready = false;
+	if (!ready) {
+		for (uint32_t n = 0; n < 256; ++n) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		}
+		ready = true;
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void putBigEndian(vector<uint8_t>& out, uint32_t v) {
+	out.push_back(static_cast<uint8_t>(v >> 24));
+	out.push_back(static_cast<uint8_t>(v >> 16));
+	out.push_back(static_cast<uint8_t>(v >> 8));
+	out.push_back(static_cast<uint8_t>(v));
+}
+
+static void writeChunk(ofstream& out, const char type[4], const vector<uint8_t>& data) {
+	vector<uint8_t> chunk;
+	chunk.reserve(data.size() + 12);
+	putBigEndian(chunk, static_cast<uint32_t>(data.size()));
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	putBigEndian(chunk, crc32Update(0, chunk.data() + 4, chunk.size() - 4));
+	out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<streamsize>(chunk.size()));
+}
+
+bool FramebufferRenderer::writePNG(const string& path) const {
+	ofstream out(path, ios::binary);
+	if (!out.is_open()) return false;
+	static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	out.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+
+	vector<uint8_t> header;
+	putBigEndian(header, static_cast<uint32_t>(w));
+	putBigEndian(header, static_cast<uint32_t>(h));
+	header.push_back(8); // 位深
+	header.push_back(6); // RGBA
+	header.push_back(0); // deflate
+	header.push_back(0); // 自适应滤波
+	header.push_back(0); // 不隔行
+	writeChunk(out, "IHDR", header);
+
+	// 每行前加滤波类型 0，整体按不压缩的 deflate 块存放，外面套 zlib 头和 Adler-32
+	size_t rowBytes = static_cast<size_t>(w) * 4 + 1;
+	vector<uint8_t> raw(rowBytes * h);
+	for (int y = 0; y < h; ++y) {
+		raw[y * rowBytes] = 0;
+		memcpy(&raw[y * rowBytes + 1], &rgba[static_cast<size_t>(y) * w * 4], static_cast<size_t>(w) * 4);
+	}
+	vector<uint8_t> zlib = { 0x78, 0x01 };
+	zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+	for (size_t at = 0; at < raw.size() || raw.empty(); ) {
+		size_t n = min<size_t>(65535, raw.size() - at);
+		bool last = (at + n == raw.size());
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(static_cast<uint8_t>(n));
+		zlib.push_back(static_cast<uint8_t>(n >> 8));
+		zlib.push_back(static_cast<uint8_t>(~n));
+		zlib.push_back(static_cast<uint8_t>(~n >> 8));
+		zlib.insert(zlib.end(), raw.begin() + at, raw.begin() + at + n);
+		at += n;
+		if (last) break;
+	}
+	uint32_t a = 1, b = 0;
+	for (uint8_t v : raw) {
+		a = (a + v) % 65521;
+		b = (b + a) % 65521;
+	}
+	putBigEndian(zlib, (b << 16) | a);
+	writeChunk(out, "IDAT", zlib);
+	writeChunk(out, "IEND", {});
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "render.h"
+
+// 纯软件 RGBA 帧缓冲：不依赖图形库，可以在无界面的机器上生成截图做回归比较
+// 文字用内置 5x7 点阵字体按字高缩放，所有字体名都画成同一种等宽字体
+class FramebufferRenderer : public Renderer {
+public:
+    FramebufferRenderer(int width, int height, COLORREF background = COLOR_BLACK);
+
+    int width() const override { return w; }
+    int height() const override { return h; }
+
+    void setLineColor(COLORREF color) override { lineColor = color; }
+    void setFillColor(COLORREF color) override { fillColor = color; }
+    void setTextColor(COLORREF color) override { textColor = color; }
+    void setTextStyle(int height, const wchar_t* face) override;
+
+    void rectangle(int left, int top, int right, int bottom) override;
+    void solidRectangle(int left, int top, int right, int bottom) override;
+    void pie(int left, int top, int right, int bottom, double startAngle, double endAngle) override;
+    void solidPie(int left, int top, int right, int bottom, double startAngle, double endAngle) override;
+    void fillPolygon(const RenderPoint* points, int count) override;
+    void outText(int x, int y, const wchar_t* text) override;
+    int textWidth(const wchar_t* text) override;
+    int textHeight(const wchar_t* text) override;
+
+    void clear() override;
+    void clearRect(const RenderRect& rect) override;
+    void present() override;
+
+    // 最近一次 present 时的脏区域和累计重画的像素数，用于确认只重画了变化的部件
+    const RenderRect& presentedRect() const { return presented; }
+    uint64_t getPresentedPixels() const { return presentedPixels; }
+
+    const std::vector<uint8_t>& pixels() const { return rgba; } // 按行存放，每像素 R、G、B、A
+    COLORREF pixel(int x, int y) const;
+
+    // 按扩展名选择格式：.png 写 PNG（不压缩的 deflate 块），其他写二进制 PPM (P6)
+    bool save(const std::string& path) const;
+    bool writePPM(const std::string& path) const;
+    bool writePNG(const std::string& path) const;
+
+private:
+    void putPixel(int x, int y, COLORREF color);
+    void fillSpan(int y, int x0, int x1, COLORREF color);
+    void drawLine(int x0, int y0, int x1, int y1, COLORREF color);
+    void rasterizePie(int left, int top, int right, int bottom, double startAngle, double endAngle, bool outline);
+
+    int w, h;
+    COLORREF background;
+    COLORREF lineColor = COLOR_WHITE;
+    COLORREF fillColor = COLOR_WHITE;
+    COLORREF textColor = COLOR_WHITE;
+    int textSize = 16;
+    std::vector<uint8_t> rgba;
+    RenderRect presented = EMPTY_RECT;
+    uint64_t presentedPixels = 0;
+};
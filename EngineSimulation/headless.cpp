@@ -0,0 +1,514 @@
+﻿// 无界面批量运行：不依赖 EasyX/Windows，按固定步长尽可能快地推进仿真并写出 CSV
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <algorithm>
+#include "engine.h"
+#include "log.h"
+#include "async_log.h"
+#include "fleet.h"
+#include "monitor.h"
+#include "alert_rules.h"
+#include "scenario.h"
+#include "checkpoint.h"
+#include "fork.h"
+#include "sim_thread.h"
+#include "ui.h"
+#include "ui_draw.h"
+#include "framebuffer.h"
+using namespace std;
+
+struct HeadlessOptions {
+	double duration = 60.0;        // 仿真总时长（秒）
+	double step = 0.005;           // 仿真步长（秒），与界面程序一致
+	uint64_t seed = 0;             // 随机种子，0 表示按当前时间
+	string output = "engine_data_headless.csv";
+	string binary;                 // 非空时同时写二进制列式遥测文件
+	string compressed;             // 非空时同时写压缩日志
+	size_t fleet = 0;              // >0 时按机队模式运行，不写 CSV
+	string scenario;               // 非空时按剧本注入指令，发动机由剧本启动
+	string alerts;                 // 非空时写警报日志，时间为仿真时间
+	string snapshotIn;             // 非空时从检查点恢复发动机，不再自动启动
+	string snapshotOut;            // 非空时在结束时保存检查点
+	string fork;                   // 非空时在结束时按故障矩阵分叉，每行一个分支
+	double forkDuration = 60.0;    // 每个分支推进的仿真时长（秒）
+	string screenshot;             // 非空时用软件帧缓冲画出界面，结束时保存截图（.png 或 .ppm）
+	double screenshotEvery = 0.0;  // >0 时每隔这么多仿真秒另存一帧，文件名加序号
+	double redrawCheck = 0.0;      // >0 时每隔这么多仿真秒比较增量重画与整屏重画的帧缓冲
+	string config = "2x2";         // 引擎台数 x 传感器冗余度，见 FOR_EACH_ENGINE_CONFIG
+	string spool;                  // 非空时从曲线表读取启动/停车曲线，否则用内置曲线
+};
+
+static void printUsage(const char* prog) {
+	cout << "Usage: " << prog << " [--duration <s>] [--step <s>] [--seed <n>] [--output <path>] [--binary <path>] [--compressed <path>]\n"
+		"       [--scenario <file>] [--alerts <path>] [--snapshot-in <path>] [--snapshot-out <path>]\n"
+		"       [--fork <matrix> [--fork-duration <s>]] [--screenshot <path> [--screenshot-every <s>]] [--fleet <n>]\n"
+		"       [--redraw-check <s>] [--config 2x2|3x3|4x3] [--spool <file>]\n";
+	cout << "       --duration  simulated seconds to run (default 60)\n";
+	cout << "       --step      fixed step size in seconds (default 0.005)\n";
+	cout << "       --seed      random seed, 0 = time based (default 0)\n";
+	cout << "       --output    CSV output path, 'none' to skip CSV (default engine_data_headless.csv)\n";
+	cout << "       --binary    also write columnar binary telemetry (.etl) to path\n";
+	cout << "       --compressed also write delta/XOR compressed log (.elz) to path\n";
+	cout << "       --scenario  apply timed commands from a scenario file ('<sim seconds> <command>' per line);\n"
+		"                   the engine is then started by the scenario instead of at t=0\n";
+	cout << "       --alerts    write alert onsets with simulated timestamps to path\n";
+	cout << "       --snapshot-in  restore the engine from a checkpoint instead of starting it;\n"
+		"                   scenario times count from the restore point, --seed reseeds the noise\n";
+	cout << "       --snapshot-out save an engine checkpoint at the end of the run\n";
+	cout << "       --fork      at the end of the run, fork one copy per fault matrix line, run them in parallel\n"
+		"                   for --fork-duration seconds (default 60) and report divergence from an untouched copy\n";
+	cout << "       --screenshot render the monitor UI without a window and save the final frame (.png, otherwise PPM)\n";
+	cout << "       --screenshot-every also save a numbered frame every s simulated seconds (<path>_0001.png, ...)\n";
+	cout << "       --redraw-check every s simulated seconds draw the UI incrementally and from scratch into two\n"
+		"                   framebuffers and exit 1 unless they are identical\n";
+	cout << "       --fleet     simulate n aircraft with EngineFleet and print a summary\n";
+	cout << "       --config    engines x redundant sensors (default 2x2); other configurations name sensors\n"
+		"                   N1_<engine><sensor> (e.g. N1_31) and support only --duration/--step/--seed/--output/\n"
+		"                   --scenario/--alerts\n";
+	cout << "       --spool     start/stop spool profile table ('start <t> <n1> <fuel> <egt>' / 'stop <t> <factor>'\n"
+		"                   per line, see README); default is the built-in profile\n";
+}
+
+// 解析命令行，参数错误时返回 false
+static bool parseOptions(int argc, char* argv[], HeadlessOptions& opt) {
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--help" || arg == "-h") return false;
+		if (i + 1 >= argc) {
+			cerr << "[Headless] Missing value for " << arg << "\n";
+			return false;
+		}
+		string value = argv[++i];
+		try {
+			if (arg == "--duration") opt.duration = stod(value);
+			else if (arg == "--step") opt.step = stod(value);
+			else if (arg == "--seed") opt.seed = stoull(value);
+			else if (arg == "--output") opt.output = value;
+			else if (arg == "--binary") opt.binary = value;
+			else if (arg == "--compressed") opt.compressed = value;
+			else if (arg == "--scenario") opt.scenario = value;
+			else if (arg == "--alerts") opt.alerts = value;
+			else if (arg == "--snapshot-in") opt.snapshotIn = value;
+			else if (arg == "--snapshot-out") opt.snapshotOut = value;
+			else if (arg == "--fork") opt.fork = value;
+			else if (arg == "--fork-duration") opt.forkDuration = stod(value);
+			else if (arg == "--screenshot") opt.screenshot = value;
+			else if (arg == "--screenshot-every") opt.screenshotEvery = stod(value);
+			else if (arg == "--redraw-check") opt.redrawCheck = stod(value);
+			else if (arg == "--fleet") opt.fleet = static_cast<size_t>(stoul(value));
+			else if (arg == "--config") opt.config = value;
+			else if (arg == "--spool") opt.spool = value;
+			else {
+				cerr << "[Headless] Unknown option: " << arg << "\n";
+				return false;
+			}
+		}
+		catch (...) {
+			cerr << "[Headless] Invalid value for " << arg << ": " << value << "\n";
+			return false;
+		}
+	}
+	if (opt.duration <= 0.0 || opt.step <= 0.0 || opt.forkDuration <= 0.0) {
+		cerr << "[Headless] Duration and step must be positive.\n";
+		return false;
+	}
+	// 二进制/压缩日志、检查点、分叉、截图和机队都只支持双发
+	bool twinOnly = !opt.binary.empty() || !opt.compressed.empty() || !opt.snapshotIn.empty() || !opt.snapshotOut.empty()
+		|| !opt.fork.empty() || !opt.screenshot.empty() || opt.redrawCheck > 0.0 || opt.fleet > 0;
+	if (opt.config != TWIN_LAYOUT.name() && twinOnly) {
+		cerr << "[Headless] Configuration " << opt.config << " only supports --duration/--step/--seed/--output/--scenario/--alerts.\n";
+		return false;
+	}
+	return true;
+}
+
+static bool openAlertLog(const string& path, ofstream& alertLog) {
+	if (path.empty()) return true;
+	alertLog.open(path);
+	if (!alertLog.is_open()) {
+		cerr << "[Headless] Cannot open alert log: " << path << "\n";
+		return false;
+	}
+	alertLog << fixed << setprecision(3);
+	return true;
+}
+
+// 判定本步读数，记录新命中的规则（上升沿），需要停机时停机；返回新增的警报条数
+template <class Config>
+static size_t stepAlerts(EngineModel<Config>& engine, const BasicEngineSnapshot<Config>& readings, const AlertProgram& program,
+	uint64_t& activeRules, ofstream& alertLog) {
+	AlertResult result = program.evaluate(readings);
+	uint64_t onset = result.fired & ~activeRules;
+	activeRules = result.fired;
+	size_t count = 0;
+	for (size_t r = 0; onset != 0; ++r, onset >>= 1) {
+		if (!(onset & 1)) continue;
+		++count;
+		if (alertLog.is_open()) alertLog << engine.getSimTime() << " - ALERT: " << program.message(r) << "\n";
+	}
+	if (result.shutdown && readings.state != EngineState::STOPPING && readings.state != EngineState::OFF) {
+		engine.stop();
+	}
+	return count;
+}
+
+// 截图：按界面程序的方式维护警报历史和指示灯，用软件帧缓冲画出 SimFrame
+// 绘制缓存跨帧保留，连续截图时只重画变化的部件
+class ScreenshotRecorder {
+public:
+	explicit ScreenshotRecorder(const string& path)
+		: path(path), screen(WINDOW_WIDTH, WINDOW_HEIGHT), fullScreen(WINDOW_WIDTH, WINDOW_HEIGHT) {
+		alertInfo.setClock(&clock);
+		lightLamp = [this](IndicatorId id, COLORREF color) { frame.lamps.light(id, color); };
+		initializeGauges(gauges);
+		initializeIndicators(indicators);
+		initializeButtons(thrustButtons);
+	}
+
+	// 每步调用，与仿真线程一样判定警报、推进时钟；停机由调用方按规则程序处理
+	void step(const Engine& engine, const EngineSnapshot& readings, double clockTime) {
+		clock.set(clockTime);
+		evaluateAlerts(readings, alertInfo, lightLamp);
+		alertInfo.update();
+		frame.simTime = engine.getSimTime();
+		frame.clockTime = clockTime;
+		frame.readings = readings;
+		++frame.step;
+	}
+
+	// index 为 0 时保存到 path，否则在扩展名前加序号
+	bool capture(int index, string& savedPath) {
+		render();
+		++frames;
+
+		savedPath = path;
+		if (index > 0) {
+			ostringstream suffix;
+			suffix << "_" << setw(4) << setfill('0') << index;
+			size_t dot = path.find_last_of('.');
+			size_t slash = path.find_last_of("/\\");
+			if (dot == string::npos || (slash != string::npos && dot < slash)) dot = path.size();
+			savedPath = path.substr(0, dot) + suffix.str() + path.substr(dot);
+		}
+		return screen.save(savedPath);
+	}
+
+	// 增量画出当前帧，再用失效的缓存把同一帧整屏画到另一块帧缓冲，两者应逐像素一致
+	// 不一致时返回 false，x、y 为第一个不同的像素
+	bool checkRedraw(int& x, int& y) {
+		render();
+		fullCache.invalidate();
+		drawUI(fullScreen, fullCache, gauges, indicators, thrustButtons, frame);
+		++redrawChecks;
+		const vector<uint8_t>& incremental = screen.pixels();
+		const vector<uint8_t>& full = fullScreen.pixels();
+		auto diff = mismatch(incremental.begin(), incremental.end(), full.begin());
+		if (diff.first == incremental.end()) return true;
+		size_t pixel = static_cast<size_t>(diff.first - incremental.begin()) / 4;
+		x = static_cast<int>(pixel % WINDOW_WIDTH);
+		y = static_cast<int>(pixel / WINDOW_WIDTH);
+		return false;
+	}
+
+	int getFrames() const { return frames; }
+	int getRedrawChecks() const { return redrawChecks; }
+	uint64_t getRedrawnRegions() const { return cache.getRedrawnRegions(); }
+	uint64_t getRedrawnPixels() const { return screen.getPresentedPixels(); }
+
+private:
+	void render() {
+		captureAlerts(frame, alertInfo);
+		applyLamps(frame.lamps, seenLamps, frame.clockTime, indicators);
+		updateIndicators(frame.readings, frame.clockTime, indicators, thrustButtons);
+		drawUI(screen, cache, gauges, indicators, thrustButtons, frame);
+	}
+
+	string path;
+	FramebufferRenderer screen;
+	UiDrawCache cache;
+	FramebufferRenderer fullScreen; // 整屏重画的对照帧
+	UiDrawCache fullCache;
+	SimClock clock;
+	AlertInfo alertInfo;
+	IndicatorSetter lightLamp;
+	SimFrame frame;
+	IndicatorLamps seenLamps;
+	vector<Gauge> gauges;
+	IndicatorArray indicators;
+	ButtonArray thrustButtons;
+	int frames = 0;
+	int redrawChecks = 0;
+};
+
+// 机队模式：所有飞机同时启动，输出吞吐量和结束时的状态统计
+static int runFleet(const HeadlessOptions& opt, long long totalSteps, const SpoolProfile& spool) {
+	EngineFleet fleet(opt.fleet, opt.seed);
+	fleet.setSpoolProfile(spool);
+	fleet.startAll();
+
+	auto wallStart = chrono::steady_clock::now();
+	for (long long i = 0; i < totalSteps; ++i) {
+		fleet.advance(opt.step);
+	}
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+	size_t counts[4] = { 0, 0, 0, 0 };
+	double fuelSum = 0.0;
+	for (size_t a = 0; a < fleet.size(); ++a) {
+		counts[static_cast<int>(fleet.getState(a))]++;
+		double fuel = fleet.getFuelReserve(a);
+		if (!isnan(fuel)) fuelSum += fuel;
+	}
+
+	double engineSteps = static_cast<double>(totalSteps) * fleet.size() * EngineFleet::ENGINES_PER_AIRCRAFT;
+	cout << "[Headless] Fleet of " << fleet.size() << " aircraft, " << totalSteps * opt.step << " s simulated in " << wall << " s";
+	if (wall > 0.0) cout << " (" << engineSteps / wall / 1e6 << " M engine-steps/s)";
+	cout << "\n[Headless] OFF " << counts[0] << ", STARTING " << counts[1] << ", STABLE " << counts[2] << ", STOPPING " << counts[3];
+	cout << ", mean fuel reserve " << (fleet.size() ? fuelSum / fleet.size() : 0.0) << "\n";
+	return 0;
+}
+
+// 双发以外的配置：引擎、告警规则、日志列和指令目标都按 Config 生成，CSV 在本线程直接写出
+template <class Config>
+static int runConfiguration(const HeadlessOptions& opt, long long totalSteps, const SpoolProfile& spool) {
+	const EngineLayout layout = EngineLayout::of<Config>();
+	EngineModel<Config> engine = (opt.seed != 0) ? EngineModel<Config>(opt.seed) : EngineModel<Config>();
+	engine.setSpoolProfile(spool);
+
+	vector<ScenarioEvent> events;
+	if (!opt.scenario.empty()) {
+		string error;
+		if (!loadScenario(opt.scenario, events, error, layout)) {
+			cerr << "[Headless] Scenario " << opt.scenario << ": " << error << "\n";
+			return 1;
+		}
+	}
+	ScenarioPlayer player(move(events));
+
+	ofstream alertLog;
+	if (!openAlertLog(opt.alerts, alertLog)) return 1;
+	const AlertProgram& program = defaultAlertProgram<Config>();
+	uint64_t activeRules = 0;
+	size_t alertCount = 0;
+
+	ofstream csv;
+	string csvPath = (opt.output == "none") ? "" : opt.output;
+	if (!csvPath.empty()) {
+		csv.open(csvPath, ios::binary);
+		if (!csv.is_open()) {
+			cerr << "[Headless] Cannot open output file: " << opt.output << "\n";
+			return 1;
+		}
+		logDataHeader(csv, layout);
+	}
+
+	auto wallStart = chrono::steady_clock::now();
+	if (opt.scenario.empty()) engine.start();
+	for (long long i = 0; i < totalSteps; ++i) {
+		player.applyDue(engine, i * opt.step);
+		engine.advance(opt.step);
+		alertCount += stepAlerts(engine, engine.getSnapshot(), program, activeRules, alertLog);
+		if (csv.is_open()) writeSample(csv, captureSample(engine, engine.getSimTime()));
+	}
+	csv.close();
+
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+	cout << "[Headless] " << layout.name() << " configuration, simulated " << totalSteps * opt.step << " s in " << totalSteps
+		<< " steps, wall time " << wall << " s";
+	if (wall > 0.0) cout << " (x" << (totalSteps * opt.step) / wall << " real time)";
+	cout << "\n[Headless] " << program.size() << " alert rules, " << alertCount << " alerts";
+	if (!opt.scenario.empty()) cout << ", " << player.size() << " scenario commands";
+	if (!csvPath.empty()) cout << ", data written to " << csvPath;
+	if (alertLog.is_open()) cout << ", alert log " << opt.alerts;
+	cout << " (seed " << engine.getSeed() << ")\n";
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	HeadlessOptions opt;
+	if (!parseOptions(argc, argv, opt)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	// 用整数步数推进，避免累加浮点误差导致多走或少走一步
+	long long totalSteps = static_cast<long long>(opt.duration / opt.step + 0.5);
+	SpoolProfile spool;
+	if (!opt.spool.empty()) {
+		string error;
+		if (!SpoolProfile::load(opt.spool, spool, error)) {
+			cerr << "[Headless] Spool profile " << opt.spool << ": " << error << "\n";
+			return 1;
+		}
+	}
+	if (opt.fleet > 0) {
+		return runFleet(opt, totalSteps, spool);
+	}
+	if (opt.config != TWIN_LAYOUT.name()) {
+#define RUN_ENGINE_CONFIG(C) if (opt.config == EngineLayout::of<C>().name()) return runConfiguration<C>(opt, totalSteps, spool);
+		FOR_EACH_ENGINE_CONFIG(RUN_ENGINE_CONFIG)
+#undef RUN_ENGINE_CONFIG
+		cerr << "[Headless] Unknown engine configuration: " << opt.config << "\n";
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	Engine engine = (opt.seed != 0) ? Engine(opt.seed) : Engine();
+	engine.setSpoolProfile(spool);
+	if (!opt.snapshotIn.empty()) {
+		string error;
+		if (!readCheckpoint(opt.snapshotIn, engine, error)) {
+			cerr << "[Headless] Checkpoint " << opt.snapshotIn << ": " << error << "\n";
+			return 1;
+		}
+		if (opt.seed != 0) engine.reseed(opt.seed);
+	}
+
+	vector<ScenarioEvent> events;
+	if (!opt.scenario.empty()) {
+		string error;
+		if (!loadScenario(opt.scenario, events, error)) {
+			cerr << "[Headless] Scenario " << opt.scenario << ": " << error << "\n";
+			return 1;
+		}
+	}
+	ScenarioPlayer player(move(events));
+
+	vector<ScenarioCase> branches;
+	if (!opt.fork.empty()) {
+		string error;
+		if (!loadScenarioMatrix(opt.fork, branches, error)) {
+			cerr << "[Headless] Fork matrix " << opt.fork << ": " << error << "\n";
+			return 1;
+		}
+	}
+
+	// 警报按规则命中的上升沿记录，不依赖墙钟，相同种子和剧本得到相同的警报日志
+	ofstream alertLog;
+	if (!openAlertLog(opt.alerts, alertLog)) return 1;
+	const AlertProgram& program = defaultAlertProgram();
+	uint64_t activeRules = 0;
+	size_t alertCount = 0;
+
+	// 写盘放在写线程，与仿真并行；队列满时等待而不是丢样本
+	AsyncLogger logger(1 << 16, true);
+	string csvPath = (opt.output == "none") ? "" : opt.output;
+	if (!logger.open(csvPath, "", opt.binary, opt.compressed)) {
+		cerr << "[Headless] Cannot open one of the output files:";
+		for (const string& path : { csvPath, opt.binary, opt.compressed }) {
+			if (!path.empty()) cerr << " " << path;
+		}
+		cerr << "\n";
+		return 1;
+	}
+
+	unique_ptr<ScreenshotRecorder> recorder;
+	if (!opt.screenshot.empty() || opt.redrawCheck > 0.0) recorder.reset(new ScreenshotRecorder(opt.screenshot));
+	long long screenshotSteps = (opt.screenshotEvery > 0.0 && !opt.screenshot.empty())
+		? max(1LL, static_cast<long long>(opt.screenshotEvery / opt.step + 0.5)) : 0;
+	long long redrawSteps = (opt.redrawCheck > 0.0) ? max(1LL, static_cast<long long>(opt.redrawCheck / opt.step + 0.5)) : 0;
+	int screenshotIndex = 0;
+
+	auto wallStart = chrono::steady_clock::now();
+
+	if (opt.scenario.empty() && opt.snapshotIn.empty()) engine.start();
+	for (long long i = 0; i < totalSteps; ++i) {
+		player.applyDue(engine, i * opt.step);
+		engine.advance(opt.step);
+
+		EngineSnapshot readings = readEngine(engine);
+		alertCount += stepAlerts(engine, readings, program, activeRules, alertLog);
+
+		if (recorder) {
+			recorder->step(engine, readings, (i + 1) * opt.step);
+			if (screenshotSteps > 0 && (i + 1) % screenshotSteps == 0) {
+				string saved;
+				if (!recorder->capture(++screenshotIndex, saved)) {
+					cerr << "[Headless] Cannot write screenshot: " << saved << "\n";
+					return 1;
+				}
+			}
+			int x = 0, y = 0;
+			if (redrawSteps > 0 && (i + 1) % redrawSteps == 0 && !recorder->checkRedraw(x, y)) {
+				cerr << "[Headless] Incremental redraw differs from full redraw at t=" << (i + 1) * opt.step
+					<< " s, first pixel (" << x << ", " << y << ")\n";
+				return 1;
+			}
+		}
+
+		logger.pushSample(captureSample(engine, engine.getSimTime()));
+	}
+	logger.close();
+
+	if (!opt.screenshot.empty()) {
+		string saved;
+		if (!recorder->capture(0, saved)) {
+			cerr << "[Headless] Cannot write screenshot: " << saved << "\n";
+			return 1;
+		}
+	}
+
+	if (!opt.snapshotOut.empty()) {
+		string error;
+		if (!writeCheckpoint(opt.snapshotOut, engine, error)) {
+			cerr << "[Headless] Checkpoint " << opt.snapshotOut << ": " << error << "\n";
+			return 1;
+		}
+	}
+
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+	cout << "[Headless] Simulated " << totalSteps * opt.step << " s in " << totalSteps << " steps, wall time " << wall << " s";
+	if (wall > 0.0) cout << " (x" << (totalSteps * opt.step) / wall << " real time)";
+	if (csvPath.empty() && opt.binary.empty() && opt.compressed.empty()) {
+		cout << "\n[Headless] No data files written";
+	} else {
+		cout << "\n[Headless] Data written to";
+		if (!csvPath.empty()) cout << " " << csvPath;
+		if (!opt.binary.empty()) cout << " " << opt.binary;
+		if (!opt.compressed.empty()) cout << " " << opt.compressed;
+	}
+	cout << " (seed " << engine.getSeed() << ")\n";
+	cout << "[Headless] " << alertCount << " alerts";
+	if (!opt.scenario.empty()) cout << ", " << player.size() << " scenario commands";
+	if (alertLog.is_open()) cout << ", alert log " << opt.alerts;
+	if (!opt.snapshotIn.empty()) cout << ", restored from " << opt.snapshotIn;
+	if (!opt.snapshotOut.empty()) cout << ", checkpoint " << opt.snapshotOut;
+	cout << "\n";
+	if (recorder && recorder->getRedrawChecks() > 0) {
+		cout << "[Headless] " << recorder->getRedrawChecks() << " frames identical between incremental and full redraw\n";
+	}
+	if (!opt.screenshot.empty()) {
+		cout << "[Headless] " << recorder->getFrames() << " screenshots, last " << opt.screenshot << ", "
+			<< recorder->getRedrawnRegions() << " regions / " << recorder->getRedrawnPixels() << " pixels redrawn\n";
+	}
+	if (!opt.compressed.empty()) {
+		const CompressedLogWriter& log = logger.getCompressedLog();
+		cout << "[Headless] Compressed log " << log.getEncodedBytes() << " bytes for " << log.getRawBytes()
+			<< " bytes of CSV rows";
+		if (log.getEncodedBytes() > 0) cout << " (x" << static_cast<double>(log.getRawBytes()) / log.getEncodedBytes() << ")";
+		cout << "\n";
+	}
+
+	if (!opt.fork.empty()) {
+		vector<uint8_t> snapshot;
+		engine.saveSnapshot(snapshot);
+		ForkOptions forkOptions;
+		forkOptions.duration = opt.forkDuration;
+		forkOptions.step = opt.step;
+		forkOptions.spool = &spool;
+		auto forkStart = chrono::steady_clock::now();
+		vector<ForkOutcome> outcomes = runForks(snapshot, branches, forkOptions);
+		double forkWall = chrono::duration<double>(chrono::steady_clock::now() - forkStart).count();
+		cout << "[Headless] Forked " << branches.size() << " branches at t=" << engine.getSimTime() << " s for "
+			<< opt.forkDuration << " s, wall time " << forkWall << " s\n";
+		printForkReport(outcomes, cout, "[Headless] ");
+	}
+	return 0;
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+#include <cstdint>
+
+// 指示灯编号：界面按数组下标存取，告警规则直接引用编号，运行时不再按名称查找
+enum IndicatorId : uint8_t {
+    IND_START, IND_RUN,
+    // 第 1 行: N1 传感器故障 (左/右, 传感器1/2)
+    IND_N1_L_S1_FAIL, IND_N1_L_S2_FAIL, IND_N1_R_S1_FAIL, IND_N1_R_S2_FAIL,
+    // 第 2 行: EGT 传感器故障
+    IND_EGT_L_S1_FAIL, IND_EGT_L_S2_FAIL, IND_EGT_R_S1_FAIL, IND_EGT_R_S2_FAIL,
+    // 第 3 行: 系统级故障和超速
+    IND_N1_SYS_FAIL, IND_EGT_SYS_FAIL, IND_OVERSPEED_L, IND_OVERSPEED_R,
+    // 第 4 行: 燃油系统状态
+    IND_LOW_FUEL, IND_OVER_FF, IND_FUEL_RES_FAIL, IND_FUEL_FLOW_FAIL,
+    // 第 5 行: EGT 超温警告
+    IND_OVERTEMP1, IND_OVERTEMP2, IND_OVERTEMP3, IND_OVERTEMP4,
+    INDICATOR_COUNT
+};
+
+// 指示灯的名称（原来 map 的键）、显示文字和位置
+struct IndicatorLayout {
+    const char* key;
+    const wchar_t* label;
+    int left, top, right, bottom;
+};
+
+// 5x4 指示灯矩阵的网格参数
+const int INDICATOR_W = 125, INDICATOR_H = 25;
+const int INDICATOR_X0 = 20, INDICATOR_Y0 = 500;
+const int INDICATOR_DX = 140, INDICATOR_DY = 30;
+
+constexpr IndicatorLayout indicatorCell(const char* key, const wchar_t* label, int col, int row) {
+    return { key, label,
+        INDICATOR_X0 + col * INDICATOR_DX, INDICATOR_Y0 + row * INDICATOR_DY,
+        INDICATOR_X0 + col * INDICATOR_DX + INDICATOR_W, INDICATOR_Y0 + row * INDICATOR_DY + INDICATOR_H };
+}
+
+// 顺序与 IndicatorId 一致
+constexpr IndicatorLayout INDICATOR_LAYOUT[INDICATOR_COUNT] = {
+    // Start 和 Run 指示灯在矩阵上方，高度更大
+    { "Start", L"START", INDICATOR_X0, INDICATOR_Y0 - 75, INDICATOR_X0 + INDICATOR_W, INDICATOR_Y0 - 15 },
+    { "Run", L"RUN", INDICATOR_X0 + INDICATOR_DX, INDICATOR_Y0 - 75, INDICATOR_X0 + INDICATOR_DX + INDICATOR_W, INDICATOR_Y0 - 15 },
+
+    indicatorCell("N1_L_S1_Fail", L"N1 L S1 Fail", 0, 0),
+    indicatorCell("N1_L_S2_Fail", L"N1 L S2 Fail", 1, 0),
+    indicatorCell("N1_R_S1_Fail", L"N1 R S1 Fail", 2, 0),
+    indicatorCell("N1_R_S2_Fail", L"N1 R S2 Fail", 3, 0),
+
+    indicatorCell("EGT_L_S1_Fail", L"EGT L S1 Fail", 0, 1),
+    indicatorCell("EGT_L_S2_Fail", L"EGT L S2 Fail", 1, 1),
+    indicatorCell("EGT_R_S1_Fail", L"EGT R S1 Fail", 2, 1),
+    indicatorCell("EGT_R_S2_Fail", L"EGT R S2 Fail", 3, 1),
+
+    indicatorCell("N1SFail", L"N1 Sys Fail", 0, 2),
+    indicatorCell("EGTSFail", L"EGT Sys Fail", 1, 2),
+    indicatorCell("OverSpd1", L"OverSpd L", 2, 2),
+    indicatorCell("OverSpd2", L"OverSpd R", 3, 2),
+
+    indicatorCell("LowFuel", L"Low Fuel", 0, 3),
+    indicatorCell("OverFF", L"Over FF", 1, 3),
+    indicatorCell("FuelResFail", L"Fuel Res Fail", 2, 3),
+    indicatorCell("FuelFlowFail", L"Fuel Flow Fail", 3, 3),
+
+    indicatorCell("OverTemp1", L"OverTemp1", 0, 4),
+    indicatorCell("OverTemp2", L"OverTemp2", 1, 4),
+    indicatorCell("OverTemp3", L"OverTemp3", 2, 4),
+    indicatorCell("OverTemp4", L"OverTemp4", 3, 4),
+};
+
+// 推力按钮编号与位置
+enum ButtonId : uint8_t { BTN_THRUST_UP, BTN_THRUST_DOWN, BUTTON_COUNT };
+
+struct ButtonLayout {
+    int left, top, right, bottom;
+    bool up; // true 代表向上
+};
+
+constexpr ButtonLayout BUTTON_LAYOUT[BUTTON_COUNT] = {
+    { 760, 80, 790, 110, true },
+    { 760, 120, 790, 150, false },
+};
@@ -1,4 +1,5 @@
 #include "log.h"
+#include "async_log.h"
 #include "engine.h"
 #include <iostream>
 #include <iomanip>
@@ -6,17 +7,34 @@
 #include <ctime>
 #include <sstream>
 #include <cmath>
-#include <unordered_map>
+#include <array>
+#include <limits>
+#include <charconv>
+#include <cstring>
 using namespace std;	
 
-// doubleNaN⴦
-static ostream& outDouble(ostream& os, double val) { 
+// һλСdoubleNaN⴦ fixed << setprecision(1) һ
+static char* outDouble(char* p, double val) {
 	if (isnan(val)) {
-		os << "NaN";
-	} else {
-		os << val;
+		memcpy(p, "NaN", 3);
+		return p + 3;
 	}
-	return os;
+	return to_chars(p, p + 320, val, chars_format::fixed, 1).ptr;
+}
+
+static char* outText(char* p, const char* text) {
+	size_t n = strlen(text);
+	memcpy(p, text, n);
+	return p + n;
+}
+
+// ʱתMSVC  POSIX ̰߳ȫ汾˳ͬ
+static void localTime(time_t t, tm& buf) {
+#ifdef _WIN32
+	localtime_s(&buf, &t);
+#else
+	localtime_r(&t, &buf);
+#endif
 }
 
 // ȡӳڵʱ䣬λ
@@ -26,95 +44,165 @@ double getCurrenTimeSeconds() {
 	return chrono::duration<double>(currentTime - startTime).count();
 }
 
-void logData(Engine& engine, ofstream& of, double startTime) {
-	if (!of.is_open()) return;
-	int total_ms = static_cast<int>(startTime * 1000 + 0.5);
-	int seconds = total_ms / 1000;
-	int milliseconds = total_ms % 1000;
-	of << seconds << "." << setfill('0') << setw(3) << milliseconds << ",";
-	of << fixed << setprecision(1);
-	// μ¼
-	outDouble(of, engine.getSensorValue(0, 0, 0)) << ",";
-	outDouble(of, engine.getSensorValue(0, 0, 1)) << ",";
-	outDouble(of, engine.getN1Left()) << ",";
-	outDouble(of, engine.getSensorValue(0, 1, 0)) << ",";
-	outDouble(of, engine.getSensorValue(0, 1, 1)) << ",";
-	outDouble(of, engine.getEgtLeft()) << ",";
-	outDouble(of, engine.getSensorValue(1, 0, 0)) << ",";
-	outDouble(of, engine.getSensorValue(1, 0, 1)) << ",";
-	outDouble(of, engine.getN1Right()) << ",";
-	outDouble(of, engine.getSensorValue(1, 1, 0)) << ",";
-	outDouble(of, engine.getSensorValue(1, 1, 1)) << ",";
-	outDouble(of, engine.getEgtRight()) << ",";
-	outDouble(of, engine.getFuelFlow()) << ",";
-	outDouble(of, engine.getFuelReserve()) << ",";
-	switch (engine.getState()) {
-	case EngineState::OFF:      of << "OFF\n"; break;
-	case EngineState::STARTING: of << "STARTING\n"; break;
-	case EngineState::STABLE:   of << "STABLE\n"; break;
-	case EngineState::STOPPING: of << "STOPPING\n"; break;
+const char* const LOG_COLUMN_NAMES[LOG_VALUE_COUNT] = {
+	"N1_L_S1", "N1_L_S2", "N1_L_Disp",
+	"EGT_L_S1", "EGT_L_S2", "EGT_L_Disp",
+	"N1_R_S1", "N1_R_S2", "N1_R_Disp",
+	"EGT_R_S1", "EGT_R_S2", "EGT_R_Disp",
+	"FuelFlow", "FuelReserve"
+};
+
+vector<string> logColumnNames(const EngineLayout& layout) {
+	vector<string> names;
+	for (int e = 0; e < layout.engines; ++e) {
+		string tag = layout.engineTag(e);
+		for (const char* channel : { "N1_", "EGT_" }) {
+			for (int s = 0; s < layout.sensors; ++s) names.push_back(channel + tag + "_S" + to_string(s + 1));
+			names.push_back(channel + tag + "_Disp");
+		}
 	}
+	names.push_back("FuelFlow");
+	names.push_back("FuelReserve");
+	return names;
 }
 
-void logAlert(Alert& alert, ofstream& os, unordered_map<string, double>& lastMsg) {
-	if (!os.is_open() || alert.message.empty()) return;
+void logDataHeader(ostream& of, const EngineLayout& layout) {
+	of << "Timestamp,";
+	for (const string& name : logColumnNames(layout)) {
+		of << name << ",";
+	}
+	of << "State\n";
+}
 
-	double currentTime = getCurrenTimeSeconds();
-	auto it = lastMsg.find(alert.message);
-	if (it != lastMsg.end()) {
-		if (currentTime - it->second < 5.0) {
-			// ͬϢ5ڲظ¼
-			return;
+template <class Config>
+BasicLogSample<Config> captureSample(const EngineModel<Config>& engine, double timestamp) {
+	const int S = Config::SENSORS;
+	BasicLogSample<Config> sample;
+	sample.timestamp = timestamp;
+	// μ¼ݣ˳ͷһ£ȡԱĶգظ
+	const BasicEngineSnapshot<Config>& snap = engine.getSnapshot();
+	for (int e = 0; e < Config::ENGINES; ++e) {
+		double* v = sample.values + e * (2 * S + 2);
+		for (int s = 0; s < S; ++s) {
+			v[s] = snap.n1Sensor[e][s];
+			v[S + 1 + s] = snap.egtSensor[e][s];
 		}
+		v[S] = snap.n1[e];
+		v[2 * S + 1] = snap.egt[e];
 	}
+	sample.values[Config::LOG_COLUMNS - 2] = snap.fuelFlow;
+	sample.values[Config::LOG_COLUMNS - 1] = snap.fuelReserve;
+	sample.state = snap.state;
+	return sample;
+}
 
-	auto now = chrono::system_clock::now();
-	auto time = chrono::system_clock::to_time_t(now);
+template <class Config>
+size_t formatSample(char* out, const BasicLogSample<Config>& sample) {
+	char* p = out;
+	// ʱȡΪ .루벹 3 λ
+	int total_ms = static_cast<int>(sample.timestamp * 1000 + 0.5);
+	int seconds = total_ms / 1000;
+	int milliseconds = total_ms % 1000;
+	p = to_chars(p, p + 16, seconds).ptr;
+	*p++ = '.';
+	*p++ = static_cast<char>('0' + milliseconds / 100);
+	*p++ = static_cast<char>('0' + milliseconds / 10 % 10);
+	*p++ = static_cast<char>('0' + milliseconds % 10);
+	*p++ = ',';
+	for (int i = 0; i < Config::LOG_COLUMNS; ++i) {
+		p = outDouble(p, sample.values[i]);
+		*p++ = ',';
+	}
+	switch (sample.state) {
+	case EngineState::OFF:      p = outText(p, "OFF\n"); break;
+	case EngineState::STARTING: p = outText(p, "STARTING\n"); break;
+	case EngineState::STABLE:   p = outText(p, "STABLE\n"); break;
+	case EngineState::STOPPING: p = outText(p, "STOPPING\n"); break;
+	}
+	return static_cast<size_t>(p - out);
+}
+
+template <class Config>
+void writeSample(ostream& of, const BasicLogSample<Config>& sample) {
+	char line[logLineMax(Config::LOG_COLUMNS)];
+	of.write(line, formatSample(line, sample));
+}
+
+#define INSTANTIATE_LOG_SAMPLE(C) \
+	template BasicLogSample<C> captureSample<C>(const EngineModel<C>&, double); \
+	template size_t formatSample<C>(char*, const BasicLogSample<C>&); \
+	template void writeSample<C>(ostream&, const BasicLogSample<C>&);
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_LOG_SAMPLE)
+
+void logData(Engine& engine, ofstream& of, double startTime) {
+	if (!of.is_open()) return;
+	writeSample(of, captureSample(engine, startTime));
+}
+
+void writeAlertLine(ostream& os, time_t wallTime, const char* message) {
 	tm buf;
-	localtime_s(&buf, &time);
-	os << put_time(&buf, "%Y-%m-%d %H:%M:%S") << " - ALERT: " << alert.message << "\n";
-	lastMsg[alert.message] = currentTime; // ʹüʱ
+	localTime(wallTime, buf);
+	os << put_time(&buf, "%Y-%m-%d %H:%M:%S") << " - ALERT: " << message << "\n";
 }
 
-void logging(Engine& engine, ofstream& datafile, ofstream& alertfile, bool& logging, AlertInfo& alert_info) {
+// ÿϴд־ʱ䣬 Alert::timestamp ʹͬһʱ
+typedef array<double, MAX_ALERT_IDS> AlertLogTimes;
+
+static void logAlert(const Alert& alert, AsyncLogger& logger, AlertLogTimes& lastLogged) {
+	if (!logger.isOpen() || alert.id == NO_ALERT || alert.id >= MAX_ALERT_IDS) return;
+
+	double currentTime = alert.timestamp;
+	if (currentTime - lastLogged[alert.id] < 5.0) {
+		// ͬϢ5ڲظ¼
+		return;
+	}
+
+	// д̸߳ʽֻǽʱ
+	logger.pushAlert(chrono::system_clock::to_time_t(chrono::system_clock::now()), alert.message());
+	lastLogged[alert.id] = currentTime;
+}
+
+void logging(Engine& engine, AsyncLogger& logger, bool& logging, AlertInfo& alert_info) {
 	// ڹ5ظ״̬
-	static unordered_map<string, double> lastMsg;
+	static AlertLogTimes lastLogged; // ÿοʼ־ʱ
+	static bool openFailed = false;  // ʧܺ󱾴вԣص OFF 
 
-	if (engine.getState() != EngineState::OFF && !logging) {
+	if (engine.getState() == EngineState::OFF) openFailed = false;
+	if (engine.getState() != EngineState::OFF && !logging && !openFailed) {
 		auto sysNow = chrono::system_clock::now();
 		auto time = chrono::system_clock::to_time_t(sysNow);
 		tm buf;
-		localtime_s(&buf, &time);
+		localTime(time, buf);
 
 		ostringstream oss;
-		oss << "engine_data_" << put_time(&buf, "%Y%m%d_%H%M%S") << ".csv";
-		datafile.open(oss.str());
-		datafile << "Timestamp,"
-			"N1_L_S1,N1_L_S2,N1_L_Disp,"
-			"EGT_L_S1,EGT_L_S2,EGT_L_Disp,"
-			"N1_R_S1,N1_R_S2,N1_R_Disp,"
-			"EGT_R_S1,EGT_R_S2,EGT_R_Disp,"
-			"FuelFlow,FuelReserve,State\n";
-		alertfile.open("engine_alerts.log", ios::app);
+		oss << "engine_data_" << put_time(&buf, "%Y%m%d_%H%M%S");
+		string base = oss.str();
+		if (!logger.open(base + ".csv", "engine_alerts.log", base + ".etl")) {
+			openFailed = true;
+			cerr << "[Logging] Cannot open " << base << ".csv/.etl, this run will not be logged\n";
+			return;
+		}
 		logging = true;
-		cout << "[Logging] Started logging to " << oss.str() << " and engine_alerts.log\n";
-		lastMsg.clear(); // ʼ־ʱշؼ¼
+		cout << "[Logging] Started logging to " << base << ".csv/.etl and engine_alerts.log (seed " << engine.getSeed() << ")\n";
+		lastLogged.fill(-numeric_limits<double>::infinity()); // ʼ־ʱշؼ¼
 	}
 	else if (engine.getState() == EngineState::OFF && logging) {
-		datafile.close();
-		alertfile.close();
+		logger.close();
 		logging = false;
-		cout << "[Logging] Stopped logging.\n";
+		cout << "[Logging] Stopped logging. " << logger.getWrittenSamples() << " samples written, "
+			<< logger.getDroppedSamples() << " dropped, queue high-water " << logger.getHighWaterMark()
+			<< "/" << logger.getCapacity() << "\n";
 	}
 
 	if (!logging) return;
 
-	logData(engine, datafile, engine.getSimTime());
+	// ֻ߳ӣʽдд߳
+	logger.pushSample(captureSample(engine, engine.getSimTime()));
 
 	// ȡ¾һ¼
 	auto newAlerts = alert_info.getAndClearNewAlerts();
 	for (auto& alert : newAlerts) {
-		logAlert(alert, alertfile, lastMsg);
+		logAlert(alert, logger, lastLogged);
 	}
 }
 
@@ -1,9 +1,44 @@
 #pragma once
 #include <fstream>
 #include <string>
+#include <vector>
+#include <ctime>
 #include "engine.h"
-#include "ui.h" 
+#include "alert.h" 
 
-void logging(Engine& engine, std::ofstream& data_log_file, std::ofstream& alert_log_file, bool& is_logging, AlertInfo& alert_info);
-void logData(Engine& engine, std::ofstream& data_log_file, double start_time);
+class AsyncLogger;
+
+// һ CSV 󳤶ȣÿа double ʽ 312 ַӶŹ㣬ʱ״̬
+constexpr size_t logLineMax(int columns) { return static_cast<size_t>(columns) * 320 + 128; }
+
+// һ־Ķ¼˳ CSV ͷһ£ñ仯 EngineConfig::LOG_COLUMNS
+template <class Config>
+struct BasicLogSample {
+    static const int VALUE_COUNT = Config::LOG_COLUMNS;
+    double timestamp;
+    double values[VALUE_COUNT];
+    EngineState state;
+};
+
+// ˫ļ¼첽־ѹ/־ʽͻطŶֻ֧һ
+typedef BasicLogSample<TwinConfig> LogSample;
+const int LOG_VALUE_COUNT = LogSample::VALUE_COUNT; // ʱ״̬֮
+extern const char* const LOG_COLUMN_NAMES[LOG_VALUE_COUNT]; // ƣ CSV ͷһ
+const size_t LOG_LINE_MAX = logLineMax(LOG_VALUE_COUNT);
+
+// ƣ N1_L_S1N1_3_Disp˫ʱ LOG_COLUMN_NAMES ͬ
+std::vector<std::string> logColumnNames(const EngineLayout& layout);
+
+void logging(Engine& engine, AsyncLogger& logger, bool& is_logging, AlertInfo& alert_info);
+void logDataHeader(std::ostream& data_log_file, const EngineLayout& layout = TWIN_LAYOUT); // д CSV ͷ
+void logData(Engine& engine, std::ofstream& data_log_file, double start_time);
+// ģʵ log.cpp FOR_EACH_ENGINE_CONFIG ʽʵ
+template <class Config>
+BasicLogSample<Config> captureSample(const EngineModel<Config>& engine, double timestamp); // ǰʾֵʹֵ
+template <class Config>
+void writeSample(std::ostream& os, const BasicLogSample<Config>& sample); //  CSV ʽдһ
+// һ CSV ʽ out logLineMax() ֽڣдֽڴ桢 locale Ӱ
+template <class Config>
+size_t formatSample(char* out, const BasicLogSample<Config>& sample);
+void writeAlertLine(std::ostream& os, std::time_t wallTime, const char* message); // ־ʽдһ
 double getCurrenTimeSeconds();
@@ -0,0 +1,102 @@
+﻿// 日志格式化基准：比较原来的 ostream 格式化和 formatSample，并检查两者输出逐字节一致
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "engine.h"
+#include "log.h"
+using namespace std;
+
+// 原来的写法：每个字段一次 <<，靠 fixed/setprecision/setfill/setw 控制格式
+static void writeSampleStream(ostream& of, const LogSample& sample) {
+	int total_ms = static_cast<int>(sample.timestamp * 1000 + 0.5);
+	int seconds = total_ms / 1000;
+	int milliseconds = total_ms % 1000;
+	of << seconds << "." << setfill('0') << setw(3) << milliseconds << ",";
+	of << fixed << setprecision(1);
+	for (int i = 0; i < LOG_VALUE_COUNT; ++i) {
+		if (isnan(sample.values[i])) of << "NaN";
+		else of << sample.values[i];
+		of << ",";
+	}
+	switch (sample.state) {
+	case EngineState::OFF:      of << "OFF\n"; break;
+	case EngineState::STARTING: of << "STARTING\n"; break;
+	case EngineState::STABLE:   of << "STABLE\n"; break;
+	case EngineState::STOPPING: of << "STOPPING\n"; break;
+	}
+}
+
+// 用真实仿真数据生成样本，再补几行边界值（NaN、负数、覆盖值、极大值）
+static vector<LogSample> makeSamples(size_t count) {
+	vector<LogSample> samples;
+	samples.reserve(count + 3);
+	Engine engine(12345);
+	engine.setVerbose(false);
+	engine.start();
+	for (size_t i = 0; i < count; ++i) {
+		engine.advance(0.005);
+		samples.push_back(captureSample(engine, engine.getSimTime()));
+	}
+	LogSample edge = samples.back();
+	edge.values[0] = numeric_limits<double>::quiet_NaN();
+	edge.values[1] = -50.0;
+	edge.values[2] = -0.04;
+	edge.values[3] = 0.05;
+	edge.values[4] = 0.25;
+	edge.values[5] = 1e300;
+	edge.values[6] = -numeric_limits<double>::max();
+	samples.push_back(edge);
+	edge.timestamp = 123456.9996;
+	edge.state = EngineState::STOPPING;
+	samples.push_back(edge);
+	return samples;
+}
+
+int main(int argc, char* argv[]) {
+	size_t count = 200000;
+	if (argc > 1) count = static_cast<size_t>(stoul(argv[1]));
+	vector<LogSample> samples = makeSamples(count);
+
+	// 两种格式化都写入内存，排除磁盘的影响
+	string streamOut, charsOut;
+	streamOut.reserve(samples.size() * 128);
+	charsOut.reserve(samples.size() * 128);
+	auto t0 = chrono::steady_clock::now();
+	{
+		ostringstream os;
+		for (const LogSample& s : samples) writeSampleStream(os, s);
+		streamOut = os.str();
+	}
+	auto t1 = chrono::steady_clock::now();
+	{
+		// 与写线程相同：格式化到固定行缓冲，攒满后整块追加
+		vector<char> buffer(256 * 1024);
+		size_t n = 0;
+		for (const LogSample& s : samples) {
+			if (buffer.size() - n < LOG_LINE_MAX) {
+				charsOut.append(buffer.data(), n);
+				n = 0;
+			}
+			n += formatSample(buffer.data() + n, s);
+		}
+		charsOut.append(buffer.data(), n);
+	}
+	auto t2 = chrono::steady_clock::now();
+
+	double streamNs = chrono::duration<double, nano>(t1 - t0).count() / samples.size();
+	double charsNs = chrono::duration<double, nano>(t2 - t1).count() / samples.size();
+	cout << "[LogBench] " << samples.size() << " rows, " << charsOut.size() << " bytes\n";
+	cout << "[LogBench] ostream:      " << streamNs << " ns/row\n";
+	cout << "[LogBench] formatSample: " << charsNs << " ns/row (x" << streamNs / charsNs << ")\n";
+	if (streamOut != charsOut) {
+		cout << "[LogBench] Output differs!\n";
+		return 1;
+	}
+	cout << "[LogBench] Output identical\n";
+	return 0;
+}
@@ -0,0 +1,402 @@
+﻿#include "log_codec.h"
+#include <cstring>
+#include <cmath>
+#include <charconv>
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+static const char FILE_MAGIC[4] = { 'E', 'L', 'Z', '1' };
+static const char BLOCK_MAGIC[4] = { 'E', 'L', 'Z', 'B' };
+static const double EXACT_LIMIT = 1e14; // 乘 10 后仍远小于 2^53，整数可精确表示
+
+// 文件头，16 字节
+struct CodecFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t valueCount;
+	uint32_t reserved;
+};
+
+// 块头，后接位流、状态游程 (u32 行数 + u8 状态) 和例外 (u32 行 + u32 通道 + f64 值)
+struct CodecBlockHeader {
+	char magic[4];
+	uint32_t rows;
+	uint32_t bitBytes;
+	uint32_t runCount;
+	uint32_t exceptionCount;
+	uint32_t reserved;
+};
+
+static int countLeadingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return 63 - static_cast<int>(index);
+#else
+	return __builtin_clzll(x);
+#endif
+}
+
+static int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+static uint64_t toBits(double v) {
+	uint64_t u;
+	memcpy(&u, &v, sizeof(u));
+	return u;
+}
+
+static double fromBits(uint64_t u) {
+	double v;
+	memcpy(&v, &u, sizeof(v));
+	return v;
+}
+
+// 与 formatSample 相同的毫秒取整
+static int64_t toMilliseconds(double timestamp) {
+	return static_cast<int>(timestamp * 1000 + 0.5);
+}
+
+// 把值换成 CSV 中一位小数对应的“十分位整数”，以 double 存放；
+// 直接解析 to_chars 的结果，保证与 CSV 的舍入完全一致（包括 -0.0）
+static bool toTenths(double v, double& tenths) {
+	if (isnan(v)) {
+		tenths = numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+	if (!(fabs(v) < EXACT_LIMIT)) return false;
+	char buf[32];
+	char* end = to_chars(buf, buf + sizeof(buf), v, chars_format::fixed, 1).ptr;
+	int64_t n = 0;
+	for (char* p = buf; p != end; ++p) {
+		if (*p >= '0' && *p <= '9') n = n * 10 + (*p - '0');
+	}
+	tenths = (buf[0] == '-') ? -static_cast<double>(n) : static_cast<double>(n);
+	if (n == 0 && buf[0] == '-') tenths = -0.0;
+	return true;
+}
+
+// -----位流-----
+
+void BitWriter::write(uint64_t bits, int count) {
+	// 每次最多补满当前字节
+	while (count > 0) {
+		int n = min(8 - pendingBits, count);
+		uint64_t chunk = (bits >> (count - n)) & ((1u << n) - 1);
+		pending = (pending << n) | chunk;
+		pendingBits += n;
+		count -= n;
+		if (pendingBits == 8) {
+			buffer.push_back(static_cast<uint8_t>(pending));
+			pending = 0;
+			pendingBits = 0;
+		}
+	}
+}
+
+void BitWriter::finish() {
+	if (pendingBits > 0) {
+		buffer.push_back(static_cast<uint8_t>(pending << (8 - pendingBits)));
+		pending = 0;
+		pendingBits = 0;
+	}
+}
+
+void BitWriter::clear() {
+	buffer.clear();
+	pending = 0;
+	pendingBits = 0;
+}
+
+uint64_t BitReader::read(int count) {
+	uint64_t value = 0;
+	while (count > 0) {
+		int offset = static_cast<int>(bitPos & 7);
+		int n = min(8 - offset, count);
+		uint64_t byte = (bitPos >> 3) < size ? data[bitPos >> 3] : 0;
+		value = (value << n) | ((byte >> (8 - offset - n)) & ((1u << n) - 1));
+		bitPos += n;
+		count -= n;
+	}
+	return value;
+}
+
+// -----时间戳：差分的差分-----
+//   0                 差分不变
+//   10   + 7 位       [-63, 64]
+//   110  + 9 位       [-255, 256]
+//   1110 + 12 位      [-2047, 2048]
+//   1111 + 64 位      其他
+
+static void writeDeltaOfDelta(BitWriter& w, int64_t dod) {
+	if (dod == 0) {
+		w.write(0, 1);
+	}
+	else if (dod >= -63 && dod <= 64) {
+		w.write(0b10, 2);
+		w.write(static_cast<uint64_t>(dod + 63), 7);
+	}
+	else if (dod >= -255 && dod <= 256) {
+		w.write(0b110, 3);
+		w.write(static_cast<uint64_t>(dod + 255), 9);
+	}
+	else if (dod >= -2047 && dod <= 2048) {
+		w.write(0b1110, 4);
+		w.write(static_cast<uint64_t>(dod + 2047), 12);
+	}
+	else {
+		w.write(0b1111, 4);
+		w.write(static_cast<uint64_t>(dod), 64);
+	}
+}
+
+static int64_t readDeltaOfDelta(BitReader& r) {
+	if (r.read(1) == 0) return 0;
+	if (r.read(1) == 0) return static_cast<int64_t>(r.read(7)) - 63;
+	if (r.read(1) == 0) return static_cast<int64_t>(r.read(9)) - 255;
+	if (r.read(1) == 0) return static_cast<int64_t>(r.read(12)) - 2047;
+	return static_cast<int64_t>(r.read(64));
+}
+
+// -----数据列：Gorilla 异或-----
+//   块内第一行直接写 64 位
+//   0                          与上一值相同
+//   10 + 有效位                 落在上一个窗口内
+//   11 + 5 位前导零 + 6 位长度-1 + 有效位
+
+static void writeXor(BitWriter& w, XorChannelState& st, uint64_t value) {
+	uint64_t x = value ^ st.prev;
+	st.prev = value;
+	if (x == 0) {
+		w.write(0, 1);
+		return;
+	}
+	int leading = min(countLeadingZeros(x), 31);
+	int trailing = countTrailingZeros(x);
+	if (st.leading >= 0 && leading >= st.leading && trailing >= st.trailing) {
+		w.write(0b10, 2);
+		w.write(x >> st.trailing, 64 - st.leading - st.trailing);
+		return;
+	}
+	int length = 64 - leading - trailing;
+	w.write(0b11, 2);
+	w.write(static_cast<uint64_t>(leading), 5);
+	w.write(static_cast<uint64_t>(length - 1), 6);
+	w.write(x >> trailing, length);
+	st.leading = leading;
+	st.trailing = trailing;
+}
+
+static uint64_t readXor(BitReader& r, XorChannelState& st) {
+	if (r.read(1) == 0) return st.prev;
+	if (r.read(1) == 1) {
+		st.leading = static_cast<int>(r.read(5));
+		int length = static_cast<int>(r.read(6)) + 1;
+		st.trailing = 64 - st.leading - length;
+	}
+	int length = 64 - st.leading - st.trailing;
+	st.prev ^= r.read(length) << st.trailing;
+	return st.prev;
+}
+
+// -----写入-----
+
+CompressedLogWriter::~CompressedLogWriter() {
+	close();
+}
+
+bool CompressedLogWriter::open(const string& path) {
+	close();
+	file.open(path, ios::binary | ios::trunc);
+	if (!file.is_open()) return false;
+	CodecFileHeader header = {};
+	memcpy(header.magic, FILE_MAGIC, 4);
+	header.version = LOG_CODEC_VERSION;
+	header.valueCount = LOG_VALUE_COUNT;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	bits.clear();
+	rows = 0;
+	stateRuns.clear();
+	exceptions.clear();
+	rawBytes = 0;
+	encodedBytes = sizeof(header);
+	return true;
+}
+
+void CompressedLogWriter::append(const LogSample& sample) {
+	if (!file.is_open()) return;
+	char line[LOG_LINE_MAX];
+	rawBytes += formatSample(line, sample);
+
+	int64_t ms = toMilliseconds(sample.timestamp);
+	if (rows == 0) {
+		bits.write(static_cast<uint64_t>(ms), 64);
+		prevDelta = 0;
+	}
+	else {
+		int64_t delta = ms - prevMs;
+		writeDeltaOfDelta(bits, delta - prevDelta);
+		prevDelta = delta;
+	}
+	prevMs = ms;
+
+	for (int c = 0; c < LOG_VALUE_COUNT; ++c) {
+		double tenths;
+		if (!toTenths(sample.values[c], tenths)) {
+			exceptions.push_back({ rows, static_cast<uint32_t>(c), sample.values[c] });
+			tenths = fromBits(channels[c].prev); // 位流里重复上一值，只占 1 位
+		}
+		uint64_t u = toBits(tenths);
+		if (rows == 0) {
+			bits.write(u, 64);
+			channels[c] = XorChannelState();
+			channels[c].prev = u;
+		}
+		else {
+			writeXor(bits, channels[c], u);
+		}
+	}
+
+	uint8_t state = static_cast<uint8_t>(sample.state);
+	if (!stateRuns.empty() && stateRuns.back().second == state) ++stateRuns.back().first;
+	else stateRuns.push_back({ 1, state });
+
+	if (++rows >= LOG_CODEC_BLOCK_ROWS) flushBlock();
+}
+
+void CompressedLogWriter::flushBlock() {
+	if (rows == 0) return;
+	bits.finish();
+	CodecBlockHeader header = {};
+	memcpy(header.magic, BLOCK_MAGIC, 4);
+	header.rows = rows;
+	header.bitBytes = static_cast<uint32_t>(bits.bytes().size());
+	header.runCount = static_cast<uint32_t>(stateRuns.size());
+	header.exceptionCount = static_cast<uint32_t>(exceptions.size());
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(bits.bytes().data()), header.bitBytes);
+	for (const auto& run : stateRuns) {
+		file.write(reinterpret_cast<const char*>(&run.first), sizeof(uint32_t));
+		file.write(reinterpret_cast<const char*>(&run.second), 1);
+	}
+	for (const Exception& e : exceptions) {
+		file.write(reinterpret_cast<const char*>(&e.row), sizeof(uint32_t));
+		file.write(reinterpret_cast<const char*>(&e.channel), sizeof(uint32_t));
+		file.write(reinterpret_cast<const char*>(&e.value), sizeof(double));
+	}
+	encodedBytes += sizeof(header) + header.bitBytes + header.runCount * 5 + header.exceptionCount * 16;
+
+	bits.clear();
+	rows = 0;
+	stateRuns.clear();
+	exceptions.clear();
+}
+
+void CompressedLogWriter::close() {
+	if (!file.is_open()) return;
+	flushBlock();
+	file.close();
+}
+
+// -----读取-----
+
+bool CompressedLogReader::fail(const string& message) {
+	lastError = message;
+	block.clear();
+	blockPos = 0;
+	return false;
+}
+
+bool CompressedLogReader::open(const string& path) {
+	lastError.clear();
+	block.clear();
+	blockPos = 0;
+	if (file.is_open()) file.close();
+	file.open(path, ios::binary);
+	if (!file.is_open()) return fail("cannot open file " + path);
+	CodecFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return fail("file too small");
+	if (memcmp(header.magic, FILE_MAGIC, 4) != 0) return fail("not a compressed log");
+	if (header.version != LOG_CODEC_VERSION) return fail("unsupported version");
+	if (header.valueCount != LOG_VALUE_COUNT) return fail("column count mismatch");
+	return true;
+}
+
+bool CompressedLogReader::next(LogSample& sample) {
+	if (blockPos >= block.size() && !loadBlock()) return false;
+	sample = block[blockPos++];
+	return true;
+}
+
+bool CompressedLogReader::loadBlock() {
+	block.clear();
+	blockPos = 0;
+	if (!file.is_open()) return false;
+	CodecBlockHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false; // 正常结束
+	if (memcmp(header.magic, BLOCK_MAGIC, 4) != 0) return fail("bad block header");
+	if (header.rows == 0 || header.rows > LOG_CODEC_BLOCK_ROWS) return fail("bad block size");
+
+	vector<uint8_t> payload(header.bitBytes);
+	if (!file.read(reinterpret_cast<char*>(payload.data()), payload.size())) return fail("truncated block");
+	BitReader r(payload.data(), payload.size());
+
+	block.resize(header.rows);
+	XorChannelState channels[LOG_VALUE_COUNT];
+	int64_t ms = 0, delta = 0;
+	for (uint32_t row = 0; row < header.rows; ++row) {
+		LogSample& s = block[row];
+		if (row == 0) {
+			ms = static_cast<int64_t>(r.read(64));
+		}
+		else {
+			delta += readDeltaOfDelta(r);
+			ms += delta;
+		}
+		s.timestamp = ms / 1000.0;
+		for (int c = 0; c < LOG_VALUE_COUNT; ++c) {
+			uint64_t u;
+			if (row == 0) {
+				u = r.read(64);
+				channels[c].prev = u;
+			}
+			else {
+				u = readXor(r, channels[c]);
+			}
+			s.values[c] = fromBits(u) / 10.0;
+		}
+	}
+	if (r.overrun()) return fail("corrupt bit stream");
+
+	uint32_t row = 0;
+	for (uint32_t i = 0; i < header.runCount; ++i) {
+		uint32_t length;
+		uint8_t state;
+		file.read(reinterpret_cast<char*>(&length), sizeof(length));
+		file.read(reinterpret_cast<char*>(&state), 1);
+		if (!file || row + length > header.rows) return fail("bad state runs");
+		for (uint32_t k = 0; k < length; ++k) block[row++].state = static_cast<EngineState>(state);
+	}
+	if (row != header.rows) return fail("bad state runs");
+
+	for (uint32_t i = 0; i < header.exceptionCount; ++i) {
+		uint32_t exRow, exChannel;
+		double value;
+		file.read(reinterpret_cast<char*>(&exRow), sizeof(exRow));
+		file.read(reinterpret_cast<char*>(&exChannel), sizeof(exChannel));
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+		if (!file || exRow >= header.rows || exChannel >= LOG_VALUE_COUNT) return fail("bad exception record");
+		block[exRow].values[exChannel] = value;
+	}
+	return true;
+}
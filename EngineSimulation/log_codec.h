@@ -0,0 +1,98 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "log.h"
+
+// 压缩数据日志 (.elz)，按 CSV 的精度无损：解码后用 writeSample 输出与原 CSV 逐字节一致
+//   时间戳：毫秒整数，差分的差分 + 变长前缀
+//   数据列：按 CSV 的一位小数取整后乘 10（整数值的 double），Gorilla 异或编码
+//   状态列：游程编码
+//   无法按一位小数精确表示的值（无穷大、绝对值 >= 1e14）作为例外原样存放
+// 每块最多 LOG_CODEC_BLOCK_ROWS 行，块之间互不依赖，写到一半的文件也能解码已完成的块
+const uint32_t LOG_CODEC_VERSION = 1;
+const uint32_t LOG_CODEC_BLOCK_ROWS = 4096;
+
+class BitWriter {
+public:
+    void write(uint64_t bits, int count); // 写入低 count 位，count <= 64
+    void finish(); // 把不足一字节的剩余位补零写出
+    void clear();
+    const std::vector<uint8_t>& bytes() const { return buffer; }
+
+private:
+    std::vector<uint8_t> buffer;
+    uint64_t pending = 0; // 尚未凑满一字节的位
+    int pendingBits = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+    uint64_t read(int count); // 越界时按 0 读取
+    bool overrun() const { return bitPos > size * 8; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bitPos = 0;
+};
+
+// Gorilla 异或编码的单通道状态
+struct XorChannelState {
+    uint64_t prev = 0;
+    int leading = -1; // 上一个有效窗口，-1 表示还没有
+    int trailing = 0;
+};
+
+class CompressedLogWriter {
+public:
+    CompressedLogWriter() = default;
+    ~CompressedLogWriter();
+
+    bool open(const std::string& path);
+    void append(const LogSample& sample);
+    void close(); // 写出未满的最后一块
+    bool isOpen() const { return file.is_open(); }
+
+    uint64_t getRawBytes() const { return rawBytes; }         // 对应 CSV 行的字节数
+    uint64_t getEncodedBytes() const { return encodedBytes; } // 已写出的压缩字节数
+
+private:
+    struct Exception {
+        uint32_t row;
+        uint32_t channel;
+        double value;
+    };
+    void flushBlock();
+
+    std::ofstream file;
+    BitWriter bits;
+    uint32_t rows = 0;
+    int64_t prevMs = 0;
+    int64_t prevDelta = 0;
+    XorChannelState channels[LOG_VALUE_COUNT];
+    std::vector<std::pair<uint32_t, uint8_t>> stateRuns; // (行数, 状态)
+    std::vector<Exception> exceptions;
+    uint64_t rawBytes = 0;
+    uint64_t encodedBytes = 0;
+};
+
+// 顺序解码，一次读入一块
+class CompressedLogReader {
+public:
+    bool open(const std::string& path);
+    bool next(LogSample& sample); // 没有更多行或文件损坏时返回 false
+    const std::string& error() const { return lastError; }
+
+private:
+    bool loadBlock();
+    bool fail(const std::string& message);
+
+    std::ifstream file;
+    std::vector<LogSample> block;
+    size_t blockPos = 0;
+    std::string lastError;
+};
@@ -1,212 +1,172 @@
 #include <vector>
-#include <map>
+#include <array>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <thread> 
 #include <ctime>
 #include <iostream>
 #include <chrono>
+#include <atomic>
 #include <graphics.h> 
 #include "engine.h" 
 #include "ui.h"
 #include "ui_draw.h"
+#include "easyx_renderer.h"
 #include "event.h"
 #include "log.h"
+#include "async_log.h"
+#include "monitor.h"
+#include "replay.h"
+#include "sim_thread.h"
+#include "fork.h"
+#include "frame_stats.h"
 using namespace std;
 
 Engine engine;
-map<string, Indicator> indicators;
-map<string, TriangleButton> thrust_buttons;
+IndicatorArray indicators;
+ButtonArray thrust_buttons;
 AlertInfo alertInfo;
 bool startButtonPressed = false;
 bool stopButtonPressed = false;
 
-bool cmdThreadRunning = true;
+atomic<bool> cmdThreadRunning{ true };
 thread cmdThread;
-ofstream data_log_file;
-ofstream alert_log_file;
-
-bool isLogging = false;
-
-
-static void updateIndicators(Engine& engine, map<string, Indicator>& indicators) {
-    // ¸ָʾʱ״̬
-    for (auto& pair : indicators) {
-        //  Start  Run ָʾԶϨ
-        if (pair.first != "Start" && pair.first != "Run") {
-            pair.second.update();
-        }
-    }
-
-    // ȡ״̬
-    EngineState state = engine.getState();
-
-    //  Start  Run ָʾ
-    if (state == EngineState::STARTING) {
-        indicators.at("Start").setActive(COLOR_GREEN);
-        indicators.at("Run").deactivate();
-    }
-    else if (state == EngineState::STABLE) {
-        indicators.at("Start").deactivate();
-        // N1 ȶֵ95%Ϩ
-        if (engine.getN1Left() < N1_STABLE_THRESHOLD * 0.95 || engine.getN1Right() < N1_STABLE_THRESHOLD * 0.95) {
-            indicators.at("Run").deactivate();
+AsyncLogger asyncLogger;
+SimulationThread simulation(engine, alertInfo, asyncLogger);
+FrameStats frameStats; // ѭͷ̸߳׶κʱ̨ stats 鿴˳ʱӡ
+
+
+// طģʽEngineSimulation --replay <file> [--speed <x>] [--from <s>]
+struct ReplayMode {
+    unique_ptr<ReplaySource> source;
+    double speed = 1.0;
+    double from = 0.0;
+};
+
+static bool parseReplayArgs(int argc, char* argv[], ReplayMode& replay) {
+    string path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        string value = argv[i + 1];
+        try {
+            if (arg == "--replay") path = value;
+            else if (arg == "--speed") replay.speed = stod(value);
+            else if (arg == "--from") replay.from = stod(value);
         }
-        else {
-            indicators.at("Run").setActive(COLOR_GREEN);
+        catch (...) {
+            cout << "[Replay] Invalid value for " << arg << ": " << value << "\n";
         }
     }
-    else { // OFF  STOPPING ״̬
-        indicators.at("Start").deactivate();
-        indicators.at("Run").deactivate();
+    if (path.empty()) return false;
+    string error;
+    replay.source = openReplaySource(path, error);
+    if (!replay.source) {
+        cout << "[Replay] Cannot read " << path << ": " << error << "\n";
+        return false;
     }
+    replay.source->seek(replay.from);
+    cout << "[Replay] Replaying " << path << " from " << replay.from << " s at x" << replay.speed << "\n";
+    return true;
+}
 
-    // ޸ģֱӴоֻȼ
-    auto trigger_alert = [&](const std::string& msg, const COLORREF color) {
-        if (!msg.empty()) {
-            alertInfo.triggerAlert(msg, color);
+// 籾EngineSimulation --scenario <file>籾еָָ̨һڷִ߳
+static void loadScenarioArg(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (string(argv[i]) != "--scenario") continue;
+        vector<ScenarioEvent> events;
+        string error;
+        if (!loadScenario(argv[i + 1], events, error)) {
+            cout << "[Scenario] " << argv[i + 1] << ": " << error << "\n";
+            return;
         }
-    };
-
-    // ɫ
-    if (engine.isN1SensorAnomal(0, 0)) {
-        indicators.at("N1_L_S1_Fail").setActive(COLOR_WHITE);
-        trigger_alert("N1 SENSOR 1 LEFT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isN1SensorAnomal(0, 1)) {
-        indicators.at("N1_L_S2_Fail").setActive(COLOR_WHITE);
-        trigger_alert("N1 SENSOR 2 LEFT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isEGTSensorAnomal(0, 0)) {
-        indicators.at("EGT_L_S1_Fail").setActive(COLOR_WHITE);
-        trigger_alert("EGT SENSOR 1 LEFT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isEGTSensorAnomal(0, 1)) {
-        indicators.at("EGT_L_S2_Fail").setActive(COLOR_WHITE);
-        trigger_alert("EGT SENSOR 2 LEFT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isN1SensorAnomal(1, 0)) {
-        indicators.at("N1_R_S1_Fail").setActive(COLOR_WHITE);
-        trigger_alert("N1 SENSOR 1 RIGHT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isN1SensorAnomal(1, 1)) {
-        indicators.at("N1_R_S2_Fail").setActive(COLOR_WHITE);
-        trigger_alert("N1 SENSOR 2 RIGHT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isEGTSensorAnomal(1, 0)) {
-        indicators.at("EGT_R_S1_Fail").setActive(COLOR_WHITE);
-        trigger_alert("EGT SENSOR 1 RIGHT ANOMALY", COLOR_WHITE);
-    }
-    if (engine.isEGTSensorAnomal(1, 1)) {
-        indicators.at("EGT_R_S2_Fail").setActive(COLOR_WHITE);
-        trigger_alert("EGT SENSOR 2 RIGHT ANOMALY", COLOR_WHITE);
+        cout << "[Scenario] Loaded " << events.size() << " commands from " << argv[i + 1] << "\n";
+        simulation.setScenario(move(events));
     }
+}
 
-    if (engine.isN1SystemFault(0) || engine.isN1SystemFault(1)) {
-        indicators.at("N1SFail").setActive(COLOR_AMBER);
-        trigger_alert("N1 SYSTEM FAULT", COLOR_AMBER);
+// ̨ fork ָӷ߳ȡǰĿգϾֲ沢ƽӡߵƫ
+// ڿ̨߳Уͷ治Ӱ
+static bool handleForkCommand(const string& line) {
+    istringstream iss(line);
+    string word, path;
+    if (!(iss >> word) || word != "fork") return false;
+    ForkOptions options;
+    if (!(iss >> path)) {
+        cout << "[Fork] Usage: fork <matrix> [seconds]\n";
+        return true;
     }
-    if (engine.isEGTSystemFault(0) || engine.isEGTSystemFault(1)) {
-        indicators.at("EGTSFail").setActive(COLOR_AMBER);
-        trigger_alert("EGT SYSTEM FAULT", COLOR_AMBER);
+    double seconds;
+    if (iss >> seconds && seconds > 0.0) options.duration = seconds;
+
+    vector<ScenarioCase> branches;
+    string error;
+    if (!loadScenarioMatrix(path, branches, error)) {
+        cout << "[Fork] " << path << ": " << error << "\n";
+        return true;
     }
-    if (engine.isN1SystemFault(0) && engine.isN1SystemFault(1)) {
-        indicators.at("N1SFail").setActive(COLOR_RED);
-        trigger_alert("DUAL N1 SYSTEM FAILURE - SHUTDOWN", COLOR_RED);
-        if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
-    }
-    if (engine.isEGTSystemFault(0) && engine.isEGTSystemFault(1)) {
-        indicators.at("EGTSFail").setActive(COLOR_RED);
-        trigger_alert("DUAL EGT SYSTEM FAILURE - SHUTDOWN", COLOR_RED);
-        if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
+    vector<uint8_t> snapshot = simulation.requestSnapshot().get();
+    double forkTime = 0.0;
+    Engine::snapshotSimTime(snapshot.data(), snapshot.size(), forkTime);
+    auto wallStart = chrono::steady_clock::now();
+    vector<ForkOutcome> outcomes = runForks(snapshot, branches, options);
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    cout << "[Fork] " << branches.size() << " branches from t=" << forkTime << " s, " << options.duration
+        << " s each, wall time " << wall << " s\n";
+    printForkReport(outcomes, cout, "[Fork] ");
+    return true;
+}
+
+// ̨ stats ָӡ׶κʱֱͼstats reset 
+static bool handleStatsCommand(const string& line) {
+    istringstream iss(line);
+    string word, arg;
+    if (!(iss >> word) || word != "stats") return false;
+    if (iss >> arg && arg == "reset") {
+        frameStats.reset();
+        cout << "[Stats] Reset\n";
+        return true;
     }
+    frameStats.report(cout, "[Stats] ");
+    return true;
+}
 
+static const char* const CONSOLE_USAGE =
+    "       fork <matrix> [seconds]: run one copy of the current engine per matrix line\n"
+    "       stats [reset]: frame phase timings (p50/p99/max)\n";
 
-    double fuelRes = engine.getFuelReserve();
-    double fuelFlow = engine.getFuelFlow();
-    if (engine.isFuelReserveSensorInvalid()) {
-        indicators.at("FuelResFail").setActive(COLOR_RED);
-        trigger_alert("FUEL RESERVE SENSOR INVALID", COLOR_RED);
-    }
-    else if (!std::isnan(fuelRes)) {
-        if (fuelRes <= 0.0 && state != EngineState::OFF) {
-                indicators.at("LowFuel").setActive(COLOR_RED);
-                trigger_alert("FUEL DEPLETED - ENGINE SHUTDOWN", COLOR_RED);
-            }
-        else if (fuelRes < 1000.0 && state != EngineState::OFF) {
-                indicators.at("LowFuel").setActive(COLOR_AMBER);
-                trigger_alert("LOW FUEL RESERVE", COLOR_AMBER);
-            }
-        }
-    if (engine.isFuelFlowSensorInvalid()) {
-        indicators.at("FuelFlowFail").setActive(COLOR_AMBER);
-        trigger_alert("FUEL FLOW SENSOR INVALID", COLOR_AMBER);
-    }
-    else if (!std::isnan(fuelFlow) && fuelFlow > FUEL_FLOW_MAX) {
-        indicators.at("OverFF").setActive(COLOR_AMBER);
-        trigger_alert("FUEL FLOW EXCEEDED LIMIT", COLOR_AMBER);
-    }
+static bool handleConsoleCommand(const string& line) {
+    return handleForkCommand(line) || handleStatsCommand(line);
+}
 
-    double n1L_pct = engine.getN1LeftPercentage();
-    double n1R_pct = engine.getN1RightPercentage();
-    if (!std::isnan(n1L_pct)) {
-        if (n1L_pct > 120.0) {
-            indicators.at("OverSpd1").setActive(COLOR_RED);
-            trigger_alert("N1 LEFT OVERSPEED - SHUTDOWN", COLOR_RED);
-            if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
-        }
-        else if (n1L_pct > 105.0) {
-            indicators.at("OverSpd1").setActive(COLOR_AMBER);
-            trigger_alert("N1 LEFT OVERSPEED CAUTION", COLOR_AMBER);
-        }
+// ʱٵλ+/- лP ոͣͣʱ N 
+static const double TIME_SCALES[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+static const int TIME_SCALE_COUNT = sizeof(TIME_SCALES) / sizeof(TIME_SCALES[0]);
+
+static void handleTimeWarpKey(BYTE key, int& scaleIndex) {
+    if (key == VK_OEM_PLUS || key == VK_ADD) {
+        if (scaleIndex + 1 < TIME_SCALE_COUNT) ++scaleIndex;
+        simulation.setTimeScale(TIME_SCALES[scaleIndex]);
     }
-    if (!std::isnan(n1R_pct)) {
-        if (n1R_pct > 120.0) {
-            indicators.at("OverSpd2").setActive(COLOR_RED);
-            trigger_alert("N1 RIGHT OVERSPEED - SHUTDOWN", COLOR_RED);
-            if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
-        }
-        else if (n1R_pct > 105.0) {
-            indicators.at("OverSpd2").setActive(COLOR_AMBER);
-            trigger_alert("N1 RIGHT OVERSPEED CAUTION", COLOR_AMBER);
-        }
+    else if (key == VK_OEM_MINUS || key == VK_SUBTRACT) {
+        if (scaleIndex > 0) --scaleIndex;
+        simulation.setTimeScale(TIME_SCALES[scaleIndex]);
     }
-
-    bool isStartingPhase = (state == EngineState::STARTING);
-    double egtL = engine.getEgtLeft();
-    double egtR = engine.getEgtRight();
-
-    if (isStartingPhase) {
-        if ((!std::isnan(egtL) && egtL > 1000.0) || (!std::isnan(egtR) && egtR > 1000.0)) {
-            indicators.at("OverTemp2").setActive(COLOR_RED);
-            trigger_alert("EGT STARTING OVERTEMP - SHUTDOWN", COLOR_RED);
-            if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
-        }
-        else if ((!std::isnan(egtL) && egtL > 850.0) || (!std::isnan(egtR) && egtR > 850.0)) {
-            indicators.at("OverTemp1").setActive(COLOR_AMBER);
-            trigger_alert("EGT STARTING OVERTEMP CAUTION", COLOR_AMBER);
-        }
+    else if (key == 'P' || key == VK_SPACE) {
+        simulation.setPaused(!simulation.isPaused());
     }
-    else if (state == EngineState::STABLE) {
-        if ((!std::isnan(egtL) && egtL > 1100.0) || (!std::isnan(egtR) && egtR > 1100.0)) {
-            indicators.at("OverTemp4").setActive(COLOR_RED);
-            trigger_alert("EGT STABLE OVERTEMP - SHUTDOWN", COLOR_RED);
-            if (state != EngineState::STOPPING && state != EngineState::OFF) engine.stop();
-        }
-        else if ((!std::isnan(egtL) && egtL > 950.0) || (!std::isnan(egtR) && egtR > 950.0)) {
-            indicators.at("OverTemp3").setActive(COLOR_AMBER);
-            trigger_alert("EGT STABLE OVERTEMP CAUTION", COLOR_AMBER);
-        }
+    else if (key == 'N' && simulation.isPaused()) {
+        simulation.singleStep();
     }
-
-    bool stable = (engine.getState() == EngineState::STABLE);
-    if (thrust_buttons.count("ThrustUp")) thrust_buttons.at("ThrustUp").setEnabled(stable);
-    if (thrust_buttons.count("ThrustDown")) thrust_buttons.at("ThrustDown").setEnabled(stable);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     const string WINDOW_NAME = "Virtual Engine Monitor (EICAS)";
 
+    //  --replay ʱطż¼־з桢д־ָ̨ܿ
+    ReplayMode replay;
+    bool replaying = parseReplayArgs(argc, argv, replay);
+
     // EasyX ʼ
     initializeUI(WINDOW_NAME, &engine, &startButtonPressed, &stopButtonPressed, &thrust_buttons);
 
@@ -214,17 +174,33 @@ int main() {
     initializeIndicators(indicators);
     initializeButtons(thrust_buttons);
 
-    cmdThread = thread(commandLoop, ref(cmdThreadRunning), ref(engine));
+    // ʵʱģʽ·ڶ߳ϰ̶Уֻ߳ȡĿ
+    if (!replaying) {
+        loadScenarioArg(argc, argv);
+        cmdThread = thread(commandLoop, ref(cmdThreadRunning), ref(simulation.commandQueue()), ConsoleHandler(handleConsoleCommand), CONSOLE_USAGE);
+        simulation.setFrameStats(&frameStats);
+        simulation.start();
+    }
 
     vector<Gauge> gauges;
-    gauges.emplace_back(POINT{ 180, 120 }, 80, "N1_L", N1_MAX_RATED);
-    gauges.emplace_back(POINT{ 390, 120 }, 80, "N1_R", N1_MAX_RATED);
-    gauges.emplace_back(POINT{ 180, 300 }, 80, "EGT_L", EGT_MAX * 0.8);
-    gauges.emplace_back(POINT{ 390, 300 }, 80, "EGT_R", EGT_MAX * 0.8);
+    initializeGauges(gauges);
+    EasyXRenderer screen;            // ֻѱ仯ˢ
+    UiDrawCache drawCache;
 
     double lastWall = getCurrenTimeSeconds();
-    double accum = 0.0;
-    const double STEP = 0.005;
+
+    IndicatorLamps seenLamps;        // һ֡Ѿļ
+    SimFrame replayFrame;            // طʱɽ߳Լɿ
+    replayFrame.readings = readEngine(engine);
+    const IndicatorSetter lightReplayLamp = [&replayFrame](IndicatorId id, COLORREF color) {
+        replayFrame.lamps.light(id, color);
+    };
+    double replayTime = replay.from; // طŵļ¼ʱ
+    LogSample replaySample;
+    bool replayPending = false;      // replaySample Ѷûʱ
+    SimClock replayClock;            // طʱʱ¼ʱ
+    if (replaying) alertInfo.setClock(&replayClock);
+    int scaleIndex = 0;
 
     // ˫ͼ
     BeginBatchDraw();
@@ -233,43 +209,81 @@ int main() {
         double now = getCurrenTimeSeconds();
         double frameDt = now - lastWall;
         if (frameDt < 0) frameDt = 0;
-        if (frameDt > 0.05) frameDt = 0.05;
+        if (frameDt > 0.05) {
+            frameDt = 0.05;
+            frameStats.countClampedFrame();
+        }
         lastWall = now;
-        accum += frameDt;
-
-        while (accum >= STEP) {
-            engine.advance(STEP);
+        PhaseTimer frameTimer(&frameStats);
+        PhaseTimer phaseTimer(&frameStats);
+
+        const SimFrame* frame = &replayFrame;
+        if (replaying) {
+            // ȡʱ֮ǰм¼ʾһ
+            replayTime += frameDt * replay.speed;
+            if (!replayPending) replayPending = replay.source->next(replaySample);
+            while (replayPending && replaySample.timestamp <= replayTime) {
+                replayFrame.readings = readSample(replaySample);
+                // طʱͣԼ¼Ϊ׼Ӧͣ
+                evaluateAlerts(replayFrame.readings, alertInfo, lightReplayLamp);
+                replayPending = replay.source->next(replaySample);
+            }
+            replayClock.set(replayTime);
+            replayFrame.clockTime = replayTime;
+            replayFrame.timeScale = replay.speed;
             alertInfo.update();
-            logging(engine, data_log_file, alert_log_file, isLogging, alertInfo);
-            accum -= STEP;
-        }
-
-        if (startButtonPressed) {
-            engine.start();
+            captureAlerts(replayFrame, alertInfo);
             startButtonPressed = false;
-        }
-        if (stopButtonPressed) {
-            engine.stop();
             stopButtonPressed = false;
         }
+        else {
+            if (startButtonPressed) {
+                simulation.requestStart();
+                startButtonPressed = false;
+            }
+            if (stopButtonPressed) {
+                simulation.requestStop();
+                stopButtonPressed = false;
+            }
+            frame = &simulation.latestFrame();
+
+            // ָ̨ڷִ߳кرЧʱ䣻ťر
+            EngineCommand applied;
+            while (simulation.popApplied(applied)) {
+                if (applied.type >= CommandType::SET_N1_SENSOR) {
+                    cout << "[cmdThread]" << describeCommand(applied) << " applied at t=" << applied.appliedAt << " s\n";
+                }
+            }
+        }
+
+        phaseTimer.lap(PHASE_FRAME_READ);
 
-        updateIndicators(engine, indicators);
+        applyLamps(frame->lamps, seenLamps, frame->clockTime, indicators);
+        updateIndicators(frame->readings, frame->clockTime, indicators, thrust_buttons);
+        phaseTimer.lap(PHASE_UPDATE_INDICATORS);
 
-        // EasyX ͼ
-        drawUI(gauges, indicators, thrust_buttons, engine, alertInfo);
+        // ֻػ仯Ĳ
+        drawUI(screen, drawCache, gauges, indicators, thrust_buttons, *frame);
+        phaseTimer.lap(PHASE_DRAW_UI);
 
-        // Ϣ
+        // ͰϢ
         ExMessage msg;
-        while (peekmessage(&msg, EM_MOUSE)) {
+        while (peekmessage(&msg, EM_MOUSE | EM_KEY)) {
             if (msg.message == WM_LBUTTONDOWN) {
-                handleMouseClick(msg.x, msg.y, &engine, &startButtonPressed, &stopButtonPressed, &thrust_buttons);
+                handleMouseClick(msg.x, msg.y, replaying ? nullptr : &simulation, &startButtonPressed, &stopButtonPressed, &thrust_buttons);
+            }
+            else if (msg.message == WM_KEYDOWN && !replaying) {
+                handleTimeWarpKey(msg.vkcode, scaleIndex);
             }
         }
         if (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
             cmdThreadRunning = false;
         }
+        phaseTimer.lap(PHASE_MESSAGES);
 
         Sleep(1); 
+        phaseTimer.lap(PHASE_SLEEP);
+        frameTimer.lap(PHASE_FRAME);
     }
 
     EndBatchDraw();
@@ -280,10 +294,9 @@ int main() {
         cmdThread.detach();  // ֹ߳ȴ
     }
 
-    if (isLogging) {
-        if (data_log_file.is_open()) data_log_file.close();
-        if (alert_log_file.is_open()) alert_log_file.close();
-    }
+    simulation.stop(); // ͬʱرд־
+
+    frameStats.report(cout, "[Stats] ");
 
     return 0;
 }
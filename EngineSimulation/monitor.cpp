@@ -0,0 +1,92 @@
+﻿#include "monitor.h"
+#include "alert_rules.h"
+#include "vote.h"
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+static int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+const EngineSnapshot& readEngine(const Engine& engine) {
+    return engine.getSnapshot();
+}
+
+EngineSnapshot readSample(const LogSample& sample) {
+    // 列顺序见 captureSample：每台引擎依次为 N1 S1/S2/显示、EGT S1/S2/显示
+    EngineSnapshot r;
+    r.state = sample.state;
+    r.simTime = sample.timestamp;
+    for (int e = 0; e < 2; ++e) {
+        const double* v = sample.values + e * 6;
+        r.n1Anomal[e][0] = std::isnan(v[0]);
+        r.n1Anomal[e][1] = std::isnan(v[1]);
+        r.n1[e] = v[2];
+        r.egtAnomal[e][0] = std::isnan(v[3]);
+        r.egtAnomal[e][1] = std::isnan(v[4]);
+        r.egt[e] = v[5];
+        r.n1Percent[e] = v[2] / N1_MAX_RATED * 100.0; // NaN 时仍为 NaN
+        r.n1Sensor[e][0] = v[0];
+        r.n1Sensor[e][1] = v[1];
+        r.egtSensor[e][0] = v[3];
+        r.egtSensor[e][1] = v[4];
+    }
+    // 显示值取记录的列；不一致标志没有记录，用记录的传感器读数重新判定，与实时仿真的结果相同
+    const int E = TwinConfig::ENGINES, S = TwinConfig::SENSORS;
+    double column[S][2 * E];
+    const double* rows[S];
+    for (int s = 0; s < S; ++s) {
+        for (int e = 0; e < E; ++e) {
+            column[s][e] = r.n1Sensor[e][s];
+            column[s][E + e] = r.egtSensor[e][s];
+        }
+        rows[s] = column[s];
+    }
+    double voted[2 * E];
+    uint8_t disagree[2 * E];
+    voteMidValue<S>(rows, 2 * E, voted, disagree);
+    for (int e = 0; e < E; ++e) {
+        r.n1Disagree[e] = disagree[e] != 0;
+        r.egtDisagree[e] = disagree[E + e] != 0;
+    }
+    r.fuelFlow = sample.values[12];
+    r.fuelReserve = sample.values[13];
+    r.fuelFlowInvalid = std::isnan(r.fuelFlow);
+    r.fuelReserveInvalid = std::isnan(r.fuelReserve);
+    return r;
+}
+
+template <class Config>
+void evaluateAlerts(EngineModel<Config>& engine, AlertInfo& alertInfo, const IndicatorSetter& setIndicator) {
+    const BasicEngineSnapshot<Config>& readings = engine.getSnapshot();
+    if (evaluateAlerts(readings, alertInfo, setIndicator)) {
+        if (readings.state != EngineState::STOPPING && readings.state != EngineState::OFF) engine.stop();
+    }
+}
+
+template <class Config>
+bool evaluateAlerts(const BasicEngineSnapshot<Config>& r, AlertInfo& alertInfo, const IndicatorSetter& setIndicator) {
+    const AlertProgram& program = defaultAlertProgram<Config>();
+    AlertResult result = program.evaluate(r);
+    // 按规则顺序点亮指示灯、触发警报（所有命中的警报都触发，而不是只保留最高优先级）
+    for (uint64_t fired = result.fired; fired != 0; fired &= fired - 1) {
+        size_t i = static_cast<size_t>(countTrailingZeros(fired)); // 最低位的命中规则
+        setIndicator(program.indicator(i), program.color(i));
+        alertInfo.triggerAlert(program.alert(i), program.color(i));
+    }
+    return result.shutdown;
+}
+
+#define INSTANTIATE_EVALUATE_ALERTS(C) \
+    template bool evaluateAlerts<C>(const BasicEngineSnapshot<C>&, AlertInfo&, const IndicatorSetter&); \
+    template void evaluateAlerts<C>(EngineModel<C>&, AlertInfo&, const IndicatorSetter&);
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_EVALUATE_ALERTS)
@@ -0,0 +1,23 @@
+﻿#pragma once
+#include <string>
+#include <functional>
+#include "engine.h"
+#include "alert.h"
+#include "log.h"
+#include "indicators.h"
+
+// 指示灯回调：参数为指示灯编号和颜色
+typedef std::function<void(IndicatorId, COLORREF)> IndicatorSetter;
+
+// 告警判定和界面显示用到的读数都是 EngineSnapshot，可以来自实时仿真，也可以来自记录的数据日志
+const EngineSnapshot& readEngine(const Engine& engine); // 即 engine.getSnapshot()
+// 从记录的一行还原读数：日志中异常传感器和无效燃油传感器都记为 NaN
+EngineSnapshot readSample(const LogSample& sample);
+
+// 告警判定：执行该配置的 defaultAlertProgram，按命中的规则触发警报、点亮指示灯，满足停机条件时返回 true，不修改引擎
+template <class Config>
+bool evaluateAlerts(const BasicEngineSnapshot<Config>& readings, AlertInfo& alertInfo, const IndicatorSetter& setIndicator);
+// 实时仿真用：判定后在需要停机时调用 engine.stop()
+// 不依赖图形库，界面程序和无界面工具共用；两个模板都在 monitor.cpp 中按 FOR_EACH_ENGINE_CONFIG 显式实例化
+template <class Config>
+void evaluateAlerts(EngineModel<Config>& engine, AlertInfo& alertInfo, const IndicatorSetter& setIndicator);
@@ -0,0 +1,69 @@
+﻿#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// 多生产者/单消费者无锁有界队列
+// 每个槽位带序号：生产者用 CAS 抢占 head 后写入并发布序号，消费者按序号判断槽位是否已写好，容量必须为 2 的幂
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) {
+        // 容量不是 2 的幂时向上取整
+        size_t c = 1;
+        while (c < capacity) c <<= 1;
+        cells.reset(new Cell[c]);
+        mask = c - 1;
+        for (size_t i = 0; i < c; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 任意线程调用，队列满时返回 false
+    bool tryPush(const T& item) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // 槽位还没被消费者取走
+            }
+            else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只由消费者线程调用，队列空时返回 false
+    bool tryPop(T& item) {
+        Cell& cell = cells[tail & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+        item = cell.data;
+        cell.sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{ 0 }; // 下一个写入位置，生产者之间竞争
+    alignas(64) size_t tail = 0;               // 下一个读取位置，只由消费者访问
+};
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include <algorithm>
+#include "colors.h"
+
+// 绘图后端接口：界面部件只通过它绘图，EasyX 窗口和软件帧缓冲各有一个实现
+// 坐标、角度和填充规则与 EasyX 相同：矩形包含右下角，角度为弧度、逆时针、0 指向右方
+struct RenderPoint {
+    int x, y;
+};
+
+struct RenderRect {
+    int left, top, right, bottom;
+
+    bool empty() const { return right < left || bottom < top; }
+};
+
+inline RenderRect unionRect(const RenderRect& a, const RenderRect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return { std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+const RenderRect EMPTY_RECT = { 0, 0, -1, -1 };
+
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    virtual void setLineColor(COLORREF color) = 0;
+    virtual void setFillColor(COLORREF color) = 0;
+    virtual void setTextColor(COLORREF color) = 0;
+    virtual void setTextStyle(int height, const wchar_t* face) = 0; // 字高（像素）和字体名
+
+    virtual void rectangle(int left, int top, int right, int bottom) = 0;      // 边框，线条色
+    virtual void solidRectangle(int left, int top, int right, int bottom) = 0; // 填充色，无边框
+    virtual void pie(int left, int top, int right, int bottom, double startAngle, double endAngle) = 0;      // 扇形边框
+    virtual void solidPie(int left, int top, int right, int bottom, double startAngle, double endAngle) = 0; // 实心扇形
+    virtual void fillPolygon(const RenderPoint* points, int count) = 0; // 线条色边框 + 填充色
+    virtual void outText(int x, int y, const wchar_t* text) = 0;        // 透明背景
+    virtual int textWidth(const wchar_t* text) = 0;
+    virtual int textHeight(const wchar_t* text) = 0;
+
+    virtual void clear() = 0;                         // 整个画面填背景色
+    virtual void clearRect(const RenderRect& rect) = 0; // 局部填背景色，部件重画前调用
+
+    // 把本帧画过的区域送到屏幕（或交给调用方保存），然后清空脏区域
+    virtual void present() = 0;
+
+    // 自上次 present 以来画过的区域的外接矩形
+    const RenderRect& dirtyRect() const { return dirty; }
+
+protected:
+    void markDirty(int left, int top, int right, int bottom) {
+        RenderRect r = { std::max(left, 0), std::max(top, 0), std::min(right, width() - 1), std::min(bottom, height() - 1) };
+        dirty = unionRect(dirty, r);
+    }
+    void clearDirty() { dirty = EMPTY_RECT; }
+
+private:
+    RenderRect dirty = EMPTY_RECT;
+};
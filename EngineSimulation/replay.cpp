@@ -0,0 +1,196 @@
+﻿#include "replay.h"
+#include <cstring>
+#include <charconv>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+using namespace std;
+
+static bool endsWith(const string& s, const char* suffix) {
+	size_t n = strlen(suffix);
+	return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+unique_ptr<ReplaySource> openReplaySource(const string& path, string& error) {
+	if (endsWith(path, ".etl")) {
+		unique_ptr<TelemetryReplaySource> source(new TelemetryReplaySource());
+		if (source->open(path)) return source;
+		error = source->error();
+	}
+	else if (endsWith(path, ".elz")) {
+		unique_ptr<CompressedReplaySource> source(new CompressedReplaySource());
+		if (source->open(path)) return source;
+		error = source->error();
+	}
+	else {
+		unique_ptr<CsvReplaySource> source(new CsvReplaySource());
+		if (source->open(path)) return source;
+		error = source->error();
+	}
+	return nullptr;
+}
+
+// -----CSV-----
+
+// 解析一个字段，p 指向字段开头，返回字段结束处（逗号或行尾）
+static const char* parseValue(const char* p, const char* end, double& value) {
+	if (end - p >= 3 && memcmp(p, "NaN", 3) == 0) {
+		value = numeric_limits<double>::quiet_NaN();
+		p += 3;
+	}
+	else {
+		from_chars_result r = from_chars(p, end, value);
+		if (r.ec != errc()) value = numeric_limits<double>::quiet_NaN();
+		p = r.ptr;
+	}
+	while (p < end && *p != ',' && *p != '\n') ++p;
+	return p;
+}
+
+static EngineState parseState(const char* p, const char* end) {
+	size_t n = 0;
+	while (p + n < end && p[n] != '\r' && p[n] != '\n') ++n;
+	string text(p, n);
+	if (text == "STARTING") return EngineState::STARTING;
+	if (text == "STABLE") return EngineState::STABLE;
+	if (text == "STOPPING") return EngineState::STOPPING;
+	return EngineState::OFF;
+}
+
+bool CsvReplaySource::open(const string& path) {
+	lastError.clear();
+	if (!mapped.open(path)) {
+		lastError = "cannot map file " + path;
+		return false;
+	}
+	const char* data = reinterpret_cast<const char*>(mapped.data());
+	size_t size = mapped.size();
+	const char* eol = static_cast<const char*>(memchr(data, '\n', size));
+	if (eol == nullptr) {
+		lastError = "missing CSV header";
+		mapped.close();
+		return false;
+	}
+	// 表头必须与 logDataHeader 一致，列顺序才能对上
+	ostringstream expected;
+	expected << "Timestamp,";
+	for (int i = 0; i < LOG_VALUE_COUNT; ++i) expected << LOG_COLUMN_NAMES[i] << ",";
+	expected << "State";
+	string header(data, eol);
+	if (!header.empty() && header.back() == '\r') header.pop_back();
+	if (header != expected.str()) {
+		lastError = "unexpected CSV header";
+		mapped.close();
+		return false;
+	}
+	dataStart = static_cast<size_t>(eol - data) + 1;
+	pos = dataStart;
+	return true;
+}
+
+bool CsvReplaySource::next(LogSample& sample) {
+	const char* data = reinterpret_cast<const char*>(mapped.data());
+	const char* end = data + mapped.size();
+	const char* p = data + pos;
+	// 跳过空行
+	while (p < end && (*p == '\n' || *p == '\r')) ++p;
+	if (p >= end) {
+		pos = mapped.size();
+		return false;
+	}
+	const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+	if (eol == nullptr) eol = end;
+
+	p = parseValue(p, eol, sample.timestamp);
+	for (int i = 0; i < LOG_VALUE_COUNT; ++i) {
+		if (p < eol) ++p; // 逗号
+		p = parseValue(p, eol, sample.values[i]);
+	}
+	if (p < eol) ++p;
+	sample.state = parseState(p, eol);
+	pos = (eol < end) ? static_cast<size_t>(eol - data) + 1 : mapped.size();
+	return true;
+}
+
+size_t CsvReplaySource::lineStartAtOrAfter(size_t at) const {
+	const uint8_t* data = mapped.data();
+	if (at <= dataStart) return dataStart;
+	if (at >= mapped.size() || data[at - 1] == '\n') return at;
+	const void* eol = memchr(data + at, '\n', mapped.size() - at);
+	return eol ? static_cast<size_t>(static_cast<const uint8_t*>(eol) - data) + 1 : mapped.size();
+}
+
+double CsvReplaySource::timestampAt(size_t lineStart) const {
+	const char* p = reinterpret_cast<const char*>(mapped.data()) + lineStart;
+	const char* end = reinterpret_cast<const char*>(mapped.data()) + mapped.size();
+	double t;
+	parseValue(p, end, t);
+	return t;
+}
+
+void CsvReplaySource::seek(double time) {
+	// 谓词“该位置之后第一行的时间戳 >= time”随偏移单调，二分找到最小的满足位置
+	size_t lo = dataStart, hi = mapped.size();
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		size_t line = lineStartAtOrAfter(mid);
+		if (line >= mapped.size() || timestampAt(line) >= time) {
+			hi = mid;
+		}
+		else {
+			lo = line + 1;
+		}
+	}
+	pos = lineStartAtOrAfter(lo);
+}
+
+// -----二进制遥测-----
+
+bool TelemetryReplaySource::open(const string& path) {
+	row = 0;
+	return reader.open(path);
+}
+
+bool TelemetryReplaySource::next(LogSample& sample) {
+	if (row >= reader.rowCount()) return false;
+	sample = reader.sample(row++);
+	return true;
+}
+
+void TelemetryReplaySource::seek(double time) {
+	size_t c = reader.findChunk(time);
+	row = 0;
+	for (size_t i = 0; i < c; ++i) row += reader.chunk(i).rows;
+	if (c >= reader.chunkCount()) return;
+	const TelemetryChunk& chunk = reader.chunk(c);
+	const double* t = chunk.f64(0);
+	row += static_cast<size_t>(lower_bound(t, t + chunk.rows, time) - t);
+}
+
+// -----压缩日志-----
+
+bool CompressedReplaySource::open(const string& file) {
+	path = file;
+	hasPending = false;
+	return reader.open(path);
+}
+
+bool CompressedReplaySource::next(LogSample& sample) {
+	if (hasPending) {
+		sample = pending;
+		hasPending = false;
+		return true;
+	}
+	return reader.next(sample);
+}
+
+void CompressedReplaySource::seek(double time) {
+	reader.open(path);
+	hasPending = false;
+	while (reader.next(pending)) {
+		if (pending.timestamp >= time) {
+			hasPending = true;
+			return;
+		}
+	}
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <string>
+#include <memory>
+#include "log.h"
+#include "telemetry.h"
+#include "log_codec.h"
+
+// 回放数据源：按时间顺序逐行读出记录的样本
+// CSV 和 .etl 通过内存映射读取，不把整个文件读入内存；.elz 只能顺序解码
+class ReplaySource {
+public:
+    virtual ~ReplaySource() = default;
+    // 读出下一行，没有更多数据时返回 false
+    virtual bool next(LogSample& sample) = 0;
+    // 定位到第一条时间戳 >= time 的记录
+    virtual void seek(double time) = 0;
+    virtual const std::string& error() const = 0;
+};
+
+// 按文件扩展名打开 .csv / .etl / .elz，失败时返回空指针并写入 error
+std::unique_ptr<ReplaySource> openReplaySource(const std::string& path, std::string& error);
+
+// engine_data_*.csv，文件中的行按时间戳递增
+class CsvReplaySource : public ReplaySource {
+public:
+    bool open(const std::string& path);
+    bool next(LogSample& sample) override;
+    void seek(double time) override; // 在字节偏移上二分查找，不需要索引
+    const std::string& error() const override { return lastError; }
+
+private:
+    size_t lineStartAtOrAfter(size_t pos) const;
+    double timestampAt(size_t lineStart) const;
+
+    MappedFile mapped;
+    size_t dataStart = 0; // 表头之后第一行的偏移
+    size_t pos = 0;
+    std::string lastError;
+};
+
+class TelemetryReplaySource : public ReplaySource {
+public:
+    bool open(const std::string& path);
+    bool next(LogSample& sample) override;
+    void seek(double time) override; // 先按块的时间范围定位，再在块内二分
+    const std::string& error() const override { return reader.error(); }
+
+private:
+    TelemetryReader reader;
+    size_t row = 0;
+};
+
+class CompressedReplaySource : public ReplaySource {
+public:
+    bool open(const std::string& path);
+    bool next(LogSample& sample) override;
+    void seek(double time) override; // 从头解码并跳过更早的行
+    const std::string& error() const override { return reader.error(); }
+
+private:
+    std::string path;
+    CompressedLogReader reader;
+    LogSample pending;
+    bool hasPending = false;
+};
@@ -0,0 +1,70 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+// Philox4x32-10 计数器随机数（Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"）
+// 输出只由 (key, counter) 决定，不依赖调用顺序和线程数，可随机访问、可批量生成
+typedef std::array<uint32_t, 4> PhiloxBlock;
+
+inline PhiloxBlock philox4x32(uint64_t key, uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3) {
+	const uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+	const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+	uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+	for (int round = 0; round < 10; ++round) {
+		uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+		uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+		uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+		uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+		c1 = static_cast<uint32_t>(p1);
+		c3 = static_cast<uint32_t>(p0);
+		c0 = n0;
+		c2 = n2;
+		k0 += W0;
+		k1 += W1;
+	}
+	return { c0, c1, c2, c3 };
+}
+
+// 把 32 位随机数映射到 [0, n)，乘法取高位，与 rand() % n 用法对应
+inline int uniformInt(uint32_t x, uint32_t n) {
+	return static_cast<int>((static_cast<uint64_t>(x) * n) >> 32);
+}
+
+// 顺序使用的随机数流：seed 作为 key，stream 区分同一 seed 下互不相关的流
+class PhiloxRng {
+public:
+	explicit PhiloxRng(uint64_t seed = 0, uint32_t stream = 0) : seed(seed), stream(stream) {}
+
+	uint32_t next() {
+		if (index == 4) {
+			buffer = philox4x32(seed, static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), stream, 0);
+			++counter;
+			index = 0;
+		}
+		return buffer[index++];
+	}
+
+	// 一次取出 count 个数，用于每步批量生成噪声
+	void fill(uint32_t* out, size_t count) {
+		for (size_t i = 0; i < count; ++i) out[i] = next();
+	}
+
+	uint64_t getSeed() const { return seed; }
+	uint32_t getStream() const { return stream; }
+
+	// 当前位置（已消耗的随机数个数），用于保存和恢复
+	uint64_t position() const { return counter * 4 - (4 - index); }
+	void seek(uint64_t pos) {
+		counter = pos / 4;
+		index = 4;
+		for (uint64_t i = 0; i < pos % 4; ++i) next();
+	}
+
+private:
+	uint64_t seed;
+	uint32_t stream;
+	uint64_t counter = 0;
+	PhiloxBlock buffer = { 0, 0, 0, 0 };
+	int index = 4;
+};
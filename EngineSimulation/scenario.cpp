@@ -0,0 +1,110 @@
+﻿#include "scenario.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+static string trim(const string& s) {
+	size_t b = s.find_first_not_of(" \t\r\n");
+	if (b == string::npos) return "";
+	size_t e = s.find_last_not_of(" \t\r\n");
+	return s.substr(b, e - b + 1);
+}
+
+bool parseScenarioEvent(const string& text, ScenarioEvent& event, string& error, const EngineLayout& layout) {
+	istringstream iss(text);
+	if (!(iss >> event.time) || !isfinite(event.time) || event.time < 0.0) {
+		error = "expected '<time> <command>', got '" + trim(text) + "'";
+		return false;
+	}
+	string command;
+	getline(iss, command);
+	command = trim(command);
+	ostringstream message;
+	if (!parseCommand(command, event.command, message, layout)) {
+		error = "invalid command '" + command + "'";
+		string detail = message.str();
+		if (!detail.empty()) error += "\n" + detail.substr(0, detail.find_last_not_of('\n') + 1);
+		return false;
+	}
+	return true;
+}
+
+bool loadScenario(const string& path, vector<ScenarioEvent>& events, string& error, const EngineLayout& layout) {
+	ifstream in(path);
+	if (!in.is_open()) {
+		error = "cannot open " + path;
+		return false;
+	}
+	string line;
+	int lineNo = 0;
+	while (getline(in, line)) {
+		++lineNo;
+		line = trim(line);
+		if (line.empty() || line[0] == '#') continue;
+		ScenarioEvent event;
+		if (!parseScenarioEvent(line, event, error, layout)) {
+			error = "line " + to_string(lineNo) + ": " + error;
+			return false;
+		}
+		events.push_back(event);
+	}
+	return true;
+}
+
+bool loadScenarioMatrix(const string& path, vector<ScenarioCase>& cases, string& error, const EngineLayout& layout) {
+	ifstream in(path);
+	if (!in.is_open()) {
+		error = "cannot open " + path;
+		return false;
+	}
+	string line;
+	int lineNo = 0;
+	while (getline(in, line)) {
+		++lineNo;
+		line = trim(line);
+		if (line.empty() || line[0] == '#') continue;
+
+		size_t colon = line.find(':');
+		if (colon == string::npos) {
+			error = "line " + to_string(lineNo) + ": missing ':' after scenario name";
+			return false;
+		}
+		ScenarioCase sc;
+		sc.name = trim(line.substr(0, colon));
+		istringstream items(line.substr(colon + 1));
+		string item;
+		while (getline(items, item, ';')) {
+			item = trim(item);
+			if (item.empty()) continue;
+			ScenarioEvent event;
+			if (!parseScenarioEvent(item, event, error, layout)) {
+				error = "line " + to_string(lineNo) + ": " + error;
+				return false;
+			}
+			sc.events.push_back(event);
+		}
+		cases.push_back(sc);
+	}
+	return true;
+}
+
+ScenarioPlayer::ScenarioPlayer(vector<ScenarioEvent> scenarioEvents) : events(move(scenarioEvents)) {
+	stable_sort(events.begin(), events.end(),
+		[](const ScenarioEvent& a, const ScenarioEvent& b) { return a.time < b.time; });
+}
+
+template <class Config>
+size_t ScenarioPlayer::applyDue(EngineModel<Config>& engine, double now) {
+	size_t applied = 0;
+	while (next < events.size() && events[next].time <= now) {
+		applyCommand(events[next].command, engine);
+		++next;
+		++applied;
+	}
+	return applied;
+}
+
+#define INSTANTIATE_APPLY_DUE(C) template size_t ScenarioPlayer::applyDue<C>(EngineModel<C>&, double);
+FOR_EACH_ENGINE_CONFIG(INSTANTIATE_APPLY_DUE)
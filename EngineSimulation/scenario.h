@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+#include "engine.h"
+#include "event.h"
+
+// 故障剧本：按仿真时间排列的指令，每步推进前执行时间已到的指令，相同种子下结果可完全重现
+// 文件格式：每行 "<仿真秒> <指令>"，'#' 开头为注释；指令为 start、stop、thrust up/down 以及控制台支持的 set/reset
+//   0    start
+//   30   set N1_L1 fail
+//   45.5 reset N1_L1
+struct ScenarioEvent {
+    double time;
+    EngineCommand command;
+};
+
+// 解析一条 "<仿真秒> <指令>"，失败时 error 为错误说明；传感器目标按 layout 命名（见 parseCommand）
+bool parseScenarioEvent(const std::string& text, ScenarioEvent& event, std::string& error, const EngineLayout& layout = TWIN_LAYOUT);
+// 读取剧本文件，失败时 error 带行号
+bool loadScenario(const std::string& path, std::vector<ScenarioEvent>& events, std::string& error, const EngineLayout& layout = TWIN_LAYOUT);
+
+// 故障矩阵：每行一个命名的剧本，'#' 开头为注释，批量运行和分叉实验共用
+//   <名称>: <时间> <指令>; <时间> <指令>; ...
+//   dual_n1_left: 10 set N1_L1 fail; 20 set N1_L2 fail
+struct ScenarioCase {
+    std::string name;
+    std::vector<ScenarioEvent> events;
+};
+
+// 读取故障矩阵，失败时 error 带行号
+bool loadScenarioMatrix(const std::string& path, std::vector<ScenarioCase>& cases, std::string& error, const EngineLayout& layout = TWIN_LAYOUT);
+
+// 剧本执行器：同一时刻的指令按文件中的顺序执行
+// 剧本时间从运行开始计，由调用者传入；不用 Engine::getSimTime，因为 start 会把仿真时间清零
+class ScenarioPlayer {
+public:
+    ScenarioPlayer() = default;
+    explicit ScenarioPlayer(std::vector<ScenarioEvent> events);
+
+    // 在 engine.advance 之前调用，执行 time <= now 的指令，返回执行的条数；按 FOR_EACH_ENGINE_CONFIG 显式实例化
+    template <class Config>
+    size_t applyDue(EngineModel<Config>& engine, double now);
+    bool finished() const { return next >= events.size(); }
+    size_t size() const { return events.size(); }
+
+private:
+    std::vector<ScenarioEvent> events;
+    size_t next = 0;
+};
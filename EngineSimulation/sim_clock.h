@@ -0,0 +1,13 @@
+﻿#pragma once
+#include <atomic>
+
+// 计时器共用的时钟：由推进仿真的一方设置为运行时间（秒），指示灯保持、警报过期和日志限频都按它计时
+// 时间加速或暂停时这些计时器跟着一起变；一个线程写，其他线程可以同时读
+class SimClock {
+public:
+    double now() const { return seconds.load(std::memory_order_acquire); }
+    void set(double value) { seconds.store(value, std::memory_order_release); }
+
+private:
+    std::atomic<double> seconds{ 0.0 };
+};
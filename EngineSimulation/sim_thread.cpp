@@ -0,0 +1,219 @@
+﻿#include "sim_thread.h"
+#include "log.h"
+#include "async_log.h"
+#include <chrono>
+using namespace std;
+
+const double SimulationThread::MAX_LAG = 0.25;
+const double SimulationThread::MAX_BATCH = 1.0 / 60.0;
+const double SimulationThread::MIN_TIME_SCALE = 1.0;
+const double SimulationThread::MAX_TIME_SCALE = 1000.0;
+
+void IndicatorLamps::light(IndicatorId id, COLORREF color) {
+	int level = 0;
+	if (color == COLOR_RED) level = 2;
+	else if (color == COLOR_AMBER) level = 1;
+	++lit[id][level];
+}
+
+COLORREF IndicatorLamps::levelColor(int level) {
+	static const COLORREF colors[LAMP_LEVELS] = { COLOR_WHITE, COLOR_AMBER, COLOR_RED };
+	return colors[level];
+}
+
+void captureAlerts(SimFrame& frame, const AlertInfo& alertInfo) {
+	frame.alertCount = alertInfo.copyHistory(frame.alerts, ALERT_HISTORY_MAX);
+}
+
+SimulationThread::SimulationThread(Engine& engine, AlertInfo& alertInfo, AsyncLogger& logger, double step)
+	: engine(engine), alertInfo(alertInfo), logger(logger), stepSize(step), commands(4096), applied(1024) {
+	lightLamp = [this](IndicatorId id, COLORREF color) { lamps.light(id, color); };
+	alertInfo.setClock(&clock);
+	// 启动前先发布一帧，界面第一帧就有数据可画
+	lastReadings = readEngine(engine);
+	publish();
+}
+
+SimulationThread::~SimulationThread() {
+	stop();
+}
+
+void SimulationThread::start() {
+	if (running.exchange(true)) return;
+	{
+		lock_guard<mutex> lock(snapshotMutex);
+		workerActive = true;
+	}
+	worker = thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+	if (!running.exchange(false)) return;
+	if (worker.joinable()) worker.join();
+	{
+		// running 清零后仿真线程可能还在 step()，join 之后调用线程才能自己保存快照
+		lock_guard<mutex> lock(snapshotMutex);
+		workerActive = false;
+	}
+	serveSnapshots(); // 退出前收到的请求
+	if (isLogging) {
+		logger.close();
+		isLogging = false;
+	}
+}
+
+void SimulationThread::setTimeScale(double scale) {
+	if (!(scale >= MIN_TIME_SCALE)) scale = MIN_TIME_SCALE;
+	if (scale > MAX_TIME_SCALE) scale = MAX_TIME_SCALE;
+	timeScale.store(scale, memory_order_relaxed);
+}
+
+future<vector<uint8_t>> SimulationThread::requestSnapshot() {
+	promise<vector<uint8_t>> request;
+	future<vector<uint8_t>> result = request.get_future();
+	lock_guard<mutex> lock(snapshotMutex);
+	if (!workerActive) {
+		// 持锁保存，start 要等保存完才能启动仿真线程
+		vector<uint8_t> snapshot;
+		engine.saveSnapshot(snapshot);
+		request.set_value(move(snapshot));
+		return result;
+	}
+	snapshotRequests.push_back(move(request));
+	snapshotPending.store(true, memory_order_release);
+	return result;
+}
+
+void SimulationThread::serveSnapshots() {
+	if (!snapshotPending.load(memory_order_acquire)) return;
+	vector<promise<vector<uint8_t>>> requests;
+	{
+		lock_guard<mutex> lock(snapshotMutex);
+		requests.swap(snapshotRequests);
+		snapshotPending.store(false, memory_order_relaxed);
+	}
+	if (requests.empty()) return;
+	vector<uint8_t> snapshot;
+	engine.saveSnapshot(snapshot);
+	for (auto& request : requests) request.set_value(snapshot);
+}
+
+const SimFrame& SimulationThread::latestFrame() {
+	frames.update();
+	return frames.read();
+}
+
+bool SimulationThread::requestStart() {
+	EngineCommand command;
+	command.type = CommandType::START;
+	return submit(command);
+}
+
+bool SimulationThread::requestStop() {
+	EngineCommand command;
+	command.type = CommandType::STOP;
+	return submit(command);
+}
+
+bool SimulationThread::requestThrust(int direction) {
+	EngineCommand command;
+	command.type = direction > 0 ? CommandType::THRUST_UP : CommandType::THRUST_DOWN;
+	return submit(command);
+}
+
+void SimulationThread::applyCommands() {
+	EngineCommand command;
+	while (commands.tryPop(command)) {
+		applyCommand(command, engine);
+		command.appliedAt = engine.getSimTime();
+		applied.tryPush(command);
+		++commandsApplied;
+	}
+}
+
+void SimulationThread::step() {
+	PhaseTimer timer(stats);
+	scenario.applyDue(engine, steps * stepSize);
+	applyCommands();
+	engine.advance(stepSize);
+	++steps;
+	clock.set(steps * stepSize);
+	EngineSnapshot readings = readEngine(engine);
+	if (evaluateAlerts(readings, alertInfo, lightLamp) && readings.state != EngineState::STOPPING && readings.state != EngineState::OFF) {
+		engine.stop();
+		readings.state = engine.getState();
+	}
+	alertInfo.update();
+	PhaseTimer loggingTimer(stats);
+	logging(engine, logger, isLogging, alertInfo);
+	loggingTimer.lap(PHASE_LOGGING);
+	lastReadings = readings;
+	timer.lap(PHASE_SIM_STEP);
+}
+
+void SimulationThread::publish() {
+	SimFrame& frame = frames.writeBuffer();
+	frame.step = steps;
+	frame.simTime = engine.getSimTime();
+	frame.clockTime = clock.now();
+	frame.timeScale = getTimeScale();
+	frame.paused = isPaused();
+	frame.readings = lastReadings;
+	frame.lamps = lamps;
+	captureAlerts(frame, alertInfo);
+	frame.droppedSteps = droppedSteps;
+	frame.commandsApplied = commandsApplied;
+	frames.publish();
+}
+
+void SimulationThread::run() {
+	typedef chrono::steady_clock Clock;
+	auto last = Clock::now();
+	double owed = 0.0; // 按墙钟和倍数应推进、还没推进的仿真时间
+	double stepCost = 0.0; // 最近每步的墙钟耗时（秒），用于把积压折合成追赶所需的墙钟
+	while (running.load(memory_order_acquire)) {
+		auto now = Clock::now();
+		double real = chrono::duration<double>(now - last).count();
+		last = now;
+		serveSnapshots();
+
+		if (isPaused()) {
+			owed = 0.0;
+			int requested = stepRequests.exchange(0, memory_order_acq_rel);
+			for (int i = 0; i < requested; ++i) step();
+			publish(); // 暂停时也发布，界面能看到暂停状态和单步结果
+			this_thread::sleep_for(chrono::milliseconds(1));
+			continue;
+		}
+
+		stepRequests.store(0, memory_order_relaxed); // 单步只在暂停时有效
+		double scale = getTimeScale();
+		owed += real * scale;
+		if (owed > MAX_LAG * scale || owed / stepSize * stepCost > MAX_LAG) {
+			// 被系统挂起、调试器暂停过，或倍数太高每步算不过来，放弃追赶
+			droppedSteps += static_cast<uint64_t>(owed / stepSize);
+			owed = 0.0;
+		}
+		// 一批最多 MAX_BATCH 秒墙钟，剩下的留到下一轮，中间先发布一帧、响应快照请求
+		uint64_t batchSteps = 0;
+		auto deadline = now + chrono::duration_cast<Clock::duration>(chrono::duration<double>(MAX_BATCH));
+		PhaseTimer batchTimer(stats);
+		while (owed >= stepSize) {
+			step();
+			owed -= stepSize;
+			++batchSteps;
+			if ((batchSteps & 63) == 0 && Clock::now() >= deadline) break; // 每 64 步看一次表
+		}
+		if (batchSteps > 0) {
+			publish();
+			batchTimer.lap(PHASE_SIM_BATCH);
+			double cost = chrono::duration<double>(Clock::now() - now).count() / batchSteps;
+			stepCost = (stepCost > 0.0) ? 0.9 * stepCost + 0.1 * cost : cost;
+		}
+
+		// 离下一步还有 1 ms 以上时休眠，否则只让出时间片
+		double wait = (stepSize - owed) / scale;
+		if (wait > 0.001) this_thread::sleep_for(chrono::duration<double>(wait));
+		else this_thread::yield();
+	}
+}
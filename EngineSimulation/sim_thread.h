@@ -0,0 +1,135 @@
+﻿#pragma once
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <vector>
+#include <cstdint>
+#include "engine.h"
+#include "alert.h"
+#include "monitor.h"
+#include "indicators.h"
+#include "triple_buffer.h"
+#include "event.h"
+#include "spsc_ring.h"
+#include "scenario.h"
+#include "sim_clock.h"
+#include "frame_stats.h"
+
+class AsyncLogger;
+
+// 指示灯点亮计数：仿真线程每点亮一次对应颜色级别的计数加一，界面比较前后两帧的计数决定要点亮哪些灯
+// 按级别分开计数，两帧之间先后出现的不同颜色都不会丢失
+const int LAMP_LEVELS = 3; // 白、琥珀、红，优先级递增
+
+struct IndicatorLamps {
+    uint32_t lit[INDICATOR_COUNT][LAMP_LEVELS] = {};
+
+    void light(IndicatorId id, COLORREF color);
+    static COLORREF levelColor(int level);
+};
+
+// 仿真线程每步发布的只读快照，界面只读快照，不再直接访问 Engine 和 AlertInfo
+struct SimFrame {
+    uint64_t step = 0;
+    double simTime = 0.0;                // 发动机的仿真时间，每次启动清零
+    double clockTime = 0.0;              // 运行时间（SimClock），界面计时器使用
+    double timeScale = 1.0;
+    bool paused = false;
+    EngineSnapshot readings;             // 显示值、传感器状态和发动机状态
+    IndicatorLamps lamps;
+    Alert alerts[ALERT_HISTORY_MAX] = {}; // 当前显示的警报历史，最新的在前
+    size_t alertCount = 0;
+    uint64_t droppedSteps = 0;           // 落后太多时放弃追赶的步数
+    uint64_t commandsApplied = 0;
+};
+
+// 把警报历史复制进快照
+void captureAlerts(SimFrame& frame, const AlertInfo& alertInfo);
+
+// 固定步长仿真线程：按墙钟节拍（乘以时间加速倍数）推进 Engine，每步做告警判定、写日志，追上节拍后发布 SimFrame
+// 界面卡顿不影响步长；追赶时每批最多用 MAX_BATCH 秒墙钟，批间发布 SimFrame、响应快照请求
+// 积压的步数按最近的每步耗时折合成墙钟，超过 MAX_LAG 秒（或落后墙钟超过 MAX_LAG 秒）时放弃追赶并计入 droppedSteps
+// 运行时间 = 步数 x 步长，写入 SimClock，警报过期、日志限频和界面指示灯都按它计时
+class SimulationThread {
+public:
+    SimulationThread(Engine& engine, AlertInfo& alertInfo, AsyncLogger& logger, double step = 0.005);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // 在 start 之前调用：剧本指令在对应的步开始前执行，时间从仿真线程启动时计
+    void setScenario(std::vector<ScenarioEvent> events) { scenario = ScenarioPlayer(std::move(events)); }
+
+    void start();
+    void stop(); // 等待仿真线程退出，并关闭正在写的日志
+
+    // 任意线程调用：指令放入无锁队列，仿真线程在下一步开始前按入队顺序执行；队列满时返回 false
+    bool submit(const EngineCommand& command) { return commands.tryPush(command); }
+    bool requestStart();
+    bool requestStop();
+    bool requestThrust(int direction);
+    CommandQueue& commandQueue() { return commands; }
+
+    // 单个线程调用：取出已执行的指令，appliedAt 为生效时的仿真时间；来不及取走时较新的记录被丢弃
+    bool popApplied(EngineCommand& command) { return applied.tryPop(command); }
+
+    // 界面线程调用：取最近发布的一帧，引用在下一次调用前有效
+    const SimFrame& latestFrame();
+
+    // 时间加速：仿真时间与墙钟之比，限制在 [MIN_TIME_SCALE, MAX_TIME_SCALE]
+    void setTimeScale(double scale);
+    double getTimeScale() const { return timeScale.load(std::memory_order_relaxed); }
+    void setPaused(bool pause) { paused.store(pause, std::memory_order_release); }
+    bool isPaused() const { return paused.load(std::memory_order_acquire); }
+    void singleStep() { stepRequests.fetch_add(1, std::memory_order_acq_rel); } // 暂停时推进一步
+    const SimClock& getClock() const { return clock; }
+    // 在 start 之前调用：记录每步、写日志和每批追赶的耗时，为空时不计时
+    void setFrameStats(FrameStats* frameStats) { stats = frameStats; }
+
+    // 任意线程调用：仿真线程在两步之间保存发动机快照（Engine::saveSnapshot），暂停时同样响应
+    // 线程未运行（start 之前或 stop 的 join 之后）时直接在调用线程保存
+    std::future<std::vector<uint8_t>> requestSnapshot();
+
+    static const double MAX_LAG;
+    static const double MAX_BATCH;
+    static const double MIN_TIME_SCALE;
+    static const double MAX_TIME_SCALE;
+
+private:
+    void run();
+    void step();
+    void publish();
+    void applyCommands();
+    void serveSnapshots();
+
+    Engine& engine;
+    AlertInfo& alertInfo;
+    AsyncLogger& logger;
+    double stepSize;
+    bool isLogging = false;
+
+    SimClock clock;
+    ScenarioPlayer scenario;
+    IndicatorLamps lamps;
+    IndicatorSetter lightLamp;
+    EngineSnapshot lastReadings;
+    uint64_t steps = 0;
+    uint64_t droppedSteps = 0;
+    uint64_t commandsApplied = 0;
+    FrameStats* stats = nullptr;
+    TripleBuffer<SimFrame> frames;
+    CommandQueue commands;
+    SpscRing<EngineCommand> applied;
+
+    std::atomic<bool> running{ false };
+    std::atomic<double> timeScale{ 1.0 };
+    std::atomic<bool> paused{ false };
+    std::atomic<int> stepRequests{ 0 };
+    std::mutex snapshotMutex;
+    std::vector<std::promise<std::vector<uint8_t>>> snapshotRequests; // 受 snapshotMutex 保护
+    bool workerActive = false;           // 受 snapshotMutex 保护：从 start 到 stop 的 join 完成都为 true
+    std::atomic<bool> snapshotPending{ false };
+    std::thread worker;
+};
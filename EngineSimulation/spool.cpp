@@ -0,0 +1,164 @@
+﻿#include "spool.h"
+#include "engine.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+using namespace std;
+
+// -----内置曲线-----
+// 原来的公式：启动 t <= 2 s 时 N1 = 10000t、燃油 = 5t、EGT 为环境温度，之后为 23000lg(t-1)+20000、42lg(t-1)+10、900lg(t-1)+环境温度；
+// 停车系数 1 - lg(t+1)/lg9，8 s 停转。按 DEFAULT_SAMPLE_STEP 采样后插值误差在 N1 上不到 2 rpm，远小于传感器噪声
+// std::log10 在 C++17 中不是 constexpr，这里用级数自己算，采样表整个在编译期生成
+static constexpr double LN2 = 0.69314718055994530942;
+static constexpr double LN10 = 2.30258509299404568402;
+
+// x > 0：先乘除 2 把 x 归到 [√½, √2)，再用 ln x = 2 atanh((x-1)/(x+1)) 的级数，|y| < 0.172，13 项已到双精度舍入误差
+static constexpr double constLog10(double x) {
+	int k = 0;
+	while (x > 1.4142135623730951) { x *= 0.5; ++k; }
+	while (x < 0.7071067811865476) { x *= 2.0; --k; }
+	double y = (x - 1.0) / (x + 1.0), y2 = y * y, term = y, sum = 0.0;
+	for (int n = 1; n <= 25; n += 2) {
+		sum += term / n;
+		term *= y2;
+	}
+	return (2.0 * sum + k * LN2) / LN10;
+}
+
+static constexpr int BUILTIN_START_SAMPLES = 401; // 0 - 10 s，所有引擎约 7.1 s 时达到稳定阈值
+static constexpr int BUILTIN_STOP_SAMPLES = 321;  // 0 - 8 s
+static constexpr double BUILTIN_STOP_DURATION = 8.0;
+
+static constexpr array<double, 3 * BUILTIN_START_SAMPLES> builtinStartTable() {
+	array<double, 3 * BUILTIN_START_SAMPLES> table = {};
+	for (int i = 0; i < BUILTIN_START_SAMPLES; ++i) {
+		double t = i * SpoolProfile::DEFAULT_SAMPLE_STEP;
+		double lg = (t <= 2.0) ? 0.0 : constLog10(t - 1.0);
+		table[3 * i] = (t <= 2.0) ? (10000.0 * t) : (23000.0 * lg + 20000.0);
+		table[3 * i + 1] = (t <= 2.0) ? (5.0 * t) : (42.0 * lg + 10.0);
+		table[3 * i + 2] = (t <= 2.0) ? AMBIENT_TEMP : (900.0 * lg + AMBIENT_TEMP);
+	}
+	return table;
+}
+
+static constexpr array<double, BUILTIN_STOP_SAMPLES> builtinStopTable() {
+	array<double, BUILTIN_STOP_SAMPLES> table = {};
+	for (int i = 0; i < BUILTIN_STOP_SAMPLES; ++i) {
+		double t = i * SpoolProfile::DEFAULT_SAMPLE_STEP;
+		table[i] = (t < BUILTIN_STOP_DURATION) ? (1.0 - constLog10(t + 1.0) / constLog10(9.0)) : 0.0;
+	}
+	return table;
+}
+
+static constexpr array<double, 3 * BUILTIN_START_SAMPLES> BUILTIN_START = builtinStartTable();
+static constexpr array<double, BUILTIN_STOP_SAMPLES> BUILTIN_STOP = builtinStopTable();
+
+SpoolProfile::SpoolProfile()
+	: startInvStep(1.0 / DEFAULT_SAMPLE_STEP), stopInvStep(1.0 / DEFAULT_SAMPLE_STEP), stopEnd(BUILTIN_STOP_DURATION),
+	  startTable(BUILTIN_START.begin(), BUILTIN_START.end()), stopTable(BUILTIN_STOP.begin(), BUILTIN_STOP.end()) {}
+
+const SpoolProfile& SpoolProfile::builtin() {
+	static const SpoolProfile profile;
+	return profile;
+}
+
+// -----曲线表文件-----
+static string trim(const string& s) {
+	size_t b = s.find_first_not_of(" \t\r\n");
+	if (b == string::npos) return "";
+	size_t e = s.find_last_not_of(" \t\r\n");
+	return s.substr(b, e - b + 1);
+}
+
+// 断点之间按折线取值，超出范围取端点
+static double polyline(const vector<double>& time, const vector<double>& value, size_t stride, size_t channel, double t) {
+	size_t k = 1;
+	while (k + 1 < time.size() && time[k] < t) ++k;
+	double t0 = time[k - 1], t1 = time[k];
+	double v0 = value[(k - 1) * stride + channel], v1 = value[k * stride + channel];
+	if (t <= t0) return v0;
+	if (t >= t1) return v1;
+	return v0 + (v1 - v0) * (t - t0) / (t1 - t0);
+}
+
+// 按 step 重采样，采样点覆盖到最后一个断点
+static vector<double> resample(const vector<double>& time, const vector<double>& value, size_t stride, double step) {
+	size_t last = static_cast<size_t>(ceil(time.back() / step - 1e-9));
+	if (last < 1) last = 1;
+	vector<double> table((last + 1) * stride);
+	for (size_t i = 0; i <= last; ++i) {
+		for (size_t c = 0; c < stride; ++c) table[i * stride + c] = polyline(time, value, stride, c, static_cast<double>(i) * step);
+	}
+	return table;
+}
+
+bool SpoolProfile::load(const string& path, SpoolProfile& profile, string& error) {
+	ifstream in(path);
+	if (!in.is_open()) {
+		error = "cannot open " + path;
+		return false;
+	}
+	double step = DEFAULT_SAMPLE_STEP;
+	vector<double> startTime, startValue, stopTime, stopValue;
+	string line;
+	int lineNo = 0;
+	while (getline(in, line)) {
+		++lineNo;
+		line = trim(line);
+		if (line.empty() || line[0] == '#') continue;
+		istringstream iss(line);
+		string kind;
+		iss >> kind;
+		double v[4];
+		int count = (kind == "step") ? 1 : (kind == "start") ? 4 : (kind == "stop") ? 2 : 0;
+		if (count == 0) {
+			error = "line " + to_string(lineNo) + ": expected 'step', 'start' or 'stop', got '" + kind + "'";
+			return false;
+		}
+		bool ok = true;
+		for (int i = 0; i < count; ++i) ok = ok && (iss >> v[i]) && isfinite(v[i]);
+		string extra;
+		if (!ok || (iss >> extra)) {
+			error = "line " + to_string(lineNo) + ": '" + kind + "' takes " + to_string(count) + " numbers";
+			return false;
+		}
+		if (kind == "step") {
+			if (v[0] <= 0.0) {
+				error = "line " + to_string(lineNo) + ": step must be positive";
+				return false;
+			}
+			step = v[0];
+			continue;
+		}
+		vector<double>& time = (kind == "start") ? startTime : stopTime;
+		if ((time.empty() && v[0] != 0.0) || (!time.empty() && v[0] <= time.back())) {
+			error = "line " + to_string(lineNo) + ": " + kind + " times must start at 0 and increase";
+			return false;
+		}
+		time.push_back(v[0]);
+		vector<double>& value = (kind == "start") ? startValue : stopValue;
+		value.insert(value.end(), v + 1, v + count);
+	}
+
+	if (startTime.size() < 2 || stopTime.size() < 2) {
+		error = "need at least two start and two stop points";
+		return false;
+	}
+	if (startValue[startValue.size() - 3] < N1_STABLE_THRESHOLD) {
+		error = "start curve must reach the stable N1 threshold (" + to_string(static_cast<long long>(N1_STABLE_THRESHOLD)) + ")";
+		return false;
+	}
+	if (max(startTime.back(), stopTime.back()) / step > 1e6) {
+		error = "step too small for the curve length";
+		return false;
+	}
+
+	profile.startInvStep = 1.0 / step;
+	profile.stopInvStep = 1.0 / step;
+	profile.stopEnd = stopTime.back();
+	profile.startTable = resample(startTime, startValue, 3, step);
+	profile.stopTable = resample(stopTime, stopValue, 1, step);
+	return true;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 启动/停车曲线：按引擎型号给出的断点表，构造时重采样成等间隔的查找表，每步只做一次下标计算和线性插值，不调用对数
+// 启动段为 N1、燃油流量、EGT 随启动时间的变化，超过表的末端后保持末端值；
+// 停车段为相对停车前读数的衰减系数（1 为停车前的值，0 为停转），表的末端即停车时长
+// 默认构造的是内置曲线（原来写在 advance 里的对数公式），采样表在编译期生成，见 spool.cpp
+class SpoolProfile {
+public:
+    static constexpr double DEFAULT_SAMPLE_STEP = 0.025; // 内置曲线和未指定 step 的曲线表的采样间隔（秒）
+
+    SpoolProfile();
+    static const SpoolProfile& builtin(); // 所有引擎默认共用的内置曲线
+
+    // 读取文本曲线表（格式见 README），重采样后替换 profile；格式或数值不合法时返回 false，不修改 profile
+    static bool load(const std::string& path, SpoolProfile& profile, std::string& error);
+
+    // 启动 t 秒时的 N1、燃油流量和 EGT，未经额定值限幅
+    void start(double t, double& n1, double& fuelFlow, double& egt) const {
+        size_t i;
+        double f;
+        locate(t, startInvStep, startTable.size() / 3 - 1, i, f);
+        const double* a = &startTable[3 * i];
+        n1 = a[0] + (a[3] - a[0]) * f;
+        fuelFlow = a[1] + (a[4] - a[1]) * f;
+        egt = a[2] + (a[5] - a[2]) * f;
+    }
+    // 停车 t 秒时的衰减系数
+    double stopFactor(double t) const {
+        size_t i;
+        double f;
+        locate(t, stopInvStep, stopTable.size() - 1, i, f);
+        return stopTable[i] + (stopTable[i + 1] - stopTable[i]) * f;
+    }
+    double stopDuration() const { return stopEnd; }
+
+private:
+    // 插值区间的起点下标和权重，t 超出表的范围时落在端点上；表至少有两个采样点
+    static void locate(double t, double invStep, size_t last, size_t& i, double& f) {
+        double x = t * invStep;
+        x = (x > 0.0) ? x : 0.0; // 同时把 NaN 当作 0
+        x = (x < static_cast<double>(last)) ? x : static_cast<double>(last);
+        i = static_cast<size_t>(x);
+        i = (i < last) ? i : last - 1;
+        f = x - static_cast<double>(i);
+    }
+
+    double startInvStep = 0.0;
+    double stopInvStep = 0.0;
+    double stopEnd = 0.0;
+    std::vector<double> startTable; // 每个采样点依次为 N1、燃油流量、EGT
+    std::vector<double> stopTable;
+};
@@ -0,0 +1,47 @@
+﻿#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// 单生产者/单消费者无锁环形队列
+// 生产者只写 head，消费者只写 tail，容量必须为 2 的幂
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) : buffer(capacity), mask(capacity - 1) {
+        // 容量不是 2 的幂时向上取整
+        if ((capacity & (capacity - 1)) != 0 || capacity == 0) {
+            size_t c = 1;
+            while (c < capacity) c <<= 1;
+            buffer.resize(c);
+            mask = c - 1;
+        }
+    }
+
+    // 生产者调用，队列满时返回 false
+    bool tryPush(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask) return false;
+        buffer[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用，队列空时返回 false
+    bool tryPop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = buffer[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> buffer;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{ 0 }; // 下一个写入位置
+    alignas(64) std::atomic<size_t> tail{ 0 }; // 下一个读取位置
+};
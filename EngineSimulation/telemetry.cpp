@@ -0,0 +1,334 @@
+﻿#include "telemetry.h"
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+static const char FILE_MAGIC[4] = { 'E', 'T', 'L', 'M' };
+static const char CHUNK_MAGIC[4] = { 'C', 'H', 'N', 'K' };
+static const uint32_t ENDIAN_TAG = 0x01020304u;
+static const int TIME_CHANNEL = 0;
+static const int STATE_CHANNEL = 1 + LOG_VALUE_COUNT;
+
+// 文件头，32 字节
+struct FileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t endianTag;
+	uint32_t channelCount;
+	uint32_t chunkRows;
+	uint32_t reserved0;
+	uint64_t reserved1;
+};
+
+// 块头，24 字节，后接 channelCount 个最小值和 channelCount 个最大值
+struct ChunkHeader {
+	char magic[4];
+	uint32_t rows;
+	double timeMin;
+	double timeMax;
+};
+
+static size_t align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+static size_t channelWidth(ChannelType type) { return type == ChannelType::F64 ? 8 : 1; }
+
+static void writePadding(ofstream& os, size_t written) {
+	static const char zeros[8] = { 0 };
+	os.write(zeros, align8(written) - written);
+}
+
+const vector<TelemetryChannel>& telemetrySchema() {
+	static const vector<TelemetryChannel> schema = [] {
+		vector<TelemetryChannel> s;
+		s.push_back({ "Timestamp", ChannelType::F64 });
+		for (int i = 0; i < LOG_VALUE_COUNT; ++i) {
+			s.push_back({ LOG_COLUMN_NAMES[i], ChannelType::F64 });
+		}
+		s.push_back({ "State", ChannelType::U8 });
+		return s;
+	}();
+	return schema;
+}
+
+// -----写入-----
+
+TelemetryWriter::~TelemetryWriter() {
+	close();
+}
+
+bool TelemetryWriter::open(const string& path) {
+	close();
+	file.open(path, ios::binary | ios::trunc);
+	if (!file.is_open()) return false;
+
+	const vector<TelemetryChannel>& schema = telemetrySchema();
+	FileHeader header = {};
+	memcpy(header.magic, FILE_MAGIC, 4);
+	header.version = TELEMETRY_VERSION;
+	header.endianTag = ENDIAN_TAG;
+	header.channelCount = static_cast<uint32_t>(schema.size());
+	header.chunkRows = TELEMETRY_CHUNK_ROWS;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// 通道表：类型(1) + 名称长度(1) + 名称
+	size_t written = 0;
+	for (const TelemetryChannel& ch : schema) {
+		uint8_t type = static_cast<uint8_t>(ch.type);
+		uint8_t len = static_cast<uint8_t>(ch.name.size());
+		file.write(reinterpret_cast<const char*>(&type), 1);
+		file.write(reinterpret_cast<const char*>(&len), 1);
+		file.write(ch.name.data(), len);
+		written += 2 + len;
+	}
+	writePadding(file, written);
+
+	for (auto& col : columns) {
+		col.clear();
+		col.reserve(TELEMETRY_CHUNK_ROWS);
+	}
+	states.clear();
+	states.reserve(TELEMETRY_CHUNK_ROWS);
+	return true;
+}
+
+void TelemetryWriter::append(const LogSample& sample) {
+	if (!file.is_open()) return;
+	columns[TIME_CHANNEL].push_back(sample.timestamp);
+	for (int i = 0; i < LOG_VALUE_COUNT; ++i) {
+		columns[1 + i].push_back(sample.values[i]);
+	}
+	states.push_back(static_cast<uint8_t>(sample.state));
+	if (states.size() >= TELEMETRY_CHUNK_ROWS) flushChunk();
+}
+
+void TelemetryWriter::flushChunk() {
+	uint32_t rows = static_cast<uint32_t>(states.size());
+	if (rows == 0) return;
+
+	const size_t channelCount = 2 + LOG_VALUE_COUNT;
+	vector<double> mins(channelCount), maxs(channelCount);
+	// 最小/最大值跳过 NaN，整列都是 NaN 时记为 NaN
+	for (size_t c = 0; c < channelCount; ++c) {
+		double lo = numeric_limits<double>::infinity(), hi = -numeric_limits<double>::infinity();
+		for (uint32_t r = 0; r < rows; ++r) {
+			double v = (c == STATE_CHANNEL) ? states[r] : columns[c][r];
+			if (isnan(v)) continue;
+			lo = min(lo, v);
+			hi = max(hi, v);
+		}
+		mins[c] = (lo <= hi) ? lo : numeric_limits<double>::quiet_NaN();
+		maxs[c] = (lo <= hi) ? hi : numeric_limits<double>::quiet_NaN();
+	}
+
+	ChunkHeader header = {};
+	memcpy(header.magic, CHUNK_MAGIC, 4);
+	header.rows = rows;
+	header.timeMin = columns[TIME_CHANNEL].front();
+	header.timeMax = columns[TIME_CHANNEL].back();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(mins.data()), mins.size() * sizeof(double));
+	file.write(reinterpret_cast<const char*>(maxs.data()), maxs.size() * sizeof(double));
+
+	for (size_t c = 0; c < STATE_CHANNEL; ++c) {
+		file.write(reinterpret_cast<const char*>(columns[c].data()), rows * sizeof(double));
+		columns[c].clear();
+	}
+	file.write(reinterpret_cast<const char*>(states.data()), rows);
+	writePadding(file, rows);
+	states.clear();
+}
+
+void TelemetryWriter::close() {
+	if (!file.is_open()) return;
+	flushChunk();
+	file.close();
+}
+
+// -----内存映射-----
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const string& path) {
+	close();
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (f == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size) || size.QuadPart == 0) {
+		CloseHandle(f);
+		return false;
+	}
+	HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m == nullptr) {
+		CloseHandle(f);
+		return false;
+	}
+	void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		CloseHandle(m);
+		CloseHandle(f);
+		return false;
+	}
+	fileHandle = f;
+	mappingHandle = m;
+	base = static_cast<const uint8_t*>(view);
+	length = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close() {
+	if (base) UnmapViewOfFile(base);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+	base = nullptr;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+	length = 0;
+}
+#else
+bool MappedFile::open(const string& path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // 映射建立后即可关闭描述符
+	if (view == MAP_FAILED) return false;
+	base = static_cast<const uint8_t*>(view);
+	length = static_cast<size_t>(st.st_size);
+	return true;
+}
+
+void MappedFile::close() {
+	if (base) munmap(const_cast<uint8_t*>(base), length);
+	base = nullptr;
+	length = 0;
+}
+#endif
+
+// -----读取-----
+
+bool TelemetryReader::fail(const string& message) {
+	lastError = message;
+	close();
+	return false;
+}
+
+void TelemetryReader::close() {
+	mapped.close();
+	channels.clear();
+	chunks.clear();
+	chunkFirstRow.clear();
+	totalRows = 0;
+}
+
+bool TelemetryReader::open(const string& path) {
+	close();
+	lastError.clear();
+	if (!mapped.open(path)) return fail("cannot map file " + path);
+
+	const uint8_t* p = mapped.data();
+	size_t size = mapped.size();
+	if (size < sizeof(FileHeader)) return fail("file too small");
+	FileHeader header;
+	memcpy(&header, p, sizeof(header));
+	if (memcmp(header.magic, FILE_MAGIC, 4) != 0) return fail("not a telemetry file");
+	if (header.endianTag != ENDIAN_TAG) return fail("byte order mismatch");
+	if (header.version != TELEMETRY_VERSION) return fail("unsupported version");
+
+	size_t pos = sizeof(FileHeader);
+	size_t tableStart = pos;
+	for (uint32_t i = 0; i < header.channelCount; ++i) {
+		if (pos + 2 > size) return fail("truncated channel table");
+		TelemetryChannel ch;
+		ch.type = static_cast<ChannelType>(p[pos]);
+		uint8_t len = p[pos + 1];
+		if (pos + 2 + len > size) return fail("truncated channel table");
+		ch.name.assign(reinterpret_cast<const char*>(p + pos + 2), len);
+		channels.push_back(ch);
+		pos += 2 + len;
+	}
+	pos = tableStart + align8(pos - tableStart);
+
+	// 读取端按 telemetrySchema 的下标取列，通道表（个数、名字、类型）必须完全一致
+	const vector<TelemetryChannel>& schema = telemetrySchema();
+	if (channels.size() != schema.size()) {
+		return fail("channel table has " + to_string(channels.size()) + " channels, expected " + to_string(schema.size()));
+	}
+	for (size_t i = 0; i < schema.size(); ++i) {
+		if (channels[i].name != schema[i].name || channels[i].type != schema[i].type) {
+			return fail("channel " + to_string(i) + " is '" + channels[i].name + "' (type " + to_string(static_cast<int>(channels[i].type))
+				+ "), expected '" + schema[i].name + "' (type " + to_string(static_cast<int>(schema[i].type)) + ")");
+		}
+	}
+
+	// 顺序扫描块头建立索引，不读取列数据
+	const size_t n = channels.size();
+	while (pos + sizeof(ChunkHeader) <= size) {
+		ChunkHeader ch;
+		memcpy(&ch, p + pos, sizeof(ch));
+		if (memcmp(ch.magic, CHUNK_MAGIC, 4) != 0) return fail("bad chunk header");
+		TelemetryChunk chunk;
+		chunk.rows = ch.rows;
+		chunk.timeMin = ch.timeMin;
+		chunk.timeMax = ch.timeMax;
+		pos += sizeof(ChunkHeader);
+		if (pos + 2 * n * sizeof(double) > size) return fail("truncated chunk");
+		chunk.minValues = reinterpret_cast<const double*>(p + pos);
+		chunk.maxValues = reinterpret_cast<const double*>(p + pos + n * sizeof(double));
+		pos += 2 * n * sizeof(double);
+		for (size_t c = 0; c < n; ++c) {
+			size_t bytes = ch.rows * channelWidth(channels[c].type);
+			if (pos + bytes > size) return fail("truncated chunk");
+			chunk.columns.push_back(p + pos);
+			pos += align8(bytes);
+		}
+		chunkFirstRow.push_back(totalRows);
+		totalRows += chunk.rows;
+		chunks.push_back(chunk);
+	}
+	return true;
+}
+
+int TelemetryReader::findChannel(const string& name) const {
+	for (size_t i = 0; i < channels.size(); ++i) {
+		if (channels[i].name == name) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+size_t TelemetryReader::findChunk(double time) const {
+	auto it = lower_bound(chunks.begin(), chunks.end(), time,
+		[](const TelemetryChunk& c, double t) { return c.timeMax < t; });
+	return static_cast<size_t>(it - chunks.begin());
+}
+
+LogSample TelemetryReader::sample(size_t row) const {
+	if (row >= totalRows) return LogSample();
+	size_t c = static_cast<size_t>(upper_bound(chunkFirstRow.begin(), chunkFirstRow.end(), row) - chunkFirstRow.begin()) - 1;
+	size_t r = row - chunkFirstRow[c];
+	const TelemetryChunk& chunk = chunks[c];
+	LogSample s;
+	s.timestamp = chunk.f64(TIME_CHANNEL)[r];
+	for (int i = 0; i < LOG_VALUE_COUNT; ++i) {
+		s.values[i] = chunk.f64(1 + i)[r];
+	}
+	s.state = static_cast<EngineState>(chunk.u8(STATE_CHANNEL)[r]);
+	return s;
+}
@@ -0,0 +1,109 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "log.h"
+
+// 二进制分块列式遥测格式 (.etl)
+//   文件头：魔数 "ETLM"、版本、字节序标记、通道数、每块最大行数
+//   通道表：每个通道的类型和名称（名称与 CSV 表头一致）
+//   数据块：块头（行数、时间范围、各通道最小/最大值）+ 按通道连续存放的定宽列
+// 所有段按 8 字节对齐，内存映射后可直接按 double* 读取列
+const uint32_t TELEMETRY_VERSION = 1;
+const uint32_t TELEMETRY_CHUNK_ROWS = 4096;
+
+enum class ChannelType : uint8_t { F64 = 0, U8 = 1 };
+
+struct TelemetryChannel {
+    std::string name;
+    ChannelType type;
+};
+
+// 与 LogSample / CSV 对应的通道表：Timestamp、14 个数据列、State
+const std::vector<TelemetryChannel>& telemetrySchema();
+
+class TelemetryWriter {
+public:
+    TelemetryWriter() = default;
+    ~TelemetryWriter();
+
+    bool open(const std::string& path);
+    void append(const LogSample& sample);
+    void close(); // 写出未满的最后一块
+    bool isOpen() const { return file.is_open(); }
+
+private:
+    void flushChunk();
+
+    std::ofstream file;
+    std::vector<double> columns[1 + LOG_VALUE_COUNT]; // 时间戳 + 数据列
+    std::vector<uint8_t> states;
+};
+
+// 只读内存映射文件
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// 一个数据块的视图，指针直接指向映射内存
+struct TelemetryChunk {
+    uint32_t rows = 0;
+    double timeMin = 0.0;
+    double timeMax = 0.0;
+    const double* minValues = nullptr; // 每通道最小值
+    const double* maxValues = nullptr; // 每通道最大值
+    std::vector<const uint8_t*> columns;
+
+    const double* f64(size_t channel) const { return reinterpret_cast<const double*>(columns[channel]); }
+    const uint8_t* u8(size_t channel) const { return columns[channel]; }
+};
+
+class TelemetryReader {
+public:
+    bool open(const std::string& path); // 格式损坏或通道表与 telemetrySchema 不一致时返回 false，见 error()
+    void close();
+
+    size_t channelCount() const { return channels.size(); }
+    const TelemetryChannel& channel(size_t i) const { return channels[i]; }
+    int findChannel(const std::string& name) const; // 找不到返回 -1
+
+    size_t chunkCount() const { return chunks.size(); }
+    const TelemetryChunk& chunk(size_t i) const { return chunks[i]; }
+    size_t rowCount() const { return totalRows; }
+
+    // 第一个 timeMax >= time 的块，没有则返回 chunkCount()
+    size_t findChunk(double time) const;
+    // 按全局行号读取一行，行号越界时返回默认构造的样本
+    LogSample sample(size_t row) const;
+
+    const std::string& error() const { return lastError; }
+
+private:
+    bool fail(const std::string& message);
+
+    MappedFile mapped;
+    std::vector<TelemetryChannel> channels;
+    std::vector<TelemetryChunk> chunks;
+    std::vector<size_t> chunkFirstRow;
+    size_t totalRows = 0;
+    std::string lastError;
+};
@@ -0,0 +1,150 @@
+﻿// 二进制遥测文件工具：打印块索引，或按时间范围导出为与日志相同格式的 CSV
+// 也可以把压缩日志 (.elz) 解码回 CSV
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <limits>
+#include "telemetry.h"
+#include "log_codec.h"
+using namespace std;
+
+struct DumpOptions {
+	string input;
+	string csv;                                          // 非空时导出 CSV
+	double from = -numeric_limits<double>::infinity();   // 导出时间范围（秒）
+	double to = numeric_limits<double>::infinity();
+};
+
+static void printUsage(const char* prog) {
+	cout << "Usage: " << prog << " <file.etl|file.elz> [--csv <path>] [--from <s>] [--to <s>]\n";
+	cout << "       without --csv, prints the channel table and chunk index\n";
+	cout << "       --csv       convert rows to CSV (same layout as engine_data_*.csv)\n";
+	cout << "       --from/--to time range in seconds, chunks outside are skipped\n";
+}
+
+static bool parseOptions(int argc, char* argv[], DumpOptions& opt) {
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--help" || arg == "-h") return false;
+		if (arg.compare(0, 2, "--") != 0) {
+			opt.input = arg;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			cerr << "[Telemetry] Missing value for " << arg << "\n";
+			return false;
+		}
+		string value = argv[++i];
+		try {
+			if (arg == "--csv") opt.csv = value;
+			else if (arg == "--from") opt.from = stod(value);
+			else if (arg == "--to") opt.to = stod(value);
+			else {
+				cerr << "[Telemetry] Unknown option: " << arg << "\n";
+				return false;
+			}
+		}
+		catch (...) {
+			cerr << "[Telemetry] Invalid value for " << arg << ": " << value << "\n";
+			return false;
+		}
+	}
+	return !opt.input.empty();
+}
+
+static void printIndex(const TelemetryReader& reader) {
+	cout << "[Telemetry] " << reader.channelCount() << " channels, " << reader.chunkCount()
+		<< " chunks, " << reader.rowCount() << " rows\n";
+	for (size_t i = 0; i < reader.channelCount(); ++i) {
+		cout << "  " << i << ": " << reader.channel(i).name
+			<< (reader.channel(i).type == ChannelType::F64 ? " (f64)" : " (u8)") << "\n";
+	}
+	for (size_t c = 0; c < reader.chunkCount(); ++c) {
+		const TelemetryChunk& chunk = reader.chunk(c);
+		cout << "  chunk " << c << ": " << chunk.rows << " rows, t=[" << chunk.timeMin << ", " << chunk.timeMax << "]";
+		int n1 = reader.findChannel("N1_L_Disp");
+		if (n1 >= 0) cout << ", N1_L_Disp=[" << chunk.minValues[n1] << ", " << chunk.maxValues[n1] << "]";
+		cout << "\n";
+	}
+}
+
+static bool isCompressedLog(const string& path) {
+	return path.size() >= 4 && path.compare(path.size() - 4, 4, ".elz") == 0;
+}
+
+// 压缩日志只能顺序解码，没有 --csv 时只统计行数
+static int dumpCompressed(const DumpOptions& opt) {
+	CompressedLogReader reader;
+	if (!reader.open(opt.input)) {
+		cerr << "[Telemetry] Cannot read " << opt.input << ": " << reader.error() << "\n";
+		return 1;
+	}
+	ofstream out;
+	if (!opt.csv.empty()) {
+		out.open(opt.csv);
+		if (!out.is_open()) {
+			cerr << "[Telemetry] Cannot open output file: " << opt.csv << "\n";
+			return 1;
+		}
+		logDataHeader(out);
+	}
+	size_t rows = 0, written = 0;
+	LogSample s;
+	while (reader.next(s)) {
+		++rows;
+		if (!out.is_open() || s.timestamp < opt.from || s.timestamp > opt.to) continue;
+		writeSample(out, s);
+		++written;
+	}
+	if (!reader.error().empty()) {
+		cerr << "[Telemetry] " << opt.input << " is damaged after row " << rows << ": " << reader.error() << "\n";
+	}
+	if (out.is_open()) cout << "[Telemetry] Wrote " << written << " rows to " << opt.csv << "\n";
+	else cout << "[Telemetry] Compressed log with " << rows << " rows\n";
+	return reader.error().empty() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+	DumpOptions opt;
+	if (!parseOptions(argc, argv, opt)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	if (isCompressedLog(opt.input)) {
+		return dumpCompressed(opt);
+	}
+
+	TelemetryReader reader;
+	if (!reader.open(opt.input)) {
+		cerr << "[Telemetry] Cannot read " << opt.input << ": " << reader.error() << "\n";
+		return 1;
+	}
+	if (opt.csv.empty()) {
+		printIndex(reader);
+		return 0;
+	}
+
+	ofstream out(opt.csv);
+	if (!out.is_open()) {
+		cerr << "[Telemetry] Cannot open output file: " << opt.csv << "\n";
+		return 1;
+	}
+	logDataHeader(out);
+	// 用块的时间范围跳过整块，只在边界块内逐行比较
+	size_t row = 0, written = 0;
+	for (size_t c = 0; c < reader.chunkCount(); ++c) {
+		const TelemetryChunk& chunk = reader.chunk(c);
+		if (chunk.timeMax < opt.from || chunk.timeMin > opt.to) {
+			row += chunk.rows;
+			continue;
+		}
+		for (uint32_t r = 0; r < chunk.rows; ++r, ++row) {
+			LogSample s = reader.sample(row);
+			if (s.timestamp < opt.from || s.timestamp > opt.to) continue;
+			writeSample(out, s);
+			++written;
+		}
+	}
+	cout << "[Telemetry] Wrote " << written << " rows to " << opt.csv << "\n";
+	return 0;
+}
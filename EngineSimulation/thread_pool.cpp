@@ -0,0 +1,92 @@
+﻿#include "thread_pool.h"
+using namespace std;
+
+// 当前线程所属的线程池和下标，用于任务内再提交任务时放入本线程队列
+static thread_local WorkStealingPool* currentPool = nullptr;
+static thread_local unsigned currentWorker = 0;
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+	if (threadCount == 0) threadCount = thread::hardware_concurrency();
+	if (threadCount == 0) threadCount = 1;
+	for (unsigned i = 0; i < threadCount; ++i) {
+		queues.push_back(make_unique<TaskQueue>());
+	}
+	for (unsigned i = 0; i < threadCount; ++i) {
+		workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+	}
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (auto& t : workers) {
+		if (t.joinable()) t.join();
+	}
+}
+
+void WorkStealingPool::submit(function<void()> task) {
+	unsigned id = (currentPool == this) ? currentWorker : nextQueue++ % size();
+	unfinished++;
+	{
+		lock_guard<mutex> lock(queues[id]->mutex);
+		queues[id]->tasks.push_back(move(task));
+	}
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		queued++;
+	}
+	workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+	unique_lock<mutex> lock(sleepMutex);
+	allDone.wait(lock, [this] { return unfinished.load() == 0; });
+}
+
+// 先取本线程队尾（最近提交、缓存最热），再按顺序窃取其他队列的队首
+bool WorkStealingPool::takeTask(unsigned id, function<void()>& task) {
+	unsigned n = size();
+	for (unsigned k = 0; k < n; ++k) {
+		unsigned victim = (id + k) % n;
+		TaskQueue& q = *queues[victim];
+		lock_guard<mutex> lock(q.mutex);
+		if (q.tasks.empty()) continue;
+		if (k == 0) {
+			task = move(q.tasks.back());
+			q.tasks.pop_back();
+		}
+		else {
+			task = move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+		return true;
+	}
+	return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned id) {
+	currentPool = this;
+	currentWorker = id;
+	while (true) {
+		{
+			unique_lock<mutex> lock(sleepMutex);
+			workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+			if (stopping && queued == 0) return;
+			queued--; // 预定一个任务，保证下面一定能取到
+		}
+
+		function<void()> task;
+		while (!takeTask(id, task)) {
+			this_thread::yield(); // queued 只在任务入队后增加，这里不会长时间循环
+		}
+		task();
+
+		if (--unfinished == 0) {
+			lock_guard<mutex> lock(sleepMutex);
+			allDone.notify_all();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// 工作窃取线程池：每个工作线程有自己的任务队列，从队尾取任务；
+// 自己的队列空了就从其他线程的队首窃取，一个慢任务不会让其他核空等
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = 0); // 0 表示使用硬件线程数
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 提交任务；在工作线程内提交时放入本线程队列，否则轮流分配
+    void submit(std::function<void()> task);
+    // 阻塞直到所有已提交的任务执行完毕
+    void wait();
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned id);
+    bool takeTask(unsigned id, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queued = 0;                 // 在队列中尚未取走的任务数，受 sleepMutex 保护
+    std::atomic<size_t> unfinished{ 0 }; // 已提交但未执行完的任务数
+    std::atomic<unsigned> nextQueue{ 0 };
+    bool stopping = false;
+};
@@ -0,0 +1,39 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 单写者/单读者三缓冲：写者总有一块空闲缓冲可写，读者总能拿到最近发布的一块，双方都不等待
+// 写者写完 writeBuffer() 后调用 publish()；读者调用 update() 换到最新一块，再用 read() 读取
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 写者调用
+    T& writeBuffer() { return slots[back]; }
+    void publish() {
+        // 把写好的一块换到中间，并标记为新数据
+        uint8_t old = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = old & INDEX_MASK;
+    }
+
+    // 读者调用，有新数据时换到最新一块并返回 true
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t old = middle.exchange(front, std::memory_order_acq_rel);
+        front = old & INDEX_MASK;
+        return true;
+    }
+    const T& read() const { return slots[front]; }
+
+private:
+    static const uint8_t FRESH = 4;
+    static const uint8_t INDEX_MASK = 3;
+
+    T slots[3];
+    uint8_t back = 0;                   // 只由写者访问
+    uint8_t front = 1;                  // 只由读者访问
+    alignas(64) std::atomic<uint8_t> middle{ 2 };
+};
@@ -1,13 +1,14 @@
 ﻿#include "ui.h"
 #include "log.h"
+#include "sim_thread.h"
 #include <iomanip>
 #include <sstream>
-#include <graphics.h>
 using namespace std;
 #define pi 3.14159265358979323846
 
-Gauge::Gauge(POINT center, int radius, const std::string& label, double maxVal)
-	: center(center), radius(radius), label(label), maxVal(maxVal) {
+Gauge::Gauge(RenderPoint center, int radius, const std::string& label, double maxVal)
+	: center(center), radius(radius), label(label), wideLabel(label.begin(), label.end()),
+	showPercent(label.find("N1") != string::npos), maxVal(maxVal) {
 };
 
 double Gauge::valueToAngle(double value) const {
@@ -20,97 +21,100 @@ double Gauge::valueToAngle(double value) const {
 }
 
 
-void Gauge::draw(double value, double baseValue, double cautionStart, double warningStart) const {
-	POINT Gaugecenter = center;
+GaugeView Gauge::view(double value, double cautionStart, double warningStart) const {
+	GaugeView v;
+	if (isnan(value)) {
+		v.color = COLOR_RED;
+		v.text = L"NaN";
+		return v;
+	}
+	v.valid = true;
+	// 根据数值设定颜色
+	if (value >= warningStart) {
+		v.color = COLOR_RED;
+	}
+	else if (value >= cautionStart) {
+		v.color = COLOR_AMBER;
+	}
+	// 扇形角度取到 0.25 度，更小的变化画出来看不出差别；绘制缓存按它判断是否重画，
+	// 因此增量重画和整屏重画得到的画面完全一样
+	const double ANGLE_QUANTUM = pi / 720;
+	v.fillAngle = round(valueToAngle(value) / ANGLE_QUANTUM) * ANGLE_QUANTUM;
+
+	wostringstream wss;
+	if (showPercent) {
+		wss << fixed << setprecision(1) << (value / 40000.0) * 100.0; // N1显示百分比
+	}
+	else {
+		wss << fixed << setprecision(0) << value;
+	}
+	v.text = wss.str();
+	return v;
+}
+
+void Gauge::draw(Renderer& r, const GaugeView& v) const {
+	RenderPoint Gaugecenter = center;
 	int GaugeRadius = radius;
 
 	// 绘制仪表背景要转化弧度制
-	setlinecolor(COLOR_WHITE);
-	setfillcolor(COLOR_BLACK);
-	pie(Gaugecenter.x - static_cast<int>(GaugeRadius * 0.96), Gaugecenter.y - static_cast<int>(GaugeRadius * 1.05),
+	r.setLineColor(COLOR_WHITE);
+	r.setFillColor(COLOR_BLACK);
+	r.pie(Gaugecenter.x - static_cast<int>(GaugeRadius * 0.96), Gaugecenter.y - static_cast<int>(GaugeRadius * 1.05),
 		Gaugecenter.x + static_cast<int>(GaugeRadius * 1.04), Gaugecenter.y + GaugeRadius, // 稍微偏一些看起来效果更好
 		double(140) / 180 * pi, 0);
 
-	if (isnan(value)) {
-		// 在数字读数位置绘制 "NaN"
-		settextcolor(COLOR_RED);
-		setbkmode(TRANSPARENT);
-		settextstyle(20, 0, _T("Consolas"));
-		outtextxy(Gaugecenter.x + static_cast<int>(radius * 0.42), Gaugecenter.y - static_cast<int>(radius * 0.3), L"NaN");
+	// 绘制代表当前值的实心扇形
+	if (v.valid && abs(v.fillAngle) >= pi / 180) {
+		r.setLineColor(v.color);
+		r.setFillColor(v.color);
+		r.solidPie(Gaugecenter.x - static_cast<int>(GaugeRadius * 0.9), Gaugecenter.y - static_cast<int>(GaugeRadius * 0.9),
+			Gaugecenter.x + static_cast<int>(GaugeRadius * 0.95), Gaugecenter.y + static_cast<int>(GaugeRadius * 0.9),
+			v.fillAngle, 0);
 	}
-	else {
-		// 根据数值设定颜色
-		COLORREF currentColor = COLOR_LIGHT_GREY; // 默认白色
-		if (value >= warningStart) {
-			currentColor = COLOR_RED;
-		}
-		else if (value >= cautionStart) {
-			currentColor = COLOR_AMBER;
-		}
 
-		// 绘制代表当前值的实心扇形
-		double fillAngle = valueToAngle(value);
+	// 绘制数字读数（无效时为红色 "NaN"）
+	r.setTextColor(v.color);
+	r.setTextStyle(20, L"Consolas");
+	r.outText(Gaugecenter.x + static_cast<int>(radius * 0.42), Gaugecenter.y - static_cast<int>(radius * 0.3), v.text.c_str());
 
-		if (abs(fillAngle) >= pi / 180) {
-			setlinecolor(currentColor);
-			setfillcolor(currentColor);
-
-			solidpie(Gaugecenter.x - static_cast<int>(GaugeRadius * 0.9), Gaugecenter.y - static_cast<int>(GaugeRadius * 0.9),
-				Gaugecenter.x + static_cast<int>(GaugeRadius * 0.95), Gaugecenter.y + static_cast<int>(GaugeRadius * 0.9),
-				fillAngle, 0);
-		}
+	// 绘制仪表标签
+	r.setTextColor(COLOR_WHITE);
+	r.outText(Gaugecenter.x - static_cast<int>(radius * 0.2), Gaugecenter.y - static_cast<int>(radius * 0.7), wideLabel.c_str());
+}
 
-		// 4. 绘制数字读数
-		settextcolor(currentColor);
-		setbkmode(TRANSPARENT);
-		settextstyle(20, 0, _T("Consolas"));
-		double displayValue = value;
-
-		if (label.find("N1") != string::npos) {
-			displayValue = (value / 40000.0) * 100.0; // N1显示百分比
-			wostringstream wss;
-			wss << fixed << setprecision(1) << displayValue;
-			wstring valStr = wss.str();
-			outtextxy(Gaugecenter.x + static_cast<int>(radius * 0.42), Gaugecenter.y - static_cast<int>(radius * 0.3), valStr.c_str());
-		}
-		else {
-			wostringstream wss;
-			wss << fixed << setprecision(0) << displayValue;
-			wstring valStr = wss.str();
-			outtextxy(Gaugecenter.x + static_cast<int>(radius * 0.42), Gaugecenter.y - static_cast<int>(radius * 0.3), valStr.c_str());
-		}
-	}
-	// 5. 绘制仪表标签
-	settextcolor(COLOR_WHITE);
-	settextstyle(20, 0, _T("Consolas"));
-	outtextxy(Gaugecenter.x - static_cast<int>(radius * 0.2), Gaugecenter.y - static_cast<int>(radius * 0.7), wstring(label.begin(), label.end()).c_str());
+RenderRect Gauge::bounds(Renderer& r) const {
+	RenderRect dial = { center.x - static_cast<int>(radius * 0.96), center.y - static_cast<int>(radius * 1.05),
+		center.x + static_cast<int>(radius * 1.04), center.y + radius };
+	r.setTextStyle(20, L"Consolas");
+	int textX = center.x + static_cast<int>(radius * 0.42);
+	int textY = center.y - static_cast<int>(radius * 0.3);
+	RenderRect text = { textX, textY, textX + r.textWidth(L"00000000"), textY + r.textHeight(L"0") };
+	return unionRect(dial, text);
 }
 
 
-Indicator::Indicator(const RECT& position, const std::string& text)
+Indicator::Indicator(const RenderRect& position, const std::wstring& text)
 	: pos(position), label(text), isActive(false), color(COLOR_GREY), lastActivatedTime(0.0) {}
 
-void Indicator::draw() const {
+void Indicator::draw(Renderer& r) const {
 	// 画边框
-	setlinecolor(COLOR_WHITE);
-	rectangle(pos.left, pos.top, pos.right, pos.bottom);
+	r.setLineColor(COLOR_WHITE);
+	r.rectangle(pos.left, pos.top, pos.right, pos.bottom);
 	// 填充颜色
-	setfillcolor(color);
-	solidrectangle(pos.left + 1, pos.top + 1, pos.right - 1, pos.bottom - 1);
+	r.setFillColor(color);
+	r.solidRectangle(pos.left + 1, pos.top + 1, pos.right - 1, pos.bottom - 1);
 	// 写文字
-	settextcolor(isActive ? COLOR_BLACK : COLOR_WHITE);
-	setbkmode(TRANSPARENT);
-	settextstyle(20, 0, _T("Consolas"));
-	int textWidth = textwidth(wstring(label.begin(), label.end()).c_str());
-	int textHeight = textheight(wstring(label.begin(), label.end()).c_str());
+	r.setTextColor(isActive ? COLOR_BLACK : COLOR_WHITE);
+	r.setTextStyle(20, L"Consolas");
+	int textWidth = r.textWidth(label.c_str());
+	int textHeight = r.textHeight(label.c_str());
 	int x = (pos.left + pos.right - textWidth) / 2;
 	int y = (pos.top + pos.bottom - textHeight) / 2;
-	outtextxy(x, y, wstring(label.begin(), label.end()).c_str());
+	r.outText(x, y, label.c_str());
 }
 
-void Indicator::update() {
+void Indicator::update(double currentTime) {
 	if (isActive) {
-		double currentTime = getCurrenTimeSeconds();
 		if (currentTime - lastActivatedTime >= 2) {
 			isActive = false;
 			color = COLOR_GREY;
@@ -118,9 +122,7 @@ void Indicator::update() {
 	}
 }
 
-void Indicator::setActive(const COLORREF newColor) {
-	double currentTime = getCurrenTimeSeconds();
-
+void Indicator::setActive(double currentTime, const COLORREF newColor) {
 	// 如果已激活且颜色相同，只刷新时间戳（保持持续显示）
 	if (isActive && color == newColor) {
 		lastActivatedTime = currentTime;
@@ -159,15 +161,15 @@ void Indicator::deactivate() {
 	color = COLOR_GREY;
 }
 
-TriangleButton::TriangleButton(const RECT& rectangle, bool direction)
+TriangleButton::TriangleButton(const RenderRect& rectangle, bool direction)
 	: rect(rectangle), direction(direction), enabled(true) {}
 
-void TriangleButton::draw() const {
+void TriangleButton::draw(Renderer& r) const {
 	COLORREF fillcolor = enabled ? COLOR_LIGHT_GREY : COLOR_GREY;
-	setfillcolor(fillcolor);
-	setlinecolor(fillcolor);
+	r.setFillColor(fillcolor);
+	r.setLineColor(fillcolor);
 
-	POINT points[3];
+	RenderPoint points[3];
 	if (direction) {
 		// 向上三角形
 		points[0] = { (rect.left + rect.right) / 2, rect.top };
@@ -180,7 +182,7 @@ void TriangleButton::draw() const {
 		points[1] = { rect.right, rect.top };
 		points[2] = { (rect.left + rect.right) / 2, rect.bottom };
 	}
-	fillpolygon(points, 3);
+	r.fillPolygon(points, 3);
 }
 
 bool TriangleButton::isClicked(int x, int y) const {
@@ -192,137 +194,57 @@ void TriangleButton::setEnabled(bool isEnabled) {
 	enabled = isEnabled;
 }
 
-double AlertInfo::getCurrentTime() const {
-	static auto startTime = chrono::high_resolution_clock::now();
-	auto currentTime = chrono::high_resolution_clock::now();
-	return chrono::duration<double>(currentTime - startTime).count();
-}
-
-void AlertInfo::triggerAlert(const std::string& message, COLORREF color) {
-	double now = getCurrentTime();
-
-	// 检查警报历史中是否已存在完全相同的警报，避免重复添加
-	auto it = std::find_if(alertHistory.begin(), alertHistory.end(),
-		[&](const Alert& a) { return a.message == message; });
-
-	if (it == alertHistory.end()) {
-		Alert newAlert = { message, color, now };
-		alertHistory.push_front(newAlert);
-		if (alertHistory.size() > 10) {
-			alertHistory.pop_back();
-		}
-		// 将新警报添加到待记录队列中
-		newAlertsForLogging.push_back(newAlert);
-	}
-}
-
-void AlertInfo::update() {
-	double now = getCurrentTime();
-	// 移除超过显示时间的旧警报
-	alertHistory.erase(
-		std::remove_if(alertHistory.begin(), alertHistory.end(),
-			[now](const Alert& a) { return now - a.timestamp > 5.0; }),
-		alertHistory.end()
-	);
-
-	if (!alertHistory.empty()) {
-		// 总是显示最新的警报
-		currentAlert = alertHistory.front();
-	}
-	else {
-		// 如果没有警报，则清空当前警报
-		currentAlert = { "", COLOR_BLACK, 0.0 };
-	}
-}
-
-deque<Alert> AlertInfo::getAndClearNewAlerts() {
-	deque<Alert> alerts_to_log;
-	// 使用move高效地移动队列内容，然后清空原队列
-	alerts_to_log = std::move(newAlertsForLogging);
-	newAlertsForLogging.clear();
-	return alerts_to_log;
-}
-
-void AlertInfo::drawHistory() const {
-	int baseX = WINDOW_WIDTH - 400;
-	int baseY = 200;  // 改为显示在更上面的位置
+void drawAlertHistory(Renderer& r, const Alert* alerts, size_t count) {
+	int baseX = ALERT_HISTORY_RECT.left;
+	int baseY = ALERT_HISTORY_RECT.top;  // 改为显示在更上面的位置
 	int lineHeight = 20;
 	int maxLines = 20;
 	int cnt = 0;
 
 	// 绘制警报历史背景框
-	setlinecolor(COLOR_GREY);
-	rectangle(baseX, baseY, baseX + 350, WINDOW_HEIGHT - 50);
+	r.setLineColor(COLOR_GREY);
+	r.rectangle(ALERT_HISTORY_RECT.left, ALERT_HISTORY_RECT.top, ALERT_HISTORY_RECT.right, ALERT_HISTORY_RECT.bottom);
 
 	// 绘制标题
-	settextcolor(COLOR_WHITE);
-	setbkmode(TRANSPARENT);
-	settextstyle(16, 0, _T("Consolas"));
-	outtextxy(baseX + 5, baseY + 5, L"Alert:");
+	r.setTextColor(COLOR_WHITE);
+	r.setTextStyle(16, L"Consolas");
+	r.outText(baseX + 5, baseY + 5, L"Alert:");
 
 	// 绘制警报信息
-	for (auto it = alertHistory.begin(); it != alertHistory.end() && cnt < maxLines; ++it, ++cnt) {
-		const Alert& alert = *it;
+	for (; cnt < static_cast<int>(count) && cnt < maxLines; ++cnt) {
+		const Alert& alert = alerts[cnt];
 		int x = baseX + 20;
 		int y = baseY + cnt * lineHeight + 20;
 
-		settextcolor(alert.color);
-		setbkmode(TRANSPARENT);
-		settextstyle(16, 0, _T("Consolas"));
-
-		wstring wmsg = wstring(alert.message.begin(), alert.message.end());
-		outtextxy(x + 8, y + 2, wmsg.c_str());
+		r.setTextColor(alert.color);
+		r.outText(x + 8, y + 2, alertWideMessage(alert.id).c_str());
 	}
 }
 
-void initializeIndicators(map<string, Indicator>& indicators) {
-	indicators.clear();
-	const int w = 125, h = 25, xStart = 20, yStart = 500, xOffset = 140, yOffset = 30;
-
-	// 在右上角添加 Start 和 Run 指示灯
-	indicators.emplace("Start", Indicator({ xStart, yStart - 75, xStart + w,  yStart - 15 }, "START"));
-	indicators.emplace("Run", Indicator({ xStart + xOffset, yStart - 75, xStart + xOffset + w, yStart - 15 }, "RUN"));
-
-	// --- 5x4 指示灯矩阵 ---
-
-	// 第 1 行: N1 传感器故障 (左/右, 传感器1/2)
-	indicators.emplace("N1_L_S1_Fail", Indicator({ xStart, yStart, xStart + w, yStart + h }, "N1 L S1 Fail"));
-	indicators.emplace("N1_L_S2_Fail", Indicator({ xStart + xOffset, yStart, xStart + xOffset + w, yStart + h }, "N1 L S2 Fail"));
-	indicators.emplace("N1_R_S1_Fail", Indicator({ xStart + 2 * xOffset, yStart, xStart + 2 * xOffset + w, yStart + h }, "N1 R S1 Fail"));
-	indicators.emplace("N1_R_S2_Fail", Indicator({ xStart + 3 * xOffset, yStart, xStart + 3 * xOffset + w, yStart + h }, "N1 R S2 Fail"));
-
-	// 第 2 行: EGT 传感器故障 (左/右, 传感器1/2)
-	indicators.emplace("EGT_L_S1_Fail", Indicator({ xStart, yStart + yOffset, xStart + w, yStart + yOffset + h }, "EGT L S1 Fail"));
-	indicators.emplace("EGT_L_S2_Fail", Indicator({ xStart + xOffset, yStart + yOffset, xStart + xOffset + w, yStart + yOffset + h }, "EGT L S2 Fail"));
-	indicators.emplace("EGT_R_S1_Fail", Indicator({ xStart + 2 * xOffset, yStart + yOffset, xStart + 2 * xOffset + w, yStart + yOffset + h }, "EGT R S1 Fail"));
-	indicators.emplace("EGT_R_S2_Fail", Indicator({ xStart + 3 * xOffset, yStart + yOffset, xStart + 3 * xOffset + w, yStart + yOffset + h }, "EGT R S2 Fail"));
-
-	// 第 3 行: 系统级故障和超速
-	indicators.emplace("N1SFail", Indicator({ xStart, yStart + 2 * yOffset, xStart + w, yStart + 2 * yOffset + h }, "N1 Sys Fail"));
-	indicators.emplace("EGTSFail", Indicator({ xStart + xOffset, yStart + 2 * yOffset, xStart + xOffset + w, yStart + 2 * yOffset + h }, "EGT Sys Fail"));
-	indicators.emplace("OverSpd1", Indicator({ xStart + 2 * xOffset, yStart + 2 * yOffset, xStart + 2 * xOffset + w, yStart + 2 * yOffset + h }, "OverSpd L"));
-	indicators.emplace("OverSpd2", Indicator({ xStart + 3 * xOffset, yStart + 2 * yOffset, xStart + 3 * xOffset + w, yStart + 2 * yOffset + h }, "OverSpd R"));
-
-	// 第 4 行: 燃油系统状态
-	indicators.emplace("LowFuel", Indicator({ xStart, yStart + 3 * yOffset, xStart + w, yStart + 3 * yOffset + h }, "Low Fuel"));
-	indicators.emplace("OverFF", Indicator({ xStart + xOffset, yStart + 3 * yOffset, xStart + xOffset + w, yStart + 3 * yOffset + h }, "Over FF"));
-	indicators.emplace("FuelResFail", Indicator({ xStart + 2 * xOffset, yStart + 3 * yOffset, xStart + 2 * xOffset + w, yStart + 3 * yOffset + h }, "Fuel Res Fail"));
-	indicators.emplace("FuelFlowFail", Indicator({ xStart + 3 * xOffset, yStart + 3 * yOffset, xStart + 3 * xOffset + w, yStart + 3 * yOffset + h }, "Fuel Flow Fail"));
-
-	// 第 5 行: EGT 超温警告
-	indicators.emplace("OverTemp1", Indicator({ xStart, yStart + 4 * yOffset, xStart + w, yStart + 4 * yOffset + h }, "OverTemp1"));
-	indicators.emplace("OverTemp2", Indicator({ xStart + xOffset, yStart + 4 * yOffset, xStart + xOffset + w, yStart + 4 * yOffset + h }, "OverTemp2"));
-	indicators.emplace("OverTemp3", Indicator({ xStart + 2 * xOffset, yStart + 4 * yOffset, xStart + 2 * xOffset + w, yStart + 4 * yOffset + h }, "OverTemp3"));
-	indicators.emplace("OverTemp4", Indicator({ xStart + 3 * xOffset, yStart + 4 * yOffset, xStart + 3 * xOffset + w, yStart + 4 * yOffset + h }, "OverTemp4"));
+void initializeGauges(vector<Gauge>& gauges) {
+	gauges.clear();
+	gauges.emplace_back(RenderPoint{ 180, 120 }, 80, "N1_L", N1_MAX_RATED);
+	gauges.emplace_back(RenderPoint{ 390, 120 }, 80, "N1_R", N1_MAX_RATED);
+	gauges.emplace_back(RenderPoint{ 180, 300 }, 80, "EGT_L", EGT_MAX * 0.8);
+	gauges.emplace_back(RenderPoint{ 390, 300 }, 80, "EGT_R", EGT_MAX * 0.8);
+}
+
+void initializeIndicators(IndicatorArray& indicators) {
+	// 位置与文字见 indicators.h 中的 INDICATOR_LAYOUT（5x4 矩阵，Start/Run 在上方）
+	for (int i = 0; i < INDICATOR_COUNT; ++i) {
+		const IndicatorLayout& l = INDICATOR_LAYOUT[i];
+		indicators[i] = Indicator({ l.left, l.top, l.right, l.bottom }, l.label);
+	}
 }
 
-void initializeButtons(std::map<std::string, TriangleButton>& thrustButtons) {
-	thrustButtons.clear();
-	thrustButtons.emplace("ThrustUp", TriangleButton({ 760, 80, 790, 110 }, true)); // Up
-	thrustButtons.emplace("ThrustDown", TriangleButton({ 760, 120, 790, 150 }, false)); // Down
+void initializeButtons(ButtonArray& thrustButtons) {
+	for (int i = 0; i < BUTTON_COUNT; ++i) {
+		const ButtonLayout& l = BUTTON_LAYOUT[i];
+		thrustButtons[i] = TriangleButton({ l.left, l.top, l.right, l.bottom }, l.up);
+	}
 }
 
-void handleMouseClick(int x, int y, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr) {
+void handleMouseClick(int x, int y, void* simPtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr) {
 	if (x >= 820 && x <= 950 && y >= 50 && y <= 110) {
 		if (startFlagPtr) {
 			*(bool*)startFlagPtr = true;
@@ -334,46 +256,14 @@ void handleMouseClick(int x, int y, void* enginePtr, void* startFlagPtr, void* s
 		}
 	}
 	// 推力按钮
-	else if (thrustButtonsPtr && enginePtr) {
-		std::map<std::string, TriangleButton>* thrust_buttons = (std::map<std::string, TriangleButton>*)thrustButtonsPtr;
+	else if (thrustButtonsPtr && simPtr) {
+		ButtonArray* thrust_buttons = (ButtonArray*)thrustButtonsPtr;
 
-		// 确保 map 中有这些键
-		if (thrust_buttons->count("ThrustUp") && thrust_buttons->at("ThrustUp").isClicked(x, y)) {
-			((Engine*)enginePtr)->increaseThrust();
+		if ((*thrust_buttons)[BTN_THRUST_UP].isClicked(x, y)) {
+			((SimulationThread*)simPtr)->requestThrust(1);
 		}
-		else if (thrust_buttons->count("ThrustDown") && thrust_buttons->at("ThrustDown").isClicked(x, y)) {
-			((Engine*)enginePtr)->decreaseThrust();
+		else if ((*thrust_buttons)[BTN_THRUST_DOWN].isClicked(x, y)) {
+			((SimulationThread*)simPtr)->requestThrust(-1);
 		}
 	}
 }
-
-void fixConsoleWindow() {
-	HWND consoleWindow = GetConsoleWindow();
-	HWND graphicsWindow = GetHWnd();
-
-	if (consoleWindow != NULL && graphicsWindow != NULL) {
-		RECT graphicsRect;
-		GetWindowRect(graphicsWindow, &graphicsRect);
-		int graphicsWidth = graphicsRect.right - graphicsRect.left;
-		int graphicsHeight = graphicsRect.bottom - graphicsRect.top;
-
-		int consoleWidth = 500;
-		int consoleHeight = graphicsHeight;
-
-		// 将控制台窗口放置在图形窗口的右侧，并设置其大小
-		SetWindowPos(consoleWindow, NULL, graphicsRect.left + graphicsWidth, graphicsRect.top, consoleWidth, consoleHeight, SWP_NOZORDER);
-	}
-}
-
-void initializeUI(const string& windowName, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr) {
-	initgraph(WINDOW_WIDTH, WINDOW_HEIGHT, EW_SHOWCONSOLE); 
-
-	HWND graphicsWindow = GetHWnd();
-	if (graphicsWindow != NULL) {
-		SetWindowPos(graphicsWindow, NULL, 10, 10, 0, 0, SWP_NOSIZE | SWP_NOZORDER);
-	}
-	setbkcolor(BLACK);
-	fixConsoleWindow();
-	cleardevice();
-}
-
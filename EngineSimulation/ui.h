@@ -2,51 +2,61 @@
 #include <string>
 #include <cmath>
 #include <vector>
-#include <map>
+#include <array>
 #include <chrono>
 #include <deque>
-#include <graphics.h>
-#include <Windows.h>
+#include "alert.h"
+#include "indicators.h"
+#include "render.h"
 
 const int WINDOW_WIDTH = 1000;
 const int WINDOW_HEIGHT = 700;
 
-const COLORREF COLOR_WHITE = RGB(255, 255, 255);
-const COLORREF COLOR_BLACK = RGB(0, 0, 0);
-const COLORREF COLOR_RED = RGB(255, 0, 0);
-const COLORREF COLOR_AMBER = RGB(255, 165, 0); // ɫ
-const COLORREF COLOR_YELLOW = RGB(255, 255, 0);
-const COLORREF COLOR_GREEN = RGB(0, 255, 0);
-const COLORREF COLOR_BLUE = RGB(0, 0, 255);
-const COLORREF COLOR_LIGHT_GREY = RGB(180, 180, 180);
-const COLORREF COLOR_GREY = RGB(100, 100, 100);
+// Ǳһ֡ҪʾݣɶֵƻȽǷػ
+struct GaugeView {
+    bool valid = false;       // Ϊ NaN ʱΪ falseʾ "NaN"
+    COLORREF color = COLOR_LIGHT_GREY;
+    double fillAngle = 0.0;   // ʵεʼǣȣȡ 0.25 ȣ 1 ʱ
+    std::wstring text;        // ֶ
+};
 
 class Gauge {
 public:
-	Gauge(POINT center, int radius, const std::string& label, double max_value);
-	void draw(double value, double baseValue, double cautionStart, double warningStart) const;
+	Gauge(RenderPoint center, int radius, const std::string& label, double max_value);
+	GaugeView view(double value, double cautionStart, double warningStart) const;
+	void draw(Renderer& r, const GaugeView& view) const;
+	void draw(Renderer& r, double value, double cautionStart, double warningStart) const {
+		draw(r, view(value, cautionStart, warningStart));
+	}
+	RenderRect bounds(Renderer& r) const; // ̡ǩͶ 8 ַܻ
 private:
-    POINT center;
+    RenderPoint center;
     int radius;
     std::string label;
+    std::wstring wideLabel;
+    bool showPercent;   // N1 תٵİٷֱʾ
     double maxVal;
 	double valueToAngle(double value) const; // ָǶ
 };
 
 class Indicator {
 public:
-    Indicator(const RECT& position, const std::string& text);
-    void draw() const;
-    void update();
-    void setActive(const COLORREF newColor = COLOR_AMBER);
+    Indicator() : Indicator(RenderRect{ 0, 0, 0, 0 }, L"") {}
+    Indicator(const RenderRect& position, const std::wstring& text);
+    void draw(Renderer& r) const;
+    // now Ϊʱʱ䣨SimFrame::clockTime󱣳 2 
+    void update(double now);
+    void setActive(double now, const COLORREF newColor = COLOR_AMBER);
     void deactivate();
 
-    std::string getText() const {return label;}
-    RECT getPosition() const {return pos;}
+    const std::wstring& getText() const {return label;}
+    RenderRect getPosition() const {return pos;}
+    bool isLit() const { return isActive; }
+    COLORREF getColor() const { return color; }
 
 private:
-    RECT pos;
-    std::string label;
+    RenderRect pos;
+    std::wstring label; // ʱתãʱ֡ת
     bool isActive;
 	COLORREF color;
 	double lastActivatedTime;
@@ -54,45 +64,29 @@ private:
 
 class TriangleButton {
 public:
-	TriangleButton(const RECT& rect, bool direction); // trueϣfalse
-    void draw() const;
+	TriangleButton() : TriangleButton(RenderRect{ 0, 0, 0, 0 }, true) {}
+	TriangleButton(const RenderRect& rect, bool direction); // trueϣfalse
+    void draw(Renderer& r) const;
     bool isClicked(int x, int y) const;
     void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    RenderRect getRect() const { return rect; }
 
 private:
-    RECT rect;
+    RenderRect rect;
     bool direction; // true, false
     bool enabled;
 };
 
 
-struct Alert {
-    std::string message;
-    COLORREF color;
-    double timestamp; 
-};
-
-class AlertInfo {
-public:
-	AlertInfo() : currentAlert({ "", COLOR_BLACK, 0.0}) {}
-
-    void triggerAlert(const std::string& message, COLORREF color);
-    void update();
-	const Alert& getCurrentAlert() const { return currentAlert; } // const汾
-	Alert& getCurrentAlert() { return currentAlert; } // const汾
-	void drawHistory() const;
-    std::deque<Alert> getAndClearNewAlerts();
-
-private:
-    Alert currentAlert;
-    std::deque<Alert> alertHistory;
-    double getCurrentTime() const;
-    std::deque<Alert> newAlertsForLogging;
-}; 
-
+//  IndicatorId / ButtonId ±ţλú INDICATOR_LAYOUT / BUTTON_LAYOUT
+typedef std::array<Indicator, INDICATOR_COUNT> IndicatorArray;
+typedef std::array<TriangleButton, BUTTON_COUNT> ButtonArray;
 
-void initializeIndicators(std::map<std::string, Indicator>& indicators);
-void initializeButtons(std::map<std::string, TriangleButton>& thrustButtons);
-void handleMouseClick(int x, int y, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr);
-void initializeUI(const std::string& windowName, void* enginePtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr);
-void fixConsoleWindow();
\ No newline at end of file
+void initializeGauges(std::vector<Gauge>& gauges); // ˳Ϊ N1_L, N1_R, EGT_L, EGT_R
+void initializeIndicators(IndicatorArray& indicators);
+void initializeButtons(ButtonArray& thrustButtons);
+// ťͨ simPtrSimulationThreadת̣߳simPtr Ϊʱ
+void handleMouseClick(int x, int y, void* simPtr, void* startFlagPtr, void* stopFlagPtr, void* thrustButtonsPtr);
+void drawAlertHistory(Renderer& r, const Alert* alerts, size_t count); // µǰ
+const RenderRect ALERT_HISTORY_RECT = { WINDOW_WIDTH - 400, 200, WINDOW_WIDTH - 50, WINDOW_HEIGHT - 50 };
\ No newline at end of file
@@ -4,8 +4,86 @@
 #include <iomanip>
 using namespace std;
 
+// ĻϵķΧػǰɱɫ֮以ص
+static const RenderRect START_BUTTON_RECT = { 820, 50, 950, 110 };
+static const RenderRect STOP_BUTTON_RECT = { 820, 120, 950, 180 };
+static const RenderRect FUEL_FLOW_RECT = { 600, 50, 755, 100 };
+static const RenderRect FUEL_RESERVE_RECT = { 600, 120, 755, 170 };
+static const RenderRect STATUS_RECT = { 300, 425, 565, 485 };
+static const RenderRect TIME_WARP_RECT = { 20, 10, 300, 30 };
 
-void drawGauges(const vector<Gauge>& gauges, const Engine& engine) {
+// ݵժҪFNV-1aַֻܽṹֽӰ
+struct DrawKey {
+    uint64_t hash = 1469598103934665603ULL;
+
+    template <typename T>
+    DrawKey& add(const T& value) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+        return *this;
+    }
+    DrawKey& add(const wstring& text) {
+        for (wchar_t c : text) add(c);
+        return add(text.size());
+    }
+};
+
+bool UiDrawCache::update(UiRegion region, uint64_t key) {
+    bool changed = fullRedraw || keys[region] != key;
+    keys[region] = key;
+    if (changed) ++redrawnRegions;
+    return changed;
+}
+
+void updateIndicators(const EngineSnapshot& readings, double now, IndicatorArray& indicators, ButtonArray& thrustButtons) {
+    // ¸ָʾʱ״̬Start  Run ǰ棬ԶϨ
+    for (int i = IND_RUN + 1; i < INDICATOR_COUNT; ++i) {
+        indicators[i].update(now);
+    }
+
+    // ȡ״̬
+    EngineState state = readings.state;
+
+    //  Start  Run ָʾ
+    if (state == EngineState::STARTING) {
+        indicators[IND_START].setActive(now, COLOR_GREEN);
+        indicators[IND_RUN].deactivate();
+    }
+    else if (state == EngineState::STABLE) {
+        indicators[IND_START].deactivate();
+        // N1 ȶֵ95%Ϩ
+        if (readings.n1[0] < N1_STABLE_THRESHOLD * 0.95 || readings.n1[1] < N1_STABLE_THRESHOLD * 0.95) {
+            indicators[IND_RUN].deactivate();
+        }
+        else {
+            indicators[IND_RUN].setActive(now, COLOR_GREEN);
+        }
+    }
+    else { // OFF  STOPPING ״̬
+        indicators[IND_START].deactivate();
+        indicators[IND_RUN].deactivate();
+    }
+
+    bool stable = (state == EngineState::STABLE);
+    thrustButtons[BTN_THRUST_UP].setEnabled(stable);
+    thrustButtons[BTN_THRUST_DOWN].setEnabled(stable);
+}
+
+void applyLamps(const IndicatorLamps& lamps, IndicatorLamps& seen, double now, IndicatorArray& indicators) {
+    for (int i = 0; i < INDICATOR_COUNT; ++i) {
+        for (int level = 0; level < LAMP_LEVELS; ++level) {
+            if (lamps.lit[i][level] != seen.lit[i][level]) {
+                indicators[i].setActive(now, IndicatorLamps::levelColor(level));
+            }
+        }
+    }
+    seen = lamps;
+}
+
+void drawGauges(Renderer& r, UiDrawCache& cache, const vector<Gauge>& gauges, const EngineSnapshot& readings) {
     // gauges ˳Ϊ N1_L, N1_R, EGT_L, EGT_R
     if (gauges.size() >= 4) {
         // ֵԭʼֵǰٷֱȣ
@@ -14,171 +92,198 @@ void drawGauges(const vector<Gauge>& gauges, const Engine& engine) {
         double egt_caution = 950.0;
         double egt_warning = 1100.0;
 
-        double n1_base = 0.0;
-        double egt_base = AMBIENT_TEMP;
-
-        // N1
-        gauges[0].draw(engine.getN1Left(), n1_base, n1_caution, n1_warning);
-        gauges[1].draw(engine.getN1Right(), n1_base, n1_caution, n1_warning);
-
-        // EGTʹû¶Ϊ
-        gauges[2].draw(engine.getEgtLeft(), egt_base, egt_caution, egt_warning);
-        gauges[3].draw(engine.getEgtRight(), egt_base, egt_caution, egt_warning);
+        GaugeView views[4] = {
+            gauges[0].view(readings.n1[0], n1_caution, n1_warning),
+            gauges[1].view(readings.n1[1], n1_caution, n1_warning),
+            gauges[2].view(readings.egt[0], egt_caution, egt_warning),
+            gauges[3].view(readings.egt[1], egt_caution, egt_warning),
+        };
+        for (int i = 0; i < 4; ++i) {
+            // νǶ Gauge::view ȡ 0.25 ȣֱӱȽ
+            const GaugeView& v = views[i];
+            DrawKey key;
+            key.add(v.valid).add(v.color).add(v.fillAngle).add(v.text);
+            if (!cache.update(static_cast<UiRegion>(REGION_GAUGES + i), key.hash)) continue;
+            r.clearRect(gauges[i].bounds(r));
+            gauges[i].draw(r, v);
+        }
     }
 }
 
-void drawButtons(const Engine& engine, const map<string, TriangleButton>& thrust_buttons) {
-    RECT start_rect = { 820, 50, 950, 110 };
-    COLORREF start_color = (engine.getState() == EngineState::OFF) ? COLOR_GREEN : COLOR_GREY;
-    setfillcolor(start_color);
-    solidrectangle(start_rect.left, start_rect.top, start_rect.right, start_rect.bottom);
+static void drawTextButton(Renderer& r, const RenderRect& rect, COLORREF color, int textOffsetX, const wchar_t* text) {
+    r.setFillColor(color);
+    r.solidRectangle(rect.left, rect.top, rect.right, rect.bottom);
 
-    settextcolor(COLOR_WHITE);
-    settextstyle(22, 0, L"Arial");
-    setbkmode(TRANSPARENT);
-    outtextxy(start_rect.left + 35, start_rect.top + 20, L"START");
+    r.setTextColor(COLOR_WHITE);
+    r.setTextStyle(22, L"Arial");
+    r.outText(rect.left + textOffsetX, rect.top + 20, text);
+}
 
-    RECT stop_rect = { 820, 120, 950, 180 };
-    COLORREF stop_color = (engine.getState() == EngineState::STABLE || engine.getState() == EngineState::STARTING) ? COLOR_RED : COLOR_GREY;
-    setfillcolor(stop_color);
-    solidrectangle(stop_rect.left, stop_rect.top, stop_rect.right, stop_rect.bottom);
+void drawButtons(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings, const ButtonArray& thrust_buttons) {
+    COLORREF start_color = (readings.state == EngineState::OFF) ? COLOR_GREEN : COLOR_GREY;
+    if (cache.update(REGION_START_BUTTON, DrawKey().add(start_color).hash)) {
+        drawTextButton(r, START_BUTTON_RECT, start_color, 35, L"START");
+    }
 
-    settextcolor(COLOR_WHITE);
-    settextstyle(22, 0, L"Arial");
-    setbkmode(TRANSPARENT);
-    outtextxy(stop_rect.left + 37, stop_rect.top + 20, L"STOP");
+    COLORREF stop_color = (readings.state == EngineState::STABLE || readings.state == EngineState::STARTING) ? COLOR_RED : COLOR_GREY;
+    if (cache.update(REGION_STOP_BUTTON, DrawKey().add(stop_color).hash)) {
+        drawTextButton(r, STOP_BUTTON_RECT, stop_color, 37, L"STOP");
+    }
 
     // ť
-    if (thrust_buttons.count("ThrustUp") && thrust_buttons.count("ThrustDown")) {
-        thrust_buttons.at("ThrustUp").draw();
-        thrust_buttons.at("ThrustDown").draw();
+    for (int i = 0; i < BUTTON_COUNT; ++i) {
+        if (!cache.update(static_cast<UiRegion>(REGION_THRUST_BUTTONS + i), DrawKey().add(thrust_buttons[i].isEnabled()).hash)) continue;
+        r.clearRect(thrust_buttons[i].getRect());
+        thrust_buttons[i].draw(r);
     }
 }
 
-void drawFuelInfo(const Engine& engine) {
-    settextcolor(COLOR_WHITE);
-    settextstyle(18, 0, L"Arial");
-    setbkmode(TRANSPARENT);
-    outtextxy(600, 50, L"Fuel Flow:");
-
-    RECT ff_rect = { 600, 70, 730, 100 };
-    setlinecolor(COLOR_WHITE);
-    rectangle(ff_rect.left, ff_rect.top, ff_rect.right, ff_rect.bottom);
-
-    double fuelFlow = engine.getFuelFlow();
-    if (std::isnan(fuelFlow)) {
-        // ֵЧʱúɫʾ "--"
-        settextcolor(COLOR_RED);
-        settextstyle(18, 0, L"Arial");
-        setbkmode(TRANSPARENT);
-        outtextxy(ff_rect.left + 10, ff_rect.top + 5, L"--");
-    }
-    else {
-        settextcolor(COLOR_WHITE);
-        stringstream ff_ss;
+void drawFuelInfo(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings) {
+    double fuelFlow = readings.fuelFlow;
+    wstring ff_wstr = L"--";
+    COLORREF ff_color = COLOR_RED; // ֵЧʱúɫʾ "--"
+    if (!std::isnan(fuelFlow)) {
+        wostringstream ff_ss;
         ff_ss << fixed << setprecision(1) << fuelFlow;
-        string ff_str = ff_ss.str();
-        wstring ff_wstr(ff_str.begin(), ff_str.end());
-
-		if (fuelFlow > 50) settextcolor(COLOR_AMBER);
-        settextstyle(18, 0, L"Arial");
-        setbkmode(TRANSPARENT);
-        outtextxy(ff_rect.left + 10, ff_rect.top + 5, ff_wstr.c_str());
+        ff_wstr = ff_ss.str();
+        ff_color = (fuelFlow > 50) ? COLOR_AMBER : COLOR_WHITE;
     }
+    if (cache.update(REGION_FUEL_FLOW, DrawKey().add(ff_color).add(ff_wstr).hash)) {
+        r.clearRect(FUEL_FLOW_RECT);
+        r.setTextColor(COLOR_WHITE);
+        r.setTextStyle(18, L"Arial");
+        r.outText(600, 50, L"Fuel Flow:");
 
-	settextcolor(COLOR_WHITE);
-    outtextxy(600, 120, L"Fuel Reserve:");
-
-    RECT fuel_bar_rect = { 600, 140, 730, 170 };
-    setlinecolor(COLOR_WHITE);
-    rectangle(fuel_bar_rect.left, fuel_bar_rect.top, fuel_bar_rect.right, fuel_bar_rect.bottom);
+        RenderRect ff_rect = { 600, 70, 730, 100 };
+        r.setLineColor(COLOR_WHITE);
+        r.rectangle(ff_rect.left, ff_rect.top, ff_rect.right, ff_rect.bottom);
 
-    double fuel_reserve = engine.getFuelReserve();
+        r.setTextColor(ff_color);
+        r.outText(ff_rect.left + 10, ff_rect.top + 5, ff_wstr.c_str());
+    }
 
+    RenderRect fuel_bar_rect = { 600, 140, 730, 170 };
+    double fuel_reserve = readings.fuelReserve;
+    wstring fr_wstr = L"--";
+    COLORREF fuel_color = COLOR_WHITE; // ֵɫ
+    COLORREF text_color = COLOR_RED;   // Чֵ (--) ɫ
+    int fill_width = -1;
     if (!isnan(fuel_reserve)) {
         double fuel_percentage = fuel_reserve / FUEL_CAPACITY;
-        settextcolor(COLOR_GREY);
+        text_color = COLOR_GREY;
         if (fuel_percentage < 0.0) fuel_percentage = 0.0;
         if (fuel_percentage > 1.0) fuel_percentage = 1.0;
-        COLORREF fuel_color = COLOR_WHITE; // ֵɫ
         if (fuel_reserve < 1000.0 && fuel_reserve > 0.0) {
-            fuel_color = COLOR_AMBER; // ֵɫ
-			settextcolor(COLOR_AMBER);
+            fuel_color = text_color = COLOR_AMBER; // ֵɫ
         }
         else if (fuel_reserve <= 0.0) {
-            fuel_color = COLOR_RED; // ֵɫ
-			settextcolor(COLOR_RED);
+            fuel_color = text_color = COLOR_RED; // ֵɫ
         }
-
-        // 
-        setfillcolor(fuel_color);
         int bar_width = fuel_bar_rect.right - fuel_bar_rect.left;
-        solidrectangle(fuel_bar_rect.left, fuel_bar_rect.top, fuel_bar_rect.left + static_cast<int>(bar_width * fuel_percentage), fuel_bar_rect.bottom);
+        fill_width = static_cast<int>(bar_width * fuel_percentage);
 
-        // ֵ
-        stringstream fr_ss;
+        wostringstream fr_ss;
         fr_ss << fixed << setprecision(0) << fuel_reserve;
-        string fr_str = fr_ss.str();
-        wstring fr_wstr(fr_str.begin(), fr_str.end());
-
-        settextstyle(18, 0, L"Arial");
-        outtextxy(fuel_bar_rect.left + 10, fuel_bar_rect.top + 5, fr_wstr.c_str());
+        fr_wstr = fr_ss.str();
     }
-    else {
-        // Чֵ (--) ɫ
-        settextcolor(COLOR_RED);
-        settextstyle(18, 0, L"Arial");
-        outtextxy(fuel_bar_rect.left + 10, fuel_bar_rect.top + 5, L"--");
+    if (cache.update(REGION_FUEL_RESERVE, DrawKey().add(fill_width).add(fuel_color).add(text_color).add(fr_wstr).hash)) {
+        r.clearRect(FUEL_RESERVE_RECT);
+        r.setTextColor(COLOR_WHITE);
+        r.setTextStyle(18, L"Arial");
+        r.outText(600, 120, L"Fuel Reserve:");
+
+        r.setLineColor(COLOR_WHITE);
+        r.rectangle(fuel_bar_rect.left, fuel_bar_rect.top, fuel_bar_rect.right, fuel_bar_rect.bottom);
+
+        // 
+        if (fill_width >= 0) {
+            r.setFillColor(fuel_color);
+            r.solidRectangle(fuel_bar_rect.left, fuel_bar_rect.top, fuel_bar_rect.left + fill_width, fuel_bar_rect.bottom);
+        }
+
+        // ֵ
+        r.setTextColor(text_color);
+        r.outText(fuel_bar_rect.left + 10, fuel_bar_rect.top + 5, fr_wstr.c_str());
     }
 }
 
-void drawAllIndicators(const map<string, Indicator>& indicators) {
-    for (const auto& pair : indicators) {
-        pair.second.draw();
+void drawAllIndicators(Renderer& r, UiDrawCache& cache, const IndicatorArray& indicators) {
+    for (int i = 0; i < INDICATOR_COUNT; ++i) {
+        const Indicator& indicator = indicators[i];
+        if (!cache.update(static_cast<UiRegion>(REGION_INDICATORS + i), DrawKey().add(indicator.isLit()).add(indicator.getColor()).hash)) continue;
+        indicator.draw(r); // ߿串򣬲
     }
 }
 
-void drawStatusMessage(const Engine& engine) {
-    string status_message;
-    switch (engine.getState()) {
-    case EngineState::OFF: status_message = "OFFLINE"; break;
-    case EngineState::STARTING: status_message = "STARTING"; break;
-    case EngineState::STABLE: status_message = "STABLE RUN"; break;
-    case EngineState::STOPPING: status_message = "SHUTDOWN"; break;
+void drawStatusMessage(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings) {
+    if (!cache.update(REGION_STATUS, DrawKey().add(readings.state).hash)) return;
+
+    const wchar_t* status_message = L"";
+    switch (readings.state) {
+    case EngineState::OFF: status_message = L"OFFLINE"; break;
+    case EngineState::STARTING: status_message = L"STARTING"; break;
+    case EngineState::STABLE: status_message = L"STABLE RUN"; break;
+    case EngineState::STOPPING: status_message = L"SHUTDOWN"; break;
     }
 
     // ָʾƶķ
-    RECT status_box = { 300, 425, 565, 485 };
-    setlinecolor(COLOR_WHITE);
-    rectangle(status_box.left, status_box.top, status_box.right, status_box.bottom);
+    const RenderRect& status_box = STATUS_RECT;
+    r.clearRect(status_box);
+    r.setLineColor(COLOR_WHITE);
+    r.rectangle(status_box.left, status_box.top, status_box.right, status_box.bottom);
 
-    settextcolor(COLOR_WHITE);
-    settextstyle(30, 0, L"Consolas");
-    setbkmode(TRANSPARENT);
-    string full_message = "STATUS: " + status_message;
-    wstring full_message_wstr(full_message.begin(), full_message.end());
+    r.setTextColor(COLOR_WHITE);
+    r.setTextStyle(30, L"Consolas");
+    wstring full_message_wstr = wstring(L"STATUS: ") + status_message;
 
     // ıλ
-    int text_width = textwidth(full_message_wstr.c_str());
-    int text_height = textheight(full_message_wstr.c_str());
+    int text_width = r.textWidth(full_message_wstr.c_str());
+    int text_height = r.textHeight(full_message_wstr.c_str());
     int x_pos = status_box.left + (status_box.right - status_box.left - text_width) / 2;
     int y_pos = status_box.top + (status_box.bottom - status_box.top - text_height) / 2;
 
-    outtextxy(x_pos, y_pos, full_message_wstr.c_str());
+    r.outText(x_pos, y_pos, full_message_wstr.c_str());
 }
 
-void drawUI(const vector<Gauge>& gauges, const map<string, Indicator>& indicators, const map<string, TriangleButton>& thrust_buttons, const Engine& engine, const AlertInfo& alertInfo) {
-    // 
-    cleardevice();
+void drawAlerts(Renderer& r, UiDrawCache& cache, const SimFrame& frame) {
+    DrawKey key;
+    key.add(frame.alertCount);
+    for (size_t i = 0; i < frame.alertCount; ++i) key.add(frame.alerts[i].id).add(frame.alerts[i].color);
+    if (!cache.update(REGION_ALERTS, key.hash)) return;
+    r.clearRect(ALERT_HISTORY_RECT);
+    drawAlertHistory(r, frame.alerts, frame.alertCount);
+}
+
+void drawTimeWarp(Renderer& r, UiDrawCache& cache, const SimFrame& frame) {
+    wostringstream wss;
+    if (frame.paused) wss << L"PAUSED";
+    else wss << L"x" << static_cast<int>(frame.timeScale);
+    wss << L"  t=" << fixed << setprecision(1) << frame.clockTime << L" s";
+    wstring text = wss.str();
+    if (!cache.update(REGION_TIME_WARP, DrawKey().add(frame.paused).add(text).hash)) return;
+
+    r.clearRect(TIME_WARP_RECT);
+    r.setTextColor(frame.paused ? COLOR_AMBER : COLOR_LIGHT_GREY);
+    r.setTextStyle(16, L"Consolas");
+    r.outText(TIME_WARP_RECT.left, TIME_WARP_RECT.top, text.c_str());
+}
+
+void drawUI(Renderer& r, UiDrawCache& cache, const vector<Gauge>& gauges, const IndicatorArray& indicators,
+    const ButtonArray& thrust_buttons, const SimFrame& frame) {
+    const EngineSnapshot& readings = frame.readings;
+
+    // ֻڵһ֡ʧЧ֮ԼԼ
+    if (cache.needsFullRedraw()) r.clear();
 
-    // Ԫ
-    drawGauges(gauges, engine);
-    drawButtons(engine, thrust_buttons);
-    drawFuelInfo(engine);
-    drawAllIndicators(indicators);
-    drawStatusMessage(engine);
-    alertInfo.drawHistory();
+    drawGauges(r, cache, gauges, readings);
+    drawButtons(r, cache, readings, thrust_buttons);
+    drawFuelInfo(r, cache, readings);
+    drawAllIndicators(r, cache, indicators);
+    drawStatusMessage(r, cache, readings);
+    drawAlerts(r, cache, frame);
+    drawTimeWarp(r, cache, frame);
+    cache.finishFrame();
 
-    // ˢĻ
-    FlushBatchDraw();
+    // ѻ͵Ļ
+    r.present();
 }
@@ -1,15 +1,57 @@
 #pragma once
-#include <graphics.h>
 #include <vector>
-#include <map>
 #include <string>
+#include <array>
+#include <cstdint>
 #include "engine.h"
 #include "ui.h"
+#include "render.h"
+#include "monitor.h"
+#include "sim_thread.h"
 
-// UI ƺ
-void drawUI(const std::vector<Gauge>& gauges, const std::map<std::string, Indicator>& indicators, const std::map<std::string, TriangleButton>& thrust_buttons, const Engine& engine, const AlertInfo& alertInfo);
-void drawGauges(const std::vector<Gauge>& gauges, const Engine& engine);
-void drawButtons(const Engine& engine, const std::map<std::string, TriangleButton>& thrust_buttons);
-void drawFuelInfo(const Engine& engine);
-void drawAllIndicators(const std::map<std::string, Indicator>& indicators);
-void drawStatusMessage(const Engine& engine);
+// 水ػÿһ֡ݵժҪժҪʱػ
+enum UiRegion : int {
+    REGION_GAUGES = 0,                                  // 4 Ǳ˳ͬ gauges
+    REGION_START_BUTTON = REGION_GAUGES + 4,
+    REGION_STOP_BUTTON,
+    REGION_THRUST_BUTTONS,                              //  ButtonId
+    REGION_FUEL_FLOW = REGION_THRUST_BUTTONS + BUTTON_COUNT,
+    REGION_FUEL_RESERVE,
+    REGION_STATUS,
+    REGION_ALERTS,
+    REGION_TIME_WARP,
+    REGION_INDICATORS,                                  //  IndicatorId
+    REGION_COUNT = REGION_INDICATORS + INDICATOR_COUNT
+};
+
+class UiDrawCache {
+public:
+    void invalidate() { fullRedraw = true; } // һ֡ػȫ򣨴ڳʼл˺ã
+    bool needsFullRedraw() const { return fullRedraw; }
+    void finishFrame() { fullRedraw = false; }
+    // ¼ժҪһ֡ͬҪȫػʱ true
+    bool update(UiRegion region, uint64_t key);
+    uint64_t getRedrawnRegions() const { return redrawnRegions; }
+
+private:
+    std::array<uint64_t, REGION_COUNT> keys = {};
+    bool fullRedraw = true;
+    uint64_t redrawnRegions = 0;
+};
+
+// ÿָ֡ʾʱ״̬Start/Run ָʾƺť澯ָʾ applyLamps 
+// now Ϊеʱʱ䣬ʱٻͣʱָʾƱʱű
+void updateIndicators(const EngineSnapshot& readings, double now, IndicatorArray& indicators, ButtonArray& thrustButtons);
+// еĵ澯ָʾƣһ֡ɫһ setActiveȼǰ
+void applyLamps(const IndicatorLamps& lamps, IndicatorLamps& seen, double now, IndicatorArray& indicators);
+
+// UI ƺֻػݱ仯 present
+void drawUI(Renderer& r, UiDrawCache& cache, const std::vector<Gauge>& gauges, const IndicatorArray& indicators,
+    const ButtonArray& thrust_buttons, const SimFrame& frame);
+void drawGauges(Renderer& r, UiDrawCache& cache, const std::vector<Gauge>& gauges, const EngineSnapshot& readings);
+void drawButtons(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings, const ButtonArray& thrust_buttons);
+void drawFuelInfo(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings);
+void drawAllIndicators(Renderer& r, UiDrawCache& cache, const IndicatorArray& indicators);
+void drawStatusMessage(Renderer& r, UiDrawCache& cache, const EngineSnapshot& readings);
+void drawAlerts(Renderer& r, UiDrawCache& cache, const SimFrame& frame);
+void drawTimeWarp(Renderer& r, UiDrawCache& cache, const SimFrame& frame); // Ͻʾʱ䱶ͣ״̬ʱ
@@ -0,0 +1,119 @@
+﻿#include "vote.h"
+#include <limits>
+using namespace std;
+
+// x64 上 SSE2 总是可用；其他平台只走逐通道的版本
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VOTE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const double INF = numeric_limits<double>::infinity();
+
+// 算法：无效读数换成 +inf 后用比较交换网络升序排列，有效读数排在前 count 个位置，位置 i 有效即 sorted[i] < inf
+// 中间两个的位置 lo = (count-1)/2、hi = count/2 和最大值的位置 count-1 都可以由相邻位置是否有效判定：
+//   i == lo 当且仅当 2i 有效且 2i+2 无效；i == hi 当且仅当 2i-1 有效（i=0 时恒成立）且 2i+1 无效；i == count-1 当且仅当 i 有效且 i+1 无效
+// 超出 Sensors 的位置恒为无效，这些条件在编译期就折叠掉；全部有效时（绝大多数步）位置都是常数，直接取
+template <int Sensors>
+static void sortLane(double (&v)[Sensors]) {
+	for (int i = 0; i < Sensors; ++i) {
+		for (int k = Sensors - 1; k > i; --k) {
+			double a = v[k - 1], b = v[k];
+			v[k - 1] = (b < a) ? b : a;
+			v[k] = (b < a) ? a : b;
+		}
+	}
+}
+
+// 单个通道，用于没有 SSE2 的平台和批量的尾部
+template <int Sensors>
+static void voteLane(const double* const rows[], size_t j, double* voted, uint8_t* disagree) {
+	double v[Sensors];
+	for (int s = 0; s < Sensors; ++s) {
+		double x = rows[s][j];
+		v[s] = (x == x) ? x : INF; // NaN 自身不相等
+	}
+	sortLane(v);
+	double lo = v[(Sensors - 1) / 2], hi = v[Sensors / 2], largest = v[Sensors - 1];
+	if (!(largest < INF)) {
+		auto valid = [&](int i) { return i < 0 || (i < Sensors && v[i] < INF); };
+		if (!valid(0)) {
+			voted[j] = numeric_limits<double>::quiet_NaN();
+			disagree[j] = 0;
+			return;
+		}
+		for (int i = 0; i < Sensors; ++i) {
+			lo = (valid(2 * i) && !valid(2 * i + 2)) ? v[i] : lo;
+			hi = (valid(2 * i - 1) && !valid(2 * i + 1)) ? v[i] : hi;
+			largest = (valid(i) && !valid(i + 1)) ? v[i] : largest;
+		}
+	}
+	double vote = (lo + hi) * 0.5;
+	double limit = VOTE_TOLERANCE * (vote < 0.0 ? -vote : vote) + VOTE_TOLERANCE_FLOOR;
+	voted[j] = vote;
+	disagree[j] = largest - v[0] > limit; // 只有一个有效读数时极差为 0
+}
+
+template <int Sensors>
+void voteMidValue(const double* const value[], size_t lanes, double* voted, uint8_t* disagree) {
+	static_assert(Sensors >= 1 && Sensors <= MAX_VOTE_SENSORS, "unsupported redundancy");
+	const double* rows[Sensors];
+	for (int s = 0; s < Sensors; ++s) rows[s] = value[s];
+	size_t j = 0;
+
+#ifdef VOTE_SSE2
+	// 两个通道一组，与逐通道版本相同的算法，有无效读数时条件换成比较掩码的与或
+	const __m128d inf = _mm_set1_pd(INF), half = _mm_set1_pd(0.5);
+	const __m128d nan = _mm_set1_pd(numeric_limits<double>::quiet_NaN());
+	const __m128d signBit = _mm_set1_pd(-0.0);
+	const __m128d tolerance = _mm_set1_pd(VOTE_TOLERANCE), floorValue = _mm_set1_pd(VOTE_TOLERANCE_FLOOR);
+	const __m128d allSet = _mm_castsi128_pd(_mm_set1_epi32(-1)), noneSet = _mm_setzero_pd();
+	for (; j + 2 <= lanes; j += 2) {
+		__m128d v[Sensors];
+		__m128d allValid = allSet;
+		for (int s = 0; s < Sensors; ++s) {
+			// 列通常是调用方刚逐个写入的，分两次 8 字节读取；一次 16 字节读取跨两次写入时存储转发失败，要等写入完成
+			__m128d x = _mm_loadh_pd(_mm_load_sd(rows[s] + j), rows[s] + j + 1);
+			__m128d ok = _mm_cmpeq_pd(x, x);
+			v[s] = _mm_or_pd(_mm_and_pd(ok, x), _mm_andnot_pd(ok, inf));
+			allValid = _mm_and_pd(allValid, ok);
+		}
+		for (int i = 0; i < Sensors; ++i) {
+			for (int k = Sensors - 1; k > i; --k) {
+				__m128d a = v[k - 1];
+				v[k - 1] = _mm_min_pd(a, v[k]);
+				v[k] = _mm_max_pd(a, v[k]);
+			}
+		}
+		__m128d lo = v[(Sensors - 1) / 2], hi = v[Sensors / 2], largest = v[Sensors - 1];
+		__m128d any = allSet;
+		if (_mm_movemask_pd(allValid) != 3) {
+			__m128d valid[Sensors];
+			for (int i = 0; i < Sensors; ++i) valid[i] = _mm_cmplt_pd(v[i], inf);
+			auto validAt = [&](int i) { return i < 0 ? allSet : (i < Sensors ? valid[i] : noneSet); };
+			lo = hi = largest = _mm_setzero_pd();
+			for (int i = 0; i < Sensors; ++i) {
+				// 各位置的条件互斥，或起来就是选中的那一个
+				lo = _mm_or_pd(lo, _mm_and_pd(_mm_andnot_pd(validAt(2 * i + 2), validAt(2 * i)), v[i]));
+				hi = _mm_or_pd(hi, _mm_and_pd(_mm_andnot_pd(validAt(2 * i + 1), validAt(2 * i - 1)), v[i]));
+				largest = _mm_or_pd(largest, _mm_and_pd(_mm_andnot_pd(validAt(i + 1), validAt(i)), v[i]));
+			}
+			any = valid[0];
+		}
+		__m128d vote = _mm_mul_pd(_mm_add_pd(lo, hi), half);
+		_mm_storeu_pd(voted + j, _mm_or_pd(_mm_and_pd(any, vote), _mm_andnot_pd(any, nan)));
+
+		// 只有一个有效读数时极差为 0，没有有效读数时 largest 为 0、v[0] 为 +inf，都不会判为不一致
+		__m128d limit = _mm_add_pd(_mm_mul_pd(tolerance, _mm_andnot_pd(signBit, vote)), floorValue);
+		int mask = _mm_movemask_pd(_mm_cmpgt_pd(_mm_sub_pd(largest, v[0]), limit));
+		disagree[j] = static_cast<uint8_t>(mask & 1);
+		disagree[j + 1] = static_cast<uint8_t>(mask >> 1);
+	}
+#endif
+
+	for (; j < lanes; ++j) voteLane<Sensors>(rows, j, voted, disagree);
+}
+
+#define INSTANTIATE_VOTE(S) template void voteMidValue<S>(const double* const[], size_t, double*, uint8_t*);
+INSTANTIATE_VOTE(1) INSTANTIATE_VOTE(2) INSTANTIATE_VOTE(3) INSTANTIATE_VOTE(4)
+INSTANTIATE_VOTE(5) INSTANTIATE_VOTE(6) INSTANTIATE_VOTE(7) INSTANTIATE_VOTE(8)
@@ -0,0 +1,16 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 冗余传感器表决：取有效传感器的中值（偶数个时取中间两个的平均），没有有效传感器时为 NaN
+// 两个传感器时中值就是平均值，与原来的“取平均、只剩一个时取它”结果逐位相同；三余度时一个传感器漂移不会带偏显示值
+// 有效传感器的极差超过 VOTE_TOLERANCE * |表决值| + VOTE_TOLERANCE_FLOOR 时判为不一致，N1 和 EGT 共用同一相对容差
+const double VOTE_TOLERANCE = 0.05;
+const double VOTE_TOLERANCE_FLOOR = 1.0;
+const int MAX_VOTE_SENSORS = 8;
+
+// 按列批量表决：value[s] 为第 s 个传感器的列，每列 lanes 个通道（各引擎的 N1、EGT 可以排在同一批里）
+// 异常传感器由调用方记为 NaN（快照和日志中本来就是这样），NaN 不参与表决
+// 结果写入 voted[lane]，不一致标志写入 disagree[lane]；实现在 vote.cpp，Sensors 为 1..MAX_VOTE_SENSORS 都已实例化
+template <int Sensors>
+void voteMidValue(const double* const value[], size_t lanes, double* voted, uint8_t* disagree);
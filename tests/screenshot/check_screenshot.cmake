@@ -0,0 +1,23 @@
+# 截图回归：用固定种子和剧本无界面运行一次，比较最终帧 PNG 的 SHA-256 与 reference.sha256
+# 由 ctest 调用：cmake -DHEADLESS=<EngineHeadless> -DSOURCE_DIR=<本目录> -DOUTPUT_DIR=<输出目录> -P check_screenshot.cmake
+# 界面或仿真改动导致截图变化时，确认新截图无误后把失败信息中的实际哈希写回 reference.sha256
+set(SCREENSHOT ${OUTPUT_DIR}/screenshot.png)
+file(REMOVE ${SCREENSHOT})
+execute_process(
+  COMMAND ${HEADLESS} --seed 7 --duration 30 --output none
+          --scenario ${SOURCE_DIR}/scenario.txt --screenshot ${SCREENSHOT}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "EngineHeadless exited with ${result}")
+endif()
+if(NOT EXISTS ${SCREENSHOT})
+  message(FATAL_ERROR "EngineHeadless did not write ${SCREENSHOT}")
+endif()
+
+file(SHA256 ${SCREENSHOT} actual)
+file(STRINGS ${SOURCE_DIR}/reference.sha256 expected REGEX "^[0-9a-f]+$" LIMIT_COUNT 1)
+if(NOT actual STREQUAL expected)
+  message(FATAL_ERROR "Screenshot ${SCREENSHOT} differs from the reference\n"
+    "  expected ${expected}\n  actual   ${actual}")
+endif()
+message(STATUS "Screenshot matches reference ${expected}")